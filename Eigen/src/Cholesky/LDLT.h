@@ -43,6 +43,9 @@
   * Note that during the decomposition, only the upper triangular part of A is considered. Therefore,
   * the strict lower part does not have to store correct values.
   *
+  * An existing decomposition can be updated in O(n^2) when A receives a low rank modification,
+  * see rankUpdate().
+  *
   * \sa MatrixBase::ldlt(), class LLT
   */
 template<typename MatrixType> class LDLT
@@ -76,12 +79,15 @@ template<typename MatrixType> class LDLT
 
     void compute(const MatrixType& matrix);
 
+    template<typename Derived>
+    bool rankUpdate(const MatrixBase<Derived>& w, RealScalar sigma = 1);
+
   protected:
     /** \internal
       * Used to compute and store the cholesky decomposition A = L D L^* = U^* D U.
-      * The strict upper part is used during the decomposition, the strict lower
-      * part correspond to the coefficients of L (its diagonal is equal to 1 and
-      * is not stored), and the diagonal entries correspond to D.
+      * The strict lower part correspond to the coefficients of L (its diagonal is
+      * equal to 1 and is not stored), and the diagonal entries correspond to D.
+      * The strict upper part is not used.
       */
     MatrixType m_matrix;
 
@@ -89,6 +95,10 @@ template<typename MatrixType> class LDLT
 };
 
 /** Compute / recompute the LLT decomposition A = L D L^* = U^* D U of \a matrix
+  *
+  * Large matrices are factorized per panel of EIGEN_DECOMPOSITION_BLOCK_SIZE columns: each panel is
+  * factorized by the unblocked algorithm, and the trailing matrix is then updated by a cache friendly
+  * rank-k product.
   */
 template<typename MatrixType>
 void LDLT<MatrixType>::compute(const MatrixType& a)
@@ -105,40 +115,110 @@ void LDLT<MatrixType>::compute(const MatrixType& a)
     return;
   }
 
-  // Let's preallocate a temporay vector to evaluate the matrix-vector product into it.
-  // Unlike the standard LLT decomposition, here we cannot evaluate it to the destination
-  // matrix because it a sub-row which is not compatible suitable for efficient packet evaluation.
-  // (at least if we assume the matrix is col-major)
-  Matrix<Scalar,MatrixType::RowsAtCompileTime,1> _temporary(size);
+  // the decomposition is performed in place on the lower triangular part,
+  // which is the adjoint of the upper triangular part of a
+  m_matrix = a.adjoint();
+
+  const int blockSize = size >= 2*EIGEN_DECOMPOSITION_BLOCK_SIZE ? EIGEN_DECOMPOSITION_BLOCK_SIZE : size;
 
-  // Note that, in this algorithm the rows of the strict upper part of m_matrix is used to store
-  // column vector, thus the strange .conjugate() and .transpose()...
+  // Let's preallocate a temporay vector to evaluate D times a row of L into it,
+  // and a temporary matrix for the product of the panels of L by D.
+  Matrix<Scalar,MatrixType::RowsAtCompileTime,1> _temporary(size);
+  Matrix<Scalar,Dynamic,Dynamic> ld;
+  if (blockSize<size)
+    ld.resize(size-blockSize, blockSize);
 
-  m_matrix.row(0) = a.row(0).conjugate();
-  m_matrix.col(0).end(size-1) = m_matrix.row(0).end(size-1) / m_matrix.coeff(0,0);
-  for (int j = 1; j < size; ++j)
+  for (int k = 0; k < size; k += blockSize)
   {
-    RealScalar tmp = ei_real(a.coeff(j,j) - (m_matrix.row(j).start(j) * m_matrix.col(j).start(j).conjugate()).coeff(0,0));
-    m_matrix.coeffRef(j,j) = tmp;
+    const int panelEnd = std::min(k+blockSize, size);
 
-    if (tmp < eps)
+    // factorize the panel of columns k to panelEnd, left looking
+    for (int j = k; j < panelEnd; ++j)
     {
-      m_isPositiveDefinite = false;
-      return;
+      if (j>k)
+      {
+        for (int i = k; i < j; ++i)
+          _temporary.coeffRef(i-k) = m_matrix.coeff(i,i) * ei_conj(m_matrix.coeff(j,i));
+        m_matrix.col(j).end(size-j).noalias() -= m_matrix.block(j, k, size-j, j-k) * _temporary.start(j-k);
+      }
+
+      RealScalar tmp = ei_real(m_matrix.coeff(j,j));
+      m_matrix.coeffRef(j,j) = tmp;
+
+      if (tmp < eps)
+      {
+        m_isPositiveDefinite = false;
+        return;
+      }
+
+      int endSize = size-j-1;
+      if (endSize>0)
+        m_matrix.col(j).end(endSize) /= tmp;
     }
 
-    int endSize = size-j-1;
+    // update the trailing matrix: A22 -= L21 * D1 * L21^*
+    const int endSize = size-panelEnd;
     if (endSize>0)
     {
-      _temporary.end(endSize) = ( m_matrix.block(j+1,0, endSize, j)
-                                  * m_matrix.col(j).start(j).conjugate() ).lazy();
+      const Block<MatrixType> l21(m_matrix, panelEnd, k, endSize, panelEnd-k);
+      Block<Matrix<Scalar,Dynamic,Dynamic> > l21d(ld, 0, 0, endSize, panelEnd-k);
+      for (int i = 0; i < panelEnd-k; ++i)
+        l21d.col(i) = l21.col(i) * m_matrix.coeff(k+i,k+i);
+      ei_cholesky_update_lower(Block<MatrixType>(m_matrix, panelEnd, panelEnd, endSize, endSize), l21d, l21, blockSize);
+    }
+  }
+}
 
-      m_matrix.row(j).end(endSize) = a.row(j).end(endSize).conjugate()
-                                   - _temporary.end(endSize).transpose();
+/** Updates the decomposition in place, so that it becomes the decomposition of \f$ A + \sigma w w^* \f$,
+  * where A is the decomposed matrix. The vector \a w can also be a matrix of k columns, for a rank k update
+  * which is applied one column after the other. A negative \a sigma removes the columns of \a w, which is
+  * known as a downdate.
+  *
+  * This costs O(k n^2) operations, instead of the O(n^3) of compute().
+  *
+  * \returns true in case of success. Otherwise the updated matrix is not positive definite, which only
+  * happens for a downdate, isPositiveDefinite() becomes false and the decomposition must be recomputed.
+  *
+  * \sa compute(), LLT::rankUpdate()
+  */
+template<typename MatrixType>
+template<typename Derived>
+bool LDLT<MatrixType>::rankUpdate(const MatrixBase<Derived>& w, RealScalar sigma)
+{
+  const int size = m_matrix.rows();
+  ei_assert(w.rows()==size && "LDLT::rankUpdate(): invalid number of rows of w");
+  const RealScalar eps = ei_sqrt(precision<Scalar>());
+  const int lInc = int(MatrixType::Flags)&RowMajorBit ? m_matrix.stride() : 1;
+  VectorType tmp(size);
+
+  for (int k = 0; k < w.cols() && m_isPositiveDefinite; ++k)
+  {
+    tmp = w.col(k);
+    RealScalar alpha = 1;
+    for (int j = 0; j < size; ++j)
+    {
+      // D(j) becomes D(j) + sigma |w(j)|^2 / alpha
+      const RealScalar dj = ei_real(m_matrix.coeff(j,j));
+      const Scalar wj = tmp.coeff(j);
+      const RealScalar swj2 = sigma * ei_abs2(wj);
+      const RealScalar gamma = dj*alpha + swj2;
+      const RealScalar x = dj + swj2/alpha;
+      if (x < eps)
+      {
+        m_isPositiveDefinite = false;
+        break;
+      }
+      m_matrix.coeffRef(j,j) = x;
+      alpha += swj2/dj;
 
-      m_matrix.col(j).end(endSize) = m_matrix.row(j).end(endSize) / tmp;
+      // w -= w(j) L.col(j), and L.col(j) += sigma conj(w(j))/gamma w
+      const int endSize = size-j-1;
+      if (endSize>0)
+        ei_cholesky_rank_update_column(&m_matrix.coeffRef(j+1,j), lInc, &tmp.coeffRef(j+1), endSize,
+                                       wj, Scalar(1), Scalar(sigma*ei_conj(wj)/gamma));
     }
   }
+  return m_isPositiveDefinite;
 }
 
 /** Computes the solution x of \f$ A x = b \f$ using the current decomposition of A.
@@ -25,6 +25,91 @@
 #ifndef EIGEN_LLT_H
 #define EIGEN_LLT_H
 
+/** \internal
+  * Performs the update mat -= lhs * rhs^* of the lower triangular part of the square matrix \a mat,
+  * per panel of \a blockSize columns. Each panel is a cache friendly product, and the panels are
+  * updated by several threads when OpenMP is enabled and the update is large enough to pay for them
+  * (see EIGEN_PARALLEL_UPDATE_THRESHOLD). The panels get shorter from left to right, so they are
+  * handed out one by one to the idle threads rather than in equal shares.
+  */
+template<typename MatrixType, typename LhsType, typename RhsType>
+struct ei_cholesky_update_kernel
+{
+  ei_cholesky_update_kernel(MatrixType& mat, const LhsType& lhs, const RhsType& rhs, int blockSize)
+    : m_mat(mat), m_lhs(lhs), m_rhs(rhs), m_blockSize(blockSize) {}
+
+  void operator()(int start, int end) const
+  {
+    const int depth = m_lhs.cols();
+    for (int j = start; j < end; j += m_blockSize)
+    {
+      const int w = std::min(m_blockSize, end-j);
+      const int h = m_mat.rows()-j;
+      m_mat.block(j, j, h, w).noalias() -= m_lhs.block(j, 0, h, depth) * m_rhs.block(j, 0, w, depth).adjoint();
+    }
+  }
+
+  MatrixType& m_mat;
+  const LhsType& m_lhs;
+  const RhsType& m_rhs;
+  const int m_blockSize;
+
+  private:
+    ei_cholesky_update_kernel& operator=(const ei_cholesky_update_kernel&);
+};
+
+template<typename MatrixType, typename LhsType, typename RhsType>
+void ei_cholesky_update_lower(MatrixType mat, const LhsType& lhs, const RhsType& rhs, int blockSize)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  // a column costs about half the height of the matrix times the depth in multiply-adds,
+  // and each thread gets two panels at least
+  const int columnCost = std::max(1, mat.rows()/2 * lhs.cols() * (NumTraits<Scalar>::MulCost + NumTraits<Scalar>::AddCost));
+  const int threshold = std::max(2*blockSize, EIGEN_PARALLEL_UPDATE_THRESHOLD / columnCost);
+  ei_parallelize_dynamic(ei_cholesky_update_kernel<MatrixType,LhsType,RhsType>(mat, lhs, rhs, blockSize),
+                         mat.cols(), threshold, blockSize);
+}
+
+/** \internal
+  * Performs the coupled updates w = w - a l and then l = b l + c w, where \a l points to the \a size coefficients,
+  * \a lInc apart, of a column of a Cholesky factor, and \a w to a contiguous work vector. This is the inner loop of
+  * the rank one updates of LLT and LDLT. When the column is contiguous, it is vectorized, and its loads and stores
+  * are aligned.
+  */
+template<typename Scalar>
+void ei_cholesky_rank_update_column(Scalar* l, int lInc, Scalar* w, int size, Scalar a, Scalar b, Scalar c)
+{
+  typedef typename ei_packet_traits<Scalar>::type Packet;
+  const int PacketSize = ei_packet_traits<Scalar>::size;
+  int alignedStart = 0;
+  int alignedEnd = 0;
+  if (PacketSize>1 && lInc==1)
+  {
+    alignedStart = ei_alignmentOffset(l, size);
+    alignedEnd = alignedStart + ((size-alignedStart)/PacketSize)*PacketSize;
+
+    for (int i=0; i<alignedStart; ++i)
+    {
+      w[i] -= a*l[i];
+      l[i] = b*l[i] + c*w[i];
+    }
+
+    const Packet pa = ei_pset1(a), pb = ei_pset1(b), pc = ei_pset1(c);
+    for (int i=alignedStart; i<alignedEnd; i+=PacketSize)
+    {
+      Packet pl = ei_pload(l+i);
+      Packet pw = ei_psub(ei_ploadu(w+i), ei_pmul(pa, pl));
+      ei_pstoreu(w+i, pw);
+      ei_pstore(l+i, ei_padd(ei_pmul(pb, pl), ei_pmul(pc, pw)));
+    }
+  }
+  for (int i=alignedEnd; i<size; ++i)
+  {
+    w[i] -= a*l[i*lInc];
+    l[i*lInc] = b*l[i*lInc] + c*w[i];
+  }
+}
+
 /** \ingroup cholesky_Module
   *
   * \class LLT
@@ -44,6 +129,9 @@
   * Note that during the decomposition, only the upper triangular part of A is considered. Therefore,
   * the strict lower part does not have to store correct values.
   *
+  * An existing decomposition can be updated in O(n^2) when A receives a low rank modification,
+  * see rankUpdate().
+  *
   * \sa MatrixBase::llt(), class LDLT
   */
 template<typename MatrixType> class LLT
@@ -80,16 +168,23 @@ template<typename MatrixType> class LLT
 
     void compute(const MatrixType& matrix);
 
+    template<typename Derived>
+    bool rankUpdate(const MatrixBase<Derived>& w, RealScalar sigma = 1);
+
   protected:
     /** \internal
       * Used to compute and store L
-      * The strict upper part is not used and even not initialized.
+      * The strict upper part is not used.
       */
     MatrixType m_matrix;
     bool m_isPositiveDefinite;
 };
 
 /** Computes / recomputes the Cholesky decomposition A = LL^* = U^*U of \a matrix
+  *
+  * Large matrices are factorized per panel of EIGEN_DECOMPOSITION_BLOCK_SIZE columns: each panel is
+  * factorized by the unblocked algorithm, and the trailing matrix is then updated by a cache friendly
+  * rank-k product.
   */
 template<typename MatrixType>
 void LLT<MatrixType>::compute(const MatrixType& a)
@@ -99,34 +194,101 @@ void LLT<MatrixType>::compute(const MatrixType& a)
   m_matrix.resize(size, size);
   const RealScalar eps = ei_sqrt(precision<Scalar>());
 
-  RealScalar x;
-  x = ei_real(a.coeff(0,0));
-  m_isPositiveDefinite = x > eps && ei_isMuchSmallerThan(ei_imag(a.coeff(0,0)), RealScalar(1));
-  m_matrix.coeffRef(0,0) = ei_sqrt(x);
-  m_matrix.col(0).end(size-1) = a.row(0).end(size-1).adjoint() / ei_real(m_matrix.coeff(0,0));
-  for (int j = 1; j < size; ++j)
+  // the decomposition is performed in place on the lower triangular part,
+  // which is the adjoint of the upper triangular part of a
+  m_matrix = a.adjoint();
+  m_isPositiveDefinite = true;
+
+  const int blockSize = size >= 2*EIGEN_DECOMPOSITION_BLOCK_SIZE ? EIGEN_DECOMPOSITION_BLOCK_SIZE : size;
+  for (int k = 0; k < size; k += blockSize)
   {
-    Scalar tmp = ei_real(a.coeff(j,j)) - m_matrix.row(j).start(j).squaredNorm();
-    x = ei_real(tmp);
-    if (x < eps || (!ei_isMuchSmallerThan(ei_imag(tmp), RealScalar(1))))
+    const int panelEnd = std::min(k+blockSize, size);
+
+    // factorize the panel of columns k to panelEnd, left looking
+    for (int j = k; j < panelEnd; ++j)
     {
-      m_isPositiveDefinite = false;
-      return;
+      Scalar tmp = m_matrix.coeff(j,j);
+      if (j>k)
+        tmp -= m_matrix.row(j).segment(k, j-k).squaredNorm();
+      RealScalar x = ei_real(tmp);
+      if (x < eps || (!ei_isMuchSmallerThan(ei_imag(tmp), RealScalar(1))))
+      {
+        m_isPositiveDefinite = false;
+        return;
+      }
+      m_matrix.coeffRef(j,j) = x = ei_sqrt(x);
+
+      int endSize = size-j-1;
+      if (endSize>0) {
+        if (j>k)
+          m_matrix.col(j).end(endSize).noalias() -=
+            m_matrix.block(j+1, k, endSize, j-k) * m_matrix.row(j).segment(k, j-k).adjoint();
+        m_matrix.col(j).end(endSize) /= x;
+      }
+    }
+
+    // update the trailing matrix: A22 -= L21 * L21^*
+    const int endSize = size-panelEnd;
+    if (endSize>0)
+    {
+      const Block<MatrixType> l21(m_matrix, panelEnd, k, endSize, panelEnd-k);
+      ei_cholesky_update_lower(Block<MatrixType>(m_matrix, panelEnd, panelEnd, endSize, endSize), l21, l21, blockSize);
     }
-    m_matrix.coeffRef(j,j) = x = ei_sqrt(x);
-
-    int endSize = size-j-1;
-    if (endSize>0) {
-      // Note that when all matrix columns have good alignment, then the following
-      // product is guaranteed to be optimal with respect to alignment.
-      m_matrix.col(j).end(endSize) =
-        (m_matrix.block(j+1, 0, endSize, j) * m_matrix.row(j).start(j).adjoint()).lazy();
-
-      // FIXME could use a.col instead of a.row
-      m_matrix.col(j).end(endSize) = (a.row(j).end(endSize).adjoint()
-        - m_matrix.col(j).end(endSize) ) / x;
+  }
+}
+
+/** Updates the decomposition in place, so that it becomes the decomposition of \f$ A + \sigma w w^* \f$,
+  * where A is the decomposed matrix. The vector \a w can also be a matrix of k columns, for a rank k update
+  * \f$ A + \sigma w w^* \f$, which is applied one column after the other. A negative \a sigma removes
+  * the columns of \a w, which is known as a downdate.
+  *
+  * This costs O(k n^2) operations, instead of the O(n^3) of compute().
+  *
+  * \returns true in case of success. Otherwise the updated matrix is not positive definite, which only
+  * happens for a downdate, isPositiveDefinite() becomes false and the decomposition must be recomputed.
+  *
+  * \sa compute()
+  */
+template<typename MatrixType>
+template<typename Derived>
+bool LLT<MatrixType>::rankUpdate(const MatrixBase<Derived>& w, RealScalar sigma)
+{
+  const int size = m_matrix.rows();
+  ei_assert(w.rows()==size && "LLT::rankUpdate(): invalid number of rows of w");
+  const RealScalar eps = ei_sqrt(precision<Scalar>());
+  const int lInc = int(MatrixType::Flags)&RowMajorBit ? m_matrix.stride() : 1;
+  VectorType tmp(size);
+
+  for (int k = 0; k < w.cols() && m_isPositiveDefinite; ++k)
+  {
+    tmp = w.col(k);
+    RealScalar beta = 1;
+    for (int j = 0; j < size; ++j)
+    {
+      // L(j,j)^2 becomes L(j,j)^2 + sigma |w(j)|^2 / beta
+      const RealScalar ljj = ei_real(m_matrix.coeff(j,j));
+      const RealScalar dj = ljj*ljj;
+      const Scalar wj = tmp.coeff(j);
+      const RealScalar swj2 = sigma * ei_abs2(wj);
+      const RealScalar gamma = dj*beta + swj2;
+      const RealScalar x = dj + swj2/beta;
+      if (x < eps)
+      {
+        m_isPositiveDefinite = false;
+        break;
+      }
+      const RealScalar nljj = ei_sqrt(x);
+      m_matrix.coeffRef(j,j) = nljj;
+      beta += swj2/dj;
+
+      // w -= w(j)/L(j,j) L.col(j), and L.col(j) = nL(j,j)/L(j,j) L.col(j) + nL(j,j) sigma conj(w(j))/gamma w
+      const int endSize = size-j-1;
+      if (endSize>0)
+        ei_cholesky_rank_update_column(&m_matrix.coeffRef(j+1,j), lInc, &tmp.coeffRef(j+1), endSize,
+                                       Scalar(wj/ljj), Scalar(nljj/ljj), Scalar(nljj*sigma*ei_conj(wj)/gamma));
     }
   }
+  return m_isPositiveDefinite;
 }
 
 /** Computes the solution x of \f$ A x = b \f$ using the current decomposition of A.
@@ -203,6 +203,34 @@ template<typename Derived1, typename Derived2,
          int Unrolling = ei_assign_traits<Derived1, Derived2>::Unrolling>
 struct ei_assign_impl;
 
+/** \internal functor running the implementation \a Impl on a sub-range of the outer loop of an assignment */
+template<typename Impl, typename Derived1, typename Derived2>
+struct ei_assign_range_kernel
+{
+  ei_assign_range_kernel(Derived1& dst, const Derived2& src) : m_dst(dst), m_src(src) {}
+  void operator()(int start, int end) const { Impl::runRange(m_dst, m_src, start, end); }
+
+  Derived1& m_dst;
+  const Derived2& m_src;
+};
+
+/** \internal runs \c Impl::runRange() over the \a size iterations of the outer loop of an assignment,
+  * each of them assigning \a unitSize coefficients. Large dynamic-size assignments are split across
+  * several threads (see EIGEN_PARALLEL_ASSIGN_THRESHOLD), the chunk sizes being multiples of \a granularity.
+  * The expressions having the NonRepeatableBit, like Random(), are always assigned in order by the calling
+  * thread, so that they give the same coefficients as without OpenMP.
+  */
+template<typename Impl, typename Derived1, typename Derived2>
+inline void ei_assign_parallel(Derived1 &dst, const Derived2 &src, int size, int unitSize, int granularity = 1)
+{
+  if(Derived1::SizeAtCompileTime != Dynamic || (int(Derived2::Flags) & NonRepeatableBit))
+    Impl::runRange(dst, src, 0, size);
+  else
+    ei_parallelize(ei_assign_range_kernel<Impl, Derived1, Derived2>(dst, src), size,
+                   EIGEN_PARALLEL_ASSIGN_THRESHOLD / std::max(unitSize, 1) / std::max<int>(Derived2::CoeffReadCost, 1),
+                   granularity);
+}
+
 /***********************
 *** No vectorization ***
 ***********************/
@@ -211,10 +239,14 @@ template<typename Derived1, typename Derived2>
 struct ei_assign_impl<Derived1, Derived2, NoVectorization, NoUnrolling>
 {
   inline static void run(Derived1 &dst, const Derived2 &src)
+  {
+    ei_assign_parallel<ei_assign_impl>(dst, src, dst.outerSize(), dst.innerSize());
+  }
+
+  inline static void runRange(Derived1 &dst, const Derived2 &src, int outerStart, int outerEnd)
   {
     const int innerSize = dst.innerSize();
-    const int outerSize = dst.outerSize();
-    for(int j = 0; j < outerSize; ++j)
+    for(int j = outerStart; j < outerEnd; ++j)
       for(int i = 0; i < innerSize; ++i)
       {
         if(int(Derived1::Flags)&RowMajorBit)
@@ -238,13 +270,17 @@ struct ei_assign_impl<Derived1, Derived2, NoVectorization, CompleteUnrolling>
 template<typename Derived1, typename Derived2>
 struct ei_assign_impl<Derived1, Derived2, NoVectorization, InnerUnrolling>
 {
+  enum { InnerSize = int(Derived1::Flags)&RowMajorBit ? Derived1::ColsAtCompileTime : Derived1::RowsAtCompileTime };
+
   EIGEN_STRONG_INLINE static void run(Derived1 &dst, const Derived2 &src)
   {
-    const bool rowMajor = int(Derived1::Flags)&RowMajorBit;
-    const int innerSize = rowMajor ? Derived1::ColsAtCompileTime : Derived1::RowsAtCompileTime;
-    const int outerSize = dst.outerSize();
-    for(int j = 0; j < outerSize; ++j)
-      ei_assign_novec_InnerUnrolling<Derived1, Derived2, 0, innerSize>
+    ei_assign_parallel<ei_assign_impl>(dst, src, dst.outerSize(), InnerSize);
+  }
+
+  EIGEN_STRONG_INLINE static void runRange(Derived1 &dst, const Derived2 &src, int outerStart, int outerEnd)
+  {
+    for(int j = outerStart; j < outerEnd; ++j)
+      ei_assign_novec_InnerUnrolling<Derived1, Derived2, 0, InnerSize>
         ::run(dst, src, j);
   }
 };
@@ -257,11 +293,15 @@ template<typename Derived1, typename Derived2>
 struct ei_assign_impl<Derived1, Derived2, InnerVectorization, NoUnrolling>
 {
   inline static void run(Derived1 &dst, const Derived2 &src)
+  {
+    ei_assign_parallel<ei_assign_impl>(dst, src, dst.outerSize(), dst.innerSize());
+  }
+
+  inline static void runRange(Derived1 &dst, const Derived2 &src, int outerStart, int outerEnd)
   {
     const int innerSize = dst.innerSize();
-    const int outerSize = dst.outerSize();
     const int packetSize = ei_packet_traits<typename Derived1::Scalar>::size;
-    for(int j = 0; j < outerSize; ++j)
+    for(int j = outerStart; j < outerEnd; ++j)
       for(int i = 0; i < innerSize; i+=packetSize)
       {
         if(int(Derived1::Flags)&RowMajorBit)
@@ -285,13 +325,17 @@ struct ei_assign_impl<Derived1, Derived2, InnerVectorization, CompleteUnrolling>
 template<typename Derived1, typename Derived2>
 struct ei_assign_impl<Derived1, Derived2, InnerVectorization, InnerUnrolling>
 {
+  enum { InnerSize = int(Derived1::Flags)&RowMajorBit ? Derived1::ColsAtCompileTime : Derived1::RowsAtCompileTime };
+
   EIGEN_STRONG_INLINE static void run(Derived1 &dst, const Derived2 &src)
   {
-    const bool rowMajor = int(Derived1::Flags)&RowMajorBit;
-    const int innerSize = rowMajor ? Derived1::ColsAtCompileTime : Derived1::RowsAtCompileTime;
-    const int outerSize = dst.outerSize();
-    for(int j = 0; j < outerSize; ++j)
-      ei_assign_innervec_InnerUnrolling<Derived1, Derived2, 0, innerSize>
+    ei_assign_parallel<ei_assign_impl>(dst, src, dst.outerSize(), InnerSize);
+  }
+
+  EIGEN_STRONG_INLINE static void runRange(Derived1 &dst, const Derived2 &src, int outerStart, int outerEnd)
+  {
+    for(int j = outerStart; j < outerEnd; ++j)
+      ei_assign_innervec_InnerUnrolling<Derived1, Derived2, 0, InnerSize>
         ::run(dst, src, j);
   }
 };
@@ -300,26 +344,58 @@ struct ei_assign_impl<Derived1, Derived2, InnerVectorization, InnerUnrolling>
 *** Linear vectorization ***
 ***************************/
 
+/** \internal same as \a Impl but writing the aligned packets of the destination with non-temporal stores */
+template<typename Impl>
+struct ei_assign_streaming_impl
+{
+  template<typename Derived1, typename Derived2>
+  inline static void runRange(Derived1 &dst, const Derived2 &src, int start, int end)
+  {
+    Impl::template runRangeWith<Streaming>(dst, src, start, end);
+    ei_pstream_fence<typename ei_packet_traits<typename Derived1::Scalar>::type>();
+  }
+};
+
 template<typename Derived1, typename Derived2>
 struct ei_assign_impl<Derived1, Derived2, LinearVectorization, NoUnrolling>
 {
   inline static void run(Derived1 &dst, const Derived2 &src)
   {
-    const int size = dst.size();
+    run(dst, src, std::size_t(dst.size())*sizeof(typename Derived1::Scalar) >= std::size_t(EIGEN_STREAMING_STORE_THRESHOLD));
+  }
+
+  inline static void run(Derived1 &dst, const Derived2 &src, bool streaming)
+  {
+    const int packetSize = ei_packet_traits<typename Derived1::Scalar>::size;
+    if(streaming)
+      ei_assign_parallel<ei_assign_streaming_impl<ei_assign_impl> >(dst, src, dst.size(), 1, packetSize);
+    else
+      ei_assign_parallel<ei_assign_impl>(dst, src, dst.size(), 1, packetSize);
+  }
+
+  inline static void runRange(Derived1 &dst, const Derived2 &src, int start, int end)
+  {
+    runRangeWith<Aligned>(dst, src, start, end);
+  }
+
+  template<int StoreMode>
+  inline static void runRangeWith(Derived1 &dst, const Derived2 &src, int start, int end)
+  {
     const int packetSize = ei_packet_traits<typename Derived1::Scalar>::size;
-    const int alignedStart = ei_assign_traits<Derived1,Derived2>::DstIsAligned ? 0
-                           : ei_alignmentOffset(&dst.coeffRef(0), size);
-    const int alignedEnd = alignedStart + ((size-alignedStart)/packetSize)*packetSize;
+    const int alignedStart = ei_assign_traits<Derived1,Derived2>::DstIsAligned
+                           ? std::min(((start+packetSize-1)/packetSize)*packetSize, end)
+                           : start + ei_alignmentOffset(&dst.coeffRef(start), end-start);
+    const int alignedEnd = alignedStart + ((end-alignedStart)/packetSize)*packetSize;
 
-    for(int index = 0; index < alignedStart; ++index)
+    for(int index = start; index < alignedStart; ++index)
       dst.copyCoeff(index, src);
 
     for(int index = alignedStart; index < alignedEnd; index += packetSize)
     {
-      dst.template copyPacket<Derived2, Aligned, ei_assign_traits<Derived1,Derived2>::SrcAlignment>(index, src);
+      dst.template copyPacket<Derived2, StoreMode, ei_assign_traits<Derived1,Derived2>::SrcAlignment>(index, src);
     }
 
-    for(int index = alignedEnd; index < size; ++index)
+    for(int index = alignedEnd; index < end; ++index)
       dst.copyCoeff(index, src);
   }
 };
@@ -346,16 +422,21 @@ template<typename Derived1, typename Derived2>
 struct ei_assign_impl<Derived1, Derived2, SliceVectorization, NoUnrolling>
 {
   inline static void run(Derived1 &dst, const Derived2 &src)
+  {
+    ei_assign_parallel<ei_assign_impl>(dst, src, dst.outerSize(), dst.innerSize());
+  }
+
+  inline static void runRange(Derived1 &dst, const Derived2 &src, int outerStart, int outerEnd)
   {
     const int packetSize = ei_packet_traits<typename Derived1::Scalar>::size;
     const int packetAlignedMask = packetSize - 1;
     const int innerSize = dst.innerSize();
-    const int outerSize = dst.outerSize();
     const int alignedStep = (packetSize - dst.stride() % packetSize) & packetAlignedMask;
-    int alignedStart = ei_assign_traits<Derived1,Derived2>::DstIsAligned ? 0
-                     : ei_alignmentOffset(&dst.coeffRef(0), innerSize);
+    int alignedStart = ei_assign_traits<Derived1,Derived2>::DstIsAligned && outerStart==0 ? 0
+                     : ei_alignmentOffset(Derived1::Flags&RowMajorBit ? &dst.coeffRef(outerStart, 0)
+                                                                      : &dst.coeffRef(0, outerStart), innerSize);
 
-    for(int i = 0; i < outerSize; ++i)
+    for(int i = outerStart; i < outerEnd; ++i)
     {
       const int alignedEnd = alignedStart + ((innerSize-alignedStart) & ~packetAlignedMask);
 
@@ -408,6 +489,42 @@ EIGEN_STRONG_INLINE Derived& MatrixBase<Derived>
   return derived();
 }
 
+template<typename Derived, typename OtherDerived,
+         bool MayStream = int(ei_assign_traits<Derived, OtherDerived>::Vectorization) == int(LinearVectorization)
+                       && int(ei_assign_traits<Derived, OtherDerived>::Unrolling) == int(NoUnrolling)>
+struct ei_streaming_assign_selector
+{
+  inline static void run(Derived& dst, const OtherDerived& other) { ei_assign_impl<Derived, OtherDerived>::run(dst, other); }
+};
+
+template<typename Derived, typename OtherDerived>
+struct ei_streaming_assign_selector<Derived, OtherDerived, true>
+{
+  inline static void run(Derived& dst, const OtherDerived& other) { ei_assign_impl<Derived, OtherDerived>::run(dst, other, true); }
+};
+
+/** Copies \a other into *this like operator=(), but writes *this with non-temporal stores bypassing the
+  * caches whenever the assignment is vectorized. This is worth it when *this is not going to be read again soon,
+  * typically for memory bound fills and copies. \returns a reference to *this.
+  *
+  * Such stores are used automatically for destinations larger than EIGEN_STREAMING_STORE_THRESHOLD bytes.
+  *
+  * \sa lazyAssign(), operator=()
+  */
+template<typename Derived>
+template<typename OtherDerived>
+inline Derived& MatrixBase<Derived>::streamingAssign(const MatrixBase<OtherDerived>& other)
+{
+  EIGEN_STATIC_ASSERT_SAME_MATRIX_SIZE(Derived,OtherDerived)
+  EIGEN_STATIC_ASSERT((ei_is_same_type<typename Derived::Scalar, typename OtherDerived::Scalar>::ret),
+    YOU_MIXED_DIFFERENT_NUMERIC_TYPES__YOU_NEED_TO_USE_THE_CAST_METHOD_OF_MATRIXBASE_TO_CAST_NUMERIC_TYPES_EXPLICITLY)
+  if(int(OtherDerived::Flags) & EvalBeforeAssigningBit)
+    return streamingAssign(other.eval());
+  ei_assert(rows() == other.rows() && cols() == other.cols());
+  ei_streaming_assign_selector<Derived, OtherDerived>::run(derived(), other.derived());
+  return derived();
+}
+
 template<typename Derived, typename OtherDerived,
          bool EvalBeforeAssigning = (int(OtherDerived::Flags) & EvalBeforeAssigningBit) != 0,
          bool NeedToTranspose = Derived::IsVectorAtCompileTime
@@ -30,20 +30,118 @@ struct ei_L2_block_traits {
   enum {width = 8 * ei_meta_sqrt<L2MemorySize/(64*sizeof(Scalar))>::ret };
 };
 
+template<typename Scalar> inline Scalar ei_conj_if(bool cond, const Scalar& x)
+{ return cond ? ei_conj(x) : x; }
+
+/** \internal
+  * The blocking parameters of the matrix * matrix kernel. They fully determine the layout of the
+  * packed lhs, which therefore only depends on the scalar type and on the sizes of the lhs.
+  */
+template<typename Scalar>
+struct ei_product_blocking_traits
+{
+  typedef typename ei_packet_traits<Scalar>::type PacketType;
+  enum {
+    PacketSize = sizeof(PacketType)/sizeof(Scalar),
+    #if (defined __i386__)
+    // i386 architecture provides only 8 xmm registers,
+    // so let's reduce the max number of rows processed at once.
+    MaxBlockRows = 4,
+    MaxBlockRows_ClampingMask = 0xFFFFFC,
+    #else
+    MaxBlockRows = 8,
+    MaxBlockRows_ClampingMask = 0xFFFFF8,
+    #endif
+    // maximal size of the blocks fitted in L2 cache
+    MaxL2BlockSize = ei_L2_block_traits<EIGEN_TUNE_FOR_CPU_CACHE_SIZE,Scalar>::width
+  };
+};
+
 #ifndef EIGEN_EXTERN_INSTANTIATIONS
 
+/** \internal
+  * Copies the rows \a l2i to \a l2blockRowEnd of \a alpha * op(lhs) to \a block, in the order they are
+  * read by the matrix * matrix kernel: for each L2 slice of the depth, panels of MaxBlockRows rows
+  * interleaved per packet, followed by the remaining rows. Only the first \a size columns, a multiple
+  * of the packet size, are copied.
+  */
 template<typename Scalar>
-static void ei_cache_friendly_product(
+static void ei_cache_friendly_pack_lhs_block(int l2i, int l2blockRowEnd, int size,
+  bool lhsRowMajor, bool conjLhs, const Scalar* lhs, int lhsStride, Scalar alpha, Scalar* block)
+{
+  typedef ei_product_blocking_traits<Scalar> Blocking;
+  enum {
+    PacketSize = Blocking::PacketSize,
+    MaxBlockRows = Blocking::MaxBlockRows,
+    MaxL2BlockSize = Blocking::MaxL2BlockSize
+  };
+  const int l2BlockSize = MaxL2BlockSize > size ? size : MaxL2BlockSize;
+  const int l2blockRowEndBW = l2blockRowEnd & Blocking::MaxBlockRows_ClampingMask;    // end of the rows aligned to bw
+  const int l2blockRemainingRows = l2blockRowEnd - l2blockRowEndBW;         // number of remaining rows
+
+  int count = 0;
+
+  // copy l2blocksize rows of m_lhs to blocks of ps x bw
+  for(int l2k=0; l2k<size; l2k+=l2BlockSize)
+  {
+    const int l2blockSizeEnd = std::min(l2k+l2BlockSize, size);
+
+    for (int i = l2i; i<l2blockRowEndBW; i+=MaxBlockRows)
+    {
+      for (int k=l2k; k<l2blockSizeEnd; k+=PacketSize)
+      {
+        // TODO write these loops using meta unrolling
+        // negligible for large matrices but useful for small ones
+        if (lhsRowMajor)
+        {
+          for (int w=0; w<MaxBlockRows; ++w)
+            for (int s=0; s<PacketSize; ++s)
+              block[count++] = alpha * ei_conj_if(conjLhs, lhs[(i+w)*lhsStride + (k+s)]);
+        }
+        else
+        {
+          for (int w=0; w<MaxBlockRows; ++w)
+            for (int s=0; s<PacketSize; ++s)
+              block[count++] = alpha * ei_conj_if(conjLhs, lhs[(i+w) + (k+s)*lhsStride]);
+        }
+      }
+    }
+    if (l2blockRemainingRows>0)
+    {
+      for (int k=l2k; k<l2blockSizeEnd; k+=PacketSize)
+      {
+        if (lhsRowMajor)
+        {
+          for (int w=0; w<l2blockRemainingRows; ++w)
+            for (int s=0; s<PacketSize; ++s)
+              block[count++] = alpha * ei_conj_if(conjLhs, lhs[(l2blockRowEndBW+w)*lhsStride + (k+s)]);
+        }
+        else
+        {
+          for (int w=0; w<l2blockRemainingRows; ++w)
+            for (int s=0; s<PacketSize; ++s)
+              block[count++] = alpha * ei_conj_if(conjLhs, lhs[(l2blockRowEndBW+w) + (k+s)*lhsStride]);
+        }
+      }
+    }
+  }
+}
+
+template<typename Scalar>
+static void ei_cache_friendly_product_kernel(
   int _rows, int _cols, int depth,
-  bool _lhsRowMajor, const Scalar* _lhs, int _lhsStride,
-  bool _rhsRowMajor, const Scalar* _rhs, int _rhsStride,
-  bool resRowMajor, Scalar* res, int resStride)
+  bool _lhsRowMajor, bool _conjLhs, const Scalar* _lhs, int _lhsStride,
+  bool _rhsRowMajor, bool _conjRhs, const Scalar* _rhs, int _rhsStride,
+  bool resRowMajor, Scalar* res, int resStride, Scalar alpha, const Scalar* packedLhs)
 {
+  // a pre-packed lhs cannot be swapped with the rhs
+  ei_internal_assert(packedLhs==0 || !resRowMajor);
   const Scalar* EIGEN_RESTRICT lhs;
   const Scalar* EIGEN_RESTRICT rhs;
   int lhsStride, rhsStride, rows, cols;
-  bool lhsRowMajor;
+  bool lhsRowMajor, rhsRowMajor, conjLhs, conjRhs;
 
+  // a row major result is computed as the column major result of the transposed product
   if (resRowMajor)
   {
     lhs = _rhs;
@@ -53,7 +151,9 @@ static void ei_cache_friendly_product(
     cols = _rows;
     rows = _cols;
     lhsRowMajor = !_rhsRowMajor;
-    ei_assert(_lhsRowMajor);
+    rhsRowMajor = !_lhsRowMajor;
+    conjLhs = _conjRhs;
+    conjRhs = _conjLhs;
   }
   else
   {
@@ -64,26 +164,22 @@ static void ei_cache_friendly_product(
     rows = _rows;
     cols = _cols;
     lhsRowMajor = _lhsRowMajor;
-    ei_assert(!_rhsRowMajor);
+    rhsRowMajor = _rhsRowMajor;
+    conjLhs = _conjLhs;
+    conjRhs = _conjRhs;
   }
 
-  typedef typename ei_packet_traits<Scalar>::type PacketType;
+  typedef ei_product_blocking_traits<Scalar> Blocking;
+  typedef typename Blocking::PacketType PacketType;
 
   enum {
-    PacketSize = sizeof(PacketType)/sizeof(Scalar),
-    #if (defined __i386__)
-    // i386 architecture provides only 8 xmm registers,
-    // so let's reduce the max number of rows processed at once.
-    MaxBlockRows = 4,
-    MaxBlockRows_ClampingMask = 0xFFFFFC,
-    #else
-    MaxBlockRows = 8,
-    MaxBlockRows_ClampingMask = 0xFFFFF8,
-    #endif
-    // maximal size of the blocks fitted in L2 cache
-    MaxL2BlockSize = ei_L2_block_traits<EIGEN_TUNE_FOR_CPU_CACHE_SIZE,Scalar>::width
+    PacketSize = Blocking::PacketSize,
+    MaxBlockRows = Blocking::MaxBlockRows,
+    MaxBlockRows_ClampingMask = Blocking::MaxBlockRows_ClampingMask,
+    MaxL2BlockSize = Blocking::MaxL2BlockSize
   };
 
+
   const bool resIsAligned = (PacketSize==1) || (((resStride%PacketSize) == 0) && (size_t(res)%16==0));
 
   const int remainingSize = depth % PacketSize;
@@ -92,10 +188,15 @@ static void ei_cache_friendly_product(
   const int l2BlockCols = MaxL2BlockSize > cols ? cols : MaxL2BlockSize;
   const int l2BlockSize = MaxL2BlockSize > size ? size : MaxL2BlockSize;
   const int l2BlockSizeAligned = (1 + std::max(l2BlockSize,l2BlockCols)/PacketSize)*PacketSize;
-  const bool needRhsCopy = (PacketSize>1) && ((rhsStride%PacketSize!=0) || (size_t(rhs)%16!=0));
-  Scalar* EIGEN_RESTRICT block = 0;
-  const int allocBlockSize = l2BlockRows*size;
-  block = ei_aligned_stack_new(Scalar, allocBlockSize);
+  // a pre-packed lhs already holds its own factor, so alpha is applied while copying the rhs
+  const Scalar rhsAlpha = packedLhs ? alpha : Scalar(1);
+  // a row major, conjugated or scaled rhs is packed block per block, like an unaligned one
+  const bool needRhsCopy = rhsRowMajor || conjRhs || rhsAlpha!=Scalar(1)
+                        || ((PacketSize>1) && ((rhsStride%PacketSize!=0) || (size_t(rhs)%16!=0)));
+  Scalar* EIGEN_RESTRICT lhsCopy = 0;
+  const int allocBlockSize = packedLhs ? 0 : l2BlockRows*size;
+  if (!packedLhs)
+    lhsCopy = ei_aligned_stack_new(Scalar, allocBlockSize);
   Scalar* EIGEN_RESTRICT rhsCopy
     = ei_aligned_stack_new(Scalar, l2BlockSizeAligned*l2BlockSizeAligned);
 
@@ -107,56 +208,12 @@ static void ei_cache_friendly_product(
     const int l2blockRemainingRows = l2blockRowEnd - l2blockRowEndBW;         // number of remaining rows
     //const int l2blockRowEndBWPlusOne = l2blockRowEndBW + (l2blockRemainingRows?0:MaxBlockRows);
 
-    // build a cache friendly blocky matrix
-    int count = 0;
-
-    // copy l2blocksize rows of m_lhs to blocks of ps x bw
-    for(int l2k=0; l2k<size; l2k+=l2BlockSize)
-    {
-      const int l2blockSizeEnd = std::min(l2k+l2BlockSize, size);
-
-      for (int i = l2i; i<l2blockRowEndBW/*PlusOne*/; i+=MaxBlockRows)
-      {
-        // TODO merge the "if l2blockRemainingRows" using something like:
-        // const int blockRows = std::min(i+MaxBlockRows, rows) - i;
-
-        for (int k=l2k; k<l2blockSizeEnd; k+=PacketSize)
-        {
-          // TODO write these loops using meta unrolling
-          // negligible for large matrices but useful for small ones
-          if (lhsRowMajor)
-          {
-            for (int w=0; w<MaxBlockRows; ++w)
-              for (int s=0; s<PacketSize; ++s)
-                block[count++] = lhs[(i+w)*lhsStride + (k+s)];
-          }
-          else
-          {
-            for (int w=0; w<MaxBlockRows; ++w)
-              for (int s=0; s<PacketSize; ++s)
-                block[count++] = lhs[(i+w) + (k+s)*lhsStride];
-          }
-        }
-      }
-      if (l2blockRemainingRows>0)
-      {
-        for (int k=l2k; k<l2blockSizeEnd; k+=PacketSize)
-        {
-          if (lhsRowMajor)
-          {
-            for (int w=0; w<l2blockRemainingRows; ++w)
-              for (int s=0; s<PacketSize; ++s)
-                block[count++] = lhs[(l2blockRowEndBW+w)*lhsStride + (k+s)];
-          }
-          else
-          {
-            for (int w=0; w<l2blockRemainingRows; ++w)
-              for (int s=0; s<PacketSize; ++s)
-                block[count++] = lhs[(l2blockRowEndBW+w) + (k+s)*lhsStride];
-          }
-        }
-      }
-    }
+    // build a cache friendly blocky matrix, unless the lhs has been packed beforehand
+    const Scalar* EIGEN_RESTRICT block = lhsCopy;
+    if (packedLhs)
+      block = packedLhs + l2i*size;
+    else
+      ei_cache_friendly_pack_lhs_block(l2i, l2blockRowEnd, size, lhsRowMajor, conjLhs, lhs, lhsStride, alpha, lhsCopy);
 
     for(int l2j=0; l2j<cols; l2j+=l2BlockCols)
     {
@@ -172,7 +229,15 @@ static void ei_cache_friendly_product(
           for(int l1j=l2j; l1j<l2blockColEnd; l1j+=1)
           {
             ei_internal_assert(l2BlockSizeAligned*(l1j-l2j)+(l2blockSizeEnd-l2k) < l2BlockSizeAligned*l2BlockSizeAligned);
-            memcpy(rhsCopy+l2BlockSizeAligned*(l1j-l2j),&(rhs[l1j*rhsStride+l2k]),(l2blockSizeEnd-l2k)*sizeof(Scalar));
+            Scalar* rhsCopyColumn = rhsCopy+l2BlockSizeAligned*(l1j-l2j);
+            if (rhsRowMajor)
+              for(int k=l2k; k<l2blockSizeEnd; ++k)
+                rhsCopyColumn[k-l2k] = rhsAlpha * ei_conj_if(conjRhs, rhs[k*rhsStride+l1j]);
+            else if (conjRhs || rhsAlpha!=Scalar(1))
+              for(int k=l2k; k<l2blockSizeEnd; ++k)
+                rhsCopyColumn[k-l2k] = rhsAlpha * ei_conj_if(conjRhs, rhs[l1j*rhsStride+k]);
+            else
+              memcpy(rhsCopyColumn,&(rhs[l1j*rhsStride+l2k]),(l2blockSizeEnd-l2k)*sizeof(Scalar));
           }
 
         // for each bw x 1 result's block
@@ -313,33 +378,31 @@ static void ei_cache_friendly_product(
   }
   if (PacketSize>1 && remainingSize)
   {
-    if (lhsRowMajor)
-    {
-      for (int j=0; j<cols; ++j)
-        for (int i=0; i<rows; ++i)
-        {
-          Scalar tmp = lhs[i*lhsStride+size] * rhs[j*rhsStride+size];
-          // FIXME this loop get vectorized by the compiler !
-          for (int k=1; k<remainingSize; ++k)
-            tmp += lhs[i*lhsStride+size+k] * rhs[j*rhsStride+size+k];
-          res[i+j*resStride] += tmp;
-        }
-    }
-    else
+    // a pre-packed lhs stores its last columns in column major order right after the blocks,
+    // i.e., its column k>=size starts at packedLhs + k*rows
+    if (packedLhs)
     {
-      for (int j=0; j<cols; ++j)
-        for (int i=0; i<rows; ++i)
-        {
-          Scalar tmp = lhs[i+size*lhsStride] * rhs[j*rhsStride+size];
-          for (int k=1; k<remainingSize; ++k)
-            tmp += lhs[i+(size+k)*lhsStride] * rhs[j*rhsStride+size+k];
-          res[i+j*resStride] += tmp;
-        }
+      lhs = packedLhs;
+      lhsRowMajor = conjLhs = false;
+      lhsStride = rows;
     }
+    const int lhsRowIncr = lhsRowMajor ? lhsStride : 1, lhsDepthIncr = lhsRowMajor ? 1 : lhsStride;
+    const int rhsColIncr = rhsRowMajor ? 1 : rhsStride, rhsDepthIncr = rhsRowMajor ? rhsStride : 1;
+    for (int j=0; j<cols; ++j)
+      for (int i=0; i<rows; ++i)
+      {
+        Scalar tmp = Scalar(0);
+        // FIXME this loop get vectorized by the compiler !
+        for (int k=size; k<depth; ++k)
+          tmp += ei_conj_if(conjLhs, lhs[i*lhsRowIncr+k*lhsDepthIncr])
+               * ei_conj_if(conjRhs, rhs[j*rhsColIncr+k*rhsDepthIncr]);
+        res[i+j*resStride] += alpha * tmp;
+      }
   }
 
-  ei_aligned_stack_delete(Scalar, block, allocBlockSize);
   ei_aligned_stack_delete(Scalar, rhsCopy, l2BlockSizeAligned*l2BlockSizeAligned);
+  if (!packedLhs)
+    ei_aligned_stack_delete(Scalar, lhsCopy, allocBlockSize);
 }
 
 #endif // EIGEN_EXTERN_INSTANTIATIONS
@@ -352,11 +415,11 @@ static void ei_cache_friendly_product(
  * TODO: since rhs gets evaluated only once, no need to evaluate it
  */
 template<typename Scalar, typename RhsType>
-static EIGEN_DONT_INLINE void ei_cache_friendly_product_colmajor_times_vector(
+static EIGEN_DONT_INLINE void ei_cache_friendly_product_colmajor_times_vector_kernel(
   int size,
   const Scalar* lhs, int lhsStride,
   const RhsType& rhs,
-  Scalar* res)
+  Scalar* res, Scalar alpha)
 {
   #ifdef _EIGEN_ACCUMULATE_PACKETS
   #error _EIGEN_ACCUMULATE_PACKETS has already been defined
@@ -422,8 +485,8 @@ static EIGEN_DONT_INLINE void ei_cache_friendly_product_colmajor_times_vector(
   int columnBound = ((rhs.size()-skipColumns)/columnsAtOnce)*columnsAtOnce + skipColumns;
   for (int i=skipColumns; i<columnBound; i+=columnsAtOnce)
   {
-    Packet ptmp0 = ei_pset1(rhs[i]),   ptmp1 = ei_pset1(rhs[i+offset1]),
-           ptmp2 = ei_pset1(rhs[i+2]), ptmp3 = ei_pset1(rhs[i+offset3]);
+    Packet ptmp0 = ei_pset1(alpha*rhs[i]),   ptmp1 = ei_pset1(alpha*rhs[i+offset1]),
+           ptmp2 = ei_pset1(alpha*rhs[i+2]), ptmp3 = ei_pset1(alpha*rhs[i+offset3]);
 
     // this helps a lot generating better binary code
     const Scalar *lhs0 = lhs + i*lhsStride, *lhs1 = lhs + (i+offset1)*lhsStride,
@@ -509,7 +572,7 @@ static EIGEN_DONT_INLINE void ei_cache_friendly_product_colmajor_times_vector(
   {
     for (int i=start; i<end; ++i)
     {
-      Packet ptmp0 = ei_pset1(rhs[i]);
+      Packet ptmp0 = ei_pset1(alpha*rhs[i]);
       const Scalar* lhs0 = lhs + i*lhsStride;
 
       if (PacketSize>1)
@@ -546,10 +609,10 @@ static EIGEN_DONT_INLINE void ei_cache_friendly_product_colmajor_times_vector(
 
 // TODO add peeling to mask unaligned load/stores
 template<typename Scalar, typename ResType>
-static EIGEN_DONT_INLINE void ei_cache_friendly_product_rowmajor_times_vector(
+static EIGEN_DONT_INLINE void ei_cache_friendly_product_rowmajor_times_vector_kernel(
   const Scalar* lhs, int lhsStride,
   const Scalar* rhs, int rhsSize,
-  ResType& res)
+  ResType& res, Scalar alpha)
 {
   #ifdef _EIGEN_ACCUMULATE_PACKETS
   #error _EIGEN_ACCUMULATE_PACKETS has already been defined
@@ -705,7 +768,7 @@ static EIGEN_DONT_INLINE void ei_cache_friendly_product_rowmajor_times_vector(
       Scalar b = rhs[j];
       tmp0 += b*lhs0[j]; tmp1 += b*lhs1[j]; tmp2 += b*lhs2[j]; tmp3 += b*lhs3[j];
     }
-    res[i] += tmp0; res[i+offset1] += tmp1; res[i+2] += tmp2; res[i+offset3] += tmp3;
+    res[i] += alpha*tmp0; res[i+offset1] += alpha*tmp1; res[i+2] += alpha*tmp2; res[i+offset3] += alpha*tmp3;
   }
 
   // process remaining first and last rows (at most columnsAtOnce-1)
@@ -739,7 +802,7 @@ static EIGEN_DONT_INLINE void ei_cache_friendly_product_rowmajor_times_vector(
       // FIXME this loop get vectorized by the compiler !
       for (int j=alignedSize; j<size; ++j)
         tmp0 += rhs[j] * lhs0[j];
-      res[i] += tmp0;
+      res[i] += alpha*tmp0;
     }
     if (skipRows)
     {
@@ -754,4 +817,186 @@ static EIGEN_DONT_INLINE void ei_cache_friendly_product_rowmajor_times_vector(
   #undef _EIGEN_ACCUMULATE_PACKETS
 }
 
+#ifndef EIGEN_EXTERN_INSTANTIATIONS
+
+/* BLAS-like matrix product: res = alpha * op(lhs) * op(rhs) + beta * res, where op() is the
+ * identity or the complex conjugation, and the storage order of each operand plays the role of
+ * the transposition flag. The operands are read in place whatever their storage order, and
+ * when beta is zero the initial content of res is ignored.
+ */
+template<typename Scalar>
+static void ei_cache_friendly_product(
+  int _rows, int _cols, int depth,
+  bool _lhsRowMajor, bool _conjLhs, const Scalar* _lhs, int _lhsStride,
+  bool _rhsRowMajor, bool _conjRhs, const Scalar* _rhs, int _rhsStride,
+  bool resRowMajor, Scalar* res, int resStride, Scalar alpha, Scalar beta)
+{
+  if (beta!=Scalar(1))
+  {
+    const int outerSize = resRowMajor ? _rows : _cols, innerSize = resRowMajor ? _cols : _rows;
+    for (int j=0; j<outerSize; ++j)
+      for (int i=0; i<innerSize; ++i)
+        res[i+j*resStride] = beta==Scalar(0) ? Scalar(0) : beta * res[i+j*resStride];
+  }
+  // the kernel packs a block of MaxL2BlockSize rows of the lhs over the whole depth, so a long inner
+  // dimension is processed per slice to keep that block small enough for the stack of any thread
+  typedef ei_product_blocking_traits<Scalar> Blocking;
+  const int sliceDepth = std::max<int>(Blocking::MaxL2BlockSize,
+    int(EIGEN_PRODUCT_MAX_PACKED_LHS_SIZE / (sizeof(Scalar)*Blocking::MaxL2BlockSize))
+      / Blocking::MaxL2BlockSize * Blocking::MaxL2BlockSize);
+  for (int k=0; k<depth; k+=sliceDepth)
+    ei_cache_friendly_product_kernel<Scalar>(_rows, _cols, std::min(sliceDepth, depth-k),
+      _lhsRowMajor, _conjLhs, _lhs + (_lhsRowMajor ? k : k*_lhsStride), _lhsStride,
+      _rhsRowMajor, _conjRhs, _rhs + (_rhsRowMajor ? k*_rhsStride : k), _rhsStride,
+      resRowMajor, res, resStride, alpha, static_cast<const Scalar*>(0));
+}
+
+/* Packs alpha * op(lhs), a rows x depth matrix, once and for all in the layout read by the matrix * matrix
+ * kernel: the row blocks of the kernel one after the other, followed by the columns beyond the last
+ * multiple of the packet size stored in column major order. \a packed must hold rows*depth aligned scalars.
+ */
+template<typename Scalar>
+static void ei_cache_friendly_pack_lhs(int rows, int depth,
+  bool lhsRowMajor, bool conjLhs, const Scalar* lhs, int lhsStride, Scalar alpha, Scalar* packed)
+{
+  typedef ei_product_blocking_traits<Scalar> Blocking;
+  const int size = depth - depth % Blocking::PacketSize;
+  const int l2BlockRows = Blocking::MaxL2BlockSize > rows ? rows : Blocking::MaxL2BlockSize;
+  for(int l2i=0; l2i<rows; l2i+=l2BlockRows)
+    ei_cache_friendly_pack_lhs_block(l2i, std::min(l2i+l2BlockRows, rows), size,
+                                     lhsRowMajor, conjLhs, lhs, lhsStride, alpha, packed + l2i*size);
+  for(int k=size; k<depth; ++k)
+    for(int i=0; i<rows; ++i)
+      packed[i+k*rows] = alpha * ei_conj_if(conjLhs, lhsRowMajor ? lhs[i*lhsStride+k] : lhs[i+k*lhsStride]);
+}
+
+/* Same as ei_cache_friendly_product with a lhs packed by ei_cache_friendly_pack_lhs, a column major
+ * result and beta==1: res += alpha * packedLhs * op(rhs). The packing cost is thus paid once for
+ * all the products sharing the same lhs.
+ */
+template<typename Scalar>
+static void ei_cache_friendly_product_packed(
+  int rows, int cols, int depth, const Scalar* packedLhs,
+  bool rhsRowMajor, bool conjRhs, const Scalar* rhs, int rhsStride,
+  Scalar* res, int resStride, Scalar alpha)
+{
+  ei_cache_friendly_product_kernel<Scalar>(rows, cols, depth, false, false, packedLhs, rows,
+    rhsRowMajor, conjRhs, rhs, rhsStride, false, res, resStride, alpha, packedLhs);
+}
+
+#endif // EIGEN_EXTERN_INSTANTIATIONS
+
+/* Triangular matrix * matrix product: res += alpha * op(triAlpha * tri) * op(rhs), where tri is a size x size
+ * triangular matrix described by \a mode, a combination of UpperTriangularBit or LowerTriangularBit
+ * with optionally UnitDiagBit or ZeroDiagBit. The opposite half of tri is never read, nor is its
+ * diagonal when it is implicit, and \a triAlpha only scales the coefficients which are read.
+ * The product is performed per panel of rows: the part of a panel which is off the diagonal is
+ * a plain matrix product, while the small triangular block on the diagonal is copied with
+ * explicit zeros, so that the zero half of tri costs only the flops of these blocks.
+ */
+template<typename Scalar>
+static void ei_cache_friendly_triangular_product(int mode, int size, int cols,
+  bool triRowMajor, bool conjTri, const Scalar* tri, int triStride,
+  bool rhsRowMajor, bool conjRhs, const Scalar* rhs, int rhsStride,
+  bool resRowMajor, Scalar* res, int resStride, Scalar alpha, Scalar triAlpha)
+{
+  const bool upper = mode & UpperTriangularBit;
+  const int blockSize = std::min<int>(size, ei_product_blocking_traits<Scalar>::MaxBlockRows * 8);
+  Scalar* diagBlock = ei_aligned_stack_new(Scalar, blockSize*blockSize);
+
+  for(int k0=0; k0<size; k0+=blockSize)
+  {
+    const int k1 = std::min(k0+blockSize, size);
+    const int bs = k1-k0;
+    Scalar* resPanel = res + (resRowMajor ? k0*resStride : k0);
+
+    // the diagonal block, with the implicit coefficients made explicit
+    for(int j=0; j<bs; ++j)
+      for(int i=0; i<bs; ++i)
+      {
+        const Scalar& coeff = tri[triRowMajor ? (k0+i)*triStride+k0+j : k0+i+(k0+j)*triStride];
+        if (i==j)
+          diagBlock[i+j*bs] = (mode&UnitDiagBit) ? Scalar(1) : (mode&ZeroDiagBit) ? Scalar(0) : triAlpha * ei_conj_if(conjTri, coeff);
+        else
+          diagBlock[i+j*bs] = (i<j)==upper ? triAlpha * ei_conj_if(conjTri, coeff) : Scalar(0);
+      }
+    ei_cache_friendly_product<Scalar>(bs, cols, bs,
+      false, false, diagBlock, bs,
+      rhsRowMajor, conjRhs, rhs + (rhsRowMajor ? k0*rhsStride : k0), rhsStride,
+      resRowMajor, resPanel, resStride, alpha, Scalar(1));
+
+    // the rest of the panel, on the non zero side of the diagonal block
+    const int start = upper ? k1 : 0;
+    const int depth = upper ? size-k1 : k0;
+    if (depth>0)
+      ei_cache_friendly_product<Scalar>(bs, cols, depth,
+        triRowMajor, conjTri, tri + (triRowMajor ? k0*triStride+start : k0+start*triStride), triStride,
+        rhsRowMajor, conjRhs, rhs + (rhsRowMajor ? start*rhsStride : start), rhsStride,
+        resRowMajor, resPanel, resStride, alpha * triAlpha, Scalar(1));
+  }
+
+  ei_aligned_stack_delete(Scalar, diagBlock, blockSize*blockSize);
+}
+
+/* All the entry points accumulate \a alpha times the product into the destination,
+ * so that scaled products do not need an intermediate scaled copy of an operand.
+ *
+ * The two matrix * vector entry points below accept a vector with an arbitrary
+ * inner increment: \a resIncr (resp. \a rhsIncr) is the distance between two
+ * consecutive coefficients of the result (resp. of the rhs). The kernels require
+ * unit increments but handle unaligned heads by themselves, so a contiguous vector
+ * is always processed in place, while a strided one is streamed through a small
+ * aligned buffer that stays in the L1 cache.
+ */
+enum { ei_product_vector_buffer_bytes = 2048 };
+
+template<typename Scalar, typename RhsType>
+static void ei_cache_friendly_product_colmajor_times_vector(
+  int size,
+  const Scalar* lhs, int lhsStride,
+  const RhsType& rhs,
+  Scalar* res, int resIncr, Scalar alpha)
+{
+  if(resIncr==1)
+  {
+    ei_cache_friendly_product_colmajor_times_vector_kernel(size, lhs, lhsStride, rhs, res, alpha);
+    return;
+  }
+
+  enum { BufferSize = ei_product_vector_buffer_bytes/sizeof(Scalar) };
+  EIGEN_ALIGN_128 Scalar buffer[BufferSize];
+  for(int j=0; j<size; j+=BufferSize)
+  {
+    const int n = std::min<int>(BufferSize, size-j);
+    for(int k=0; k<n; ++k)
+      buffer[k] = Scalar(0);
+    ei_cache_friendly_product_colmajor_times_vector(n, lhs+j, lhsStride, rhs, buffer, 1, alpha);
+    for(int k=0; k<n; ++k)
+      res[(j+k)*resIncr] += buffer[k];
+  }
+}
+
+template<typename Scalar, typename ResType>
+static void ei_cache_friendly_product_rowmajor_times_vector(
+  const Scalar* lhs, int lhsStride,
+  const Scalar* rhs, int rhsSize,
+  ResType& res, int rhsIncr, Scalar alpha)
+{
+  if(rhsIncr==1)
+  {
+    ei_cache_friendly_product_rowmajor_times_vector_kernel(lhs, lhsStride, rhs, rhsSize, res, alpha);
+    return;
+  }
+
+  enum { BufferSize = ei_product_vector_buffer_bytes/sizeof(Scalar) };
+  EIGEN_ALIGN_128 Scalar buffer[BufferSize];
+  for(int j=0; j<rhsSize; j+=BufferSize)
+  {
+    const int n = std::min<int>(BufferSize, rhsSize-j);
+    for(int k=0; k<n; ++k)
+      buffer[k] = rhs[(j+k)*rhsIncr];
+    ei_cache_friendly_product_rowmajor_times_vector(lhs+j, lhsStride, buffer, n, res, 1, alpha);
+  }
+}
+
 #endif // EIGEN_CACHE_FRIENDLY_PRODUCT_H
@@ -34,9 +34,15 @@ namespace Eigen
 #define EIGEN_INSTANTIATE_PRODUCT(TYPE) \
 template static void ei_cache_friendly_product<TYPE>( \
   int _rows, int _cols, int depth, \
-  bool _lhsRowMajor, const TYPE* _lhs, int _lhsStride, \
-  bool _rhsRowMajor, const TYPE* _rhs, int _rhsStride, \
-  bool resRowMajor, TYPE* res, int resStride)
+  bool _lhsRowMajor, bool _conjLhs, const TYPE* _lhs, int _lhsStride, \
+  bool _rhsRowMajor, bool _conjRhs, const TYPE* _rhs, int _rhsStride, \
+  bool resRowMajor, TYPE* res, int resStride, TYPE alpha, TYPE beta); \
+template static void ei_cache_friendly_pack_lhs<TYPE>(int rows, int depth, \
+  bool lhsRowMajor, bool conjLhs, const TYPE* lhs, int lhsStride, TYPE alpha, TYPE* packed); \
+template static void ei_cache_friendly_product_packed<TYPE>( \
+  int rows, int cols, int depth, const TYPE* packedLhs, \
+  bool rhsRowMajor, bool conjRhs, const TYPE* rhs, int rhsStride, \
+  TYPE* res, int resStride, TYPE alpha)
 
 EIGEN_INSTANTIATE_PRODUCT(float);
 EIGEN_INSTANTIATE_PRODUCT(double);
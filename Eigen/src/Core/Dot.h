@@ -110,7 +110,7 @@ struct ei_dot_vec_unroller
   {
     return ei_pmadd(
       v1.template packet<Aligned>(row1, col1),
-      v2.template packet<Aligned>(row2, col2),
+      ei_pconj(v2.template packet<Aligned>(row2, col2)),
       ei_dot_vec_unroller<Derived1, Derived2, Index+ei_packet_traits<Scalar>::size, Stop>::run(v1, v2)
     );
   }
@@ -133,17 +133,43 @@ struct ei_dot_vec_unroller<Derived1, Derived2, Index, Stop, true>
 
   inline static PacketScalar run(const Derived1& v1, const Derived2& v2)
   {
-    return ei_pmul(v1.template packet<alignment1>(row1, col1), v2.template packet<alignment2>(row2, col2));
+    return ei_pmul(v1.template packet<alignment1>(row1, col1), ei_pconj(v2.template packet<alignment2>(row2, col2)));
   }
 };
 
+/*** evaluator for the dynamic-size paths ***/
+
+// Conj==false gives the plain (bilinear) inner product used by the products
+template<typename Derived1, typename Derived2, int LoadMode1 = Unaligned, int LoadMode2 = Unaligned, bool Conj = true>
+struct ei_dot_evaluator
+{
+  typedef typename Derived1::Scalar Scalar;
+  typedef typename ei_packet_traits<Scalar>::type PacketScalar;
+  enum { Flags = Derived1::Flags | Derived2::Flags };
+
+  ei_dot_evaluator(const Derived1& v1, const Derived2& v2) : m_v1(v1), m_v2(v2) {}
+
+  EIGEN_STRONG_INLINE Scalar coeff(int index) const
+  { return m_v1.coeff(index) * (Conj ? ei_conj(m_v2.coeff(index)) : m_v2.coeff(index)); }
+
+  EIGEN_STRONG_INLINE PacketScalar packet(int index) const
+  {
+    PacketScalar b = m_v2.template packet<LoadMode2>(index);
+    return ei_pmul(m_v1.template packet<LoadMode1>(index), Conj ? ei_pconj(b) : b);
+  }
+
+  const Derived1& m_v1;
+  const Derived2& m_v2;
+};
+
 /***************************************************************************
 * Part 3 : implementation of all cases
 ***************************************************************************/
 
 template<typename Derived1, typename Derived2,
          int Vectorization = ei_dot_traits<Derived1, Derived2>::Vectorization,
-         int Unrolling = ei_dot_traits<Derived1, Derived2>::Unrolling
+         int Unrolling = ei_dot_traits<Derived1, Derived2>::Unrolling,
+         bool Conj = true
 >
 struct ei_dot_impl;
 
@@ -154,11 +180,9 @@ struct ei_dot_impl<Derived1, Derived2, NoVectorization, NoUnrolling>
   static Scalar run(const Derived1& v1, const Derived2& v2)
   {
     ei_assert(v1.size()>0 && "you are using a non initialized vector");
-    Scalar res;
-    res = v1.coeff(0) * ei_conj(v2.coeff(0));
-    for(int i = 1; i < v1.size(); ++i)
-      res += v1.coeff(i) * ei_conj(v2.coeff(i));
-    return res;
+    typedef ei_dot_evaluator<Derived1, Derived2> Evaluator;
+    return ei_redux_linear_impl<ei_scalar_sum_op<Scalar>, Evaluator, false>
+             ::run(Evaluator(v1, v2), ei_scalar_sum_op<Scalar>(), v1.size());
   }
 };
 
@@ -167,56 +191,22 @@ struct ei_dot_impl<Derived1, Derived2, NoVectorization, CompleteUnrolling>
   : public ei_dot_novec_unroller<Derived1, Derived2, 0, Derived1::SizeAtCompileTime>
 {};
 
-template<typename Derived1, typename Derived2>
-struct ei_dot_impl<Derived1, Derived2, LinearVectorization, NoUnrolling>
+template<typename Derived1, typename Derived2, bool Conj>
+struct ei_dot_impl<Derived1, Derived2, LinearVectorization, NoUnrolling, Conj>
 {
   typedef typename Derived1::Scalar Scalar;
-  typedef typename ei_packet_traits<Scalar>::type PacketScalar;
+  enum {
+    alignment1 = (Derived1::Flags & AlignedBit) ? Aligned : Unaligned,
+    alignment2 = (Derived2::Flags & AlignedBit) ? Aligned : Unaligned
+  };
 
   static Scalar run(const Derived1& v1, const Derived2& v2)
   {
-    const int size = v1.size();
-    const int packetSize = ei_packet_traits<Scalar>::size;
-    const int alignedSize = (size/packetSize)*packetSize;
-    enum {
-      alignment1 = (Derived1::Flags & AlignedBit) ? Aligned : Unaligned,
-      alignment2 = (Derived2::Flags & AlignedBit) ? Aligned : Unaligned
-    };
-    Scalar res;
-
-    // do the vectorizable part of the sum
-    if(size >= packetSize)
-    {
-      PacketScalar packet_res = ei_pmul(
-                                  v1.template packet<alignment1>(0),
-                                  v2.template packet<alignment2>(0)
-                                );
-      for(int index = packetSize; index<alignedSize; index += packetSize)
-      {
-        packet_res = ei_pmadd(
-                       v1.template packet<alignment1>(index),
-                       v2.template packet<alignment2>(index),
-                       packet_res
-                     );
-      }
-      res = ei_predux(packet_res);
-
-      // now we must do the rest without vectorization.
-      if(alignedSize == size) return res;
-    }
-    else // too small to vectorize anything.
-         // since this is dynamic-size hence inefficient anyway for such small sizes, don't try to optimize.
-    {
-      res = Scalar(0);
-    }
-
-    // do the remainder of the vector
-    for(int index = alignedSize; index < size; ++index)
-    {
-      res += v1.coeff(index) * v2.coeff(index);
-    }
-
-    return res;
+    if(v1.size()==0)
+      return Scalar(0);
+    typedef ei_dot_evaluator<Derived1, Derived2, alignment1, alignment2, Conj> Evaluator;
+    return ei_redux_linear_impl<ei_scalar_sum_op<Scalar>, Evaluator, true>
+             ::run(Evaluator(v1, v2), ei_scalar_sum_op<Scalar>(), v1.size());
   }
 };
 
@@ -54,6 +54,10 @@ template<typename Packet> inline Packet
 ei_pdiv(const Packet& a,
         const Packet& b) { return a/b; }
 
+/** \internal \returns conj(a) (coeff-wise) */
+template<typename Packet> inline Packet
+ei_pconj(const Packet& a) { return ei_conj(a); }
+
 /** \internal \returns the min of \a a and \a b  (coeff-wise) */
 template<typename Packet> inline Packet
 ei_pmin(const Packet& a,
@@ -84,6 +88,16 @@ template<typename Scalar, typename Packet> inline void ei_pstore(Scalar* to, con
 template<typename Scalar, typename Packet> inline void ei_pstoreu(Scalar* to, const Packet& from)
 { (*to) = from; }
 
+/** \internal copy the packet \a from to \a *to using a non-temporal store, i.e., without bringing
+  * the destination into the caches when the architecture supports it. \a to must be 16 bytes aligned.
+  * \sa ei_pstream_fence() */
+template<typename Scalar, typename Packet> inline void ei_pstream(Scalar* to, const Packet& from)
+{ ei_pstore(to, from); }
+
+/** \internal makes all the previous ei_pstream() of the calling thread globally visible
+  * before any subsequent store */
+template<typename Packet> inline void ei_pstream_fence() {}
+
 /** \internal \returns the first element of a packet */
 template<typename Packet> inline typename ei_unpacket_traits<Packet>::type ei_pfirst(const Packet& a)
 { return a; }
@@ -120,12 +134,14 @@ inline typename ei_packet_traits<Scalar>::type ei_ploadt(const Scalar* from)
 }
 
 /** \internal copy the packet \a from to \a *to.
-  * If StoreMode equals Aligned, \a to must be 16 bytes aligned */
+  * If StoreMode equals Aligned or Streaming, \a to must be 16 bytes aligned */
 template<typename Scalar, typename Packet, int LoadMode>
 inline void ei_pstoret(Scalar* to, const Packet& from)
 {
   if(LoadMode == Aligned)
     ei_pstore(to, from);
+  else if(LoadMode == Streaming)
+    ei_pstream(to, from);
   else
     ei_pstoreu(to, from);
 }
@@ -274,6 +274,21 @@ class Matrix
       return _set(other);
     }
 
+#ifdef EIGEN_HAVE_RVALUE_REFERENCES
+    /** Move assignment: for dynamic-size matrices, the coefficients of \a other are taken
+      * without any copy, and \a other gets the previous coefficients of *this.
+      */
+    EIGEN_STRONG_INLINE Matrix& operator=(Matrix&& other) EIGEN_NOEXCEPT
+    {
+      if (Base::SizeAtCompileTime==Dynamic)
+      {
+        m_storage.swap(other.m_storage);
+        return *this;
+      }
+      return _set(other);
+    }
+#endif
+
     EIGEN_INHERIT_ASSIGNMENT_OPERATOR(Matrix, +=)
     EIGEN_INHERIT_ASSIGNMENT_OPERATOR(Matrix, -=)
     EIGEN_INHERIT_SCALAR_ASSIGNMENT_OPERATOR(Matrix, *=)
@@ -394,6 +409,16 @@ class Matrix
       _check_template_params();
       _set_noalias(other);
     }
+#ifdef EIGEN_HAVE_RVALUE_REFERENCES
+    /** Move constructor: for dynamic-size matrices, the coefficients of \a other are taken
+      * without any copy, and \a other becomes a null matrix.
+      */
+    EIGEN_STRONG_INLINE Matrix(Matrix&& other) EIGEN_NOEXCEPT
+            : Base(), m_storage(std::move(other.m_storage))
+    {
+      _check_template_params();
+    }
+#endif
     /** Destructor */
     inline ~Matrix() {}
 
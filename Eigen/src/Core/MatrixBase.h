@@ -237,6 +237,9 @@ template<typename Derived> class MatrixBase
       return this->operator=<Derived>(other);
     }
 
+    template<typename OtherDerived>
+    Derived& streamingAssign(const MatrixBase<OtherDerived>& other);
+
 #ifndef EIGEN_PARSED_BY_DOXYGEN
     /** Copies \a other into *this without evaluating other. \returns a reference to *this. */
     template<typename OtherDerived>
@@ -506,6 +509,7 @@ template<typename Derived> class MatrixBase
     template<unsigned int Added>
     const Flagged<Derived, Added, 0> marked() const;
     const Flagged<Derived, 0, EvalBeforeNestingBit | EvalBeforeAssigningBit> lazy() const;
+    NoAlias<Derived> noalias();
 
     /** \returns number of elements to skip to pass from one row (resp. column) to another
       * for a row-major (resp. column-major) matrix.
@@ -588,6 +592,7 @@ template<typename Derived> class MatrixBase
 /////////// LU module ///////////
 
     const LU<PlainMatrixType> lu() const;
+    const PartialPivLU<PlainMatrixType> partialPivLu() const;
     const PlainMatrixType inverse() const;
     void computeInverse(PlainMatrixType *result) const;
     Scalar determinant() const;
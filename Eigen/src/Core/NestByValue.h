@@ -98,6 +98,9 @@ template<typename ExpressionType> class NestByValue
       m_expression.const_cast_derived().template writePacket<LoadMode>(index, x);
     }
 
+    /** \internal used for introspection */
+    const ExpressionType& _expression() const { return m_expression; }
+
   protected:
     const ExpressionType m_expression;
 };
@@ -0,0 +1,116 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra. Eigen itself is part of the KDE project.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_NOALIAS_H
+#define EIGEN_NOALIAS_H
+
+/** \class NoAlias
+  *
+  * \brief Pseudo expression providing assignment operators which assume no aliasing
+  *
+  * \param ExpressionType the type of the object on which to do the assignment
+  *
+  * This class wraps the destination of an assignment and provides the operators =, += and -=
+  * assuming that the destination does not alias the source expression. In other words, they
+  * bypass the EvalBeforeAssigningBit of the source expression. For a cache friendly matrix
+  * product, the product is accumulated by the kernels straight into the destination, and
+  * the scalar factors of its operands are folded into the kernels:
+  * \code
+  * C.noalias() -= (2*A) * B;  // no temporary, no scaled copy of A
+  * \endcode
+  * Note that a factor applied to the product itself, as in \c 2*(A*B), forces the evaluation
+  * of the product and therefore should be applied to one of its operands instead.
+  *
+  * It is the return type of MatrixBase::noalias() and most of the time this is the only way it is used.
+  *
+  * \sa MatrixBase::noalias(), MatrixBase::lazy()
+  */
+template<typename ExpressionType>
+class NoAlias
+{
+  public:
+    typedef typename ExpressionType::Scalar Scalar;
+
+    NoAlias(ExpressionType& expression) : m_expression(expression) {}
+
+    /** Behaves like MatrixBase::operator=(other.lazy()), in particular the destination is
+      * resized if needed. */
+    template<typename OtherDerived>
+    EIGEN_STRONG_INLINE ExpressionType& operator=(const MatrixBase<OtherDerived>& other)
+    { return m_expression = other.lazy(); }
+
+    template<typename OtherDerived>
+    EIGEN_STRONG_INLINE ExpressionType& operator+=(const MatrixBase<OtherDerived>& other)
+    { return m_expression += other; }
+
+    template<typename OtherDerived>
+    EIGEN_STRONG_INLINE ExpressionType& operator-=(const MatrixBase<OtherDerived>& other)
+    { return m_expression -= other; }
+
+#ifndef EIGEN_PARSED_BY_DOXYGEN
+    template<typename Lhs, typename Rhs>
+    EIGEN_STRONG_INLINE ExpressionType& operator+=(const Product<Lhs,Rhs,CacheFriendlyProduct>& other)
+    { return _addProduct(other, Scalar(1)); }
+
+    template<typename Lhs, typename Rhs>
+    EIGEN_STRONG_INLINE ExpressionType& operator-=(const Product<Lhs,Rhs,CacheFriendlyProduct>& other)
+    { return _addProduct(other, Scalar(-1)); }
+#endif
+
+  protected:
+
+    template<typename ProductType>
+    ExpressionType& _addProduct(const ProductType& product, const Scalar& alpha)
+    {
+      if (product._useCacheFriendlyProduct())
+        ei_cache_friendly_product_selector<ProductType>::run(m_expression, product, alpha);
+      else
+        m_expression.lazyAssign(m_expression + alpha * product.lazy());
+      return m_expression;
+    }
+
+    ExpressionType& m_expression;
+
+  private:
+    NoAlias& operator=(const NoAlias&);
+};
+
+/** \returns a pseudo expression of \c *this with assignment operators assuming no aliasing
+  * between \c *this and the source expression.
+  *
+  * More precisely, noalias() allows to bypass the EvalBeforeAssigningBit flag. For a matrix
+  * product \c C.noalias() \c = \c A*B, \c C.noalias() \c += \c A*B and \c C.noalias() \c -= \c A*B,
+  * the product is computed directly into \c C without any temporary.
+  *
+  * \warning It is the responsibility of the user to make sure that \c *this is not
+  * referenced by the right hand side. For instance \c A.noalias() \c = \c A*B leads to
+  * wrong results.
+  *
+  * \sa class NoAlias, lazy()
+  */
+template<typename Derived>
+NoAlias<Derived> MatrixBase<Derived>::noalias()
+{
+  return derived();
+}
+
+#endif // EIGEN_NOALIAS_H
@@ -0,0 +1,157 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra. Eigen itself is part of the KDE project.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_PACKEDMATRIX_H
+#define EIGEN_PACKEDMATRIX_H
+
+/** \class PackedMatrix
+  *
+  * \brief Copy of a matrix stored in the internal layout of the matrix product kernel
+  *
+  * \param MatrixType the type of the matrix which is packed
+  *
+  * Before computing a large matrix product, the cache friendly kernel copies its left hand side
+  * block per block in a layout suited to its inner loops. This class performs that copy once
+  * and for all, so that the same left hand side can be multiplied by many right hand sides
+  * without paying the packing cost again:
+  * \code
+  * PackedMatrix<MatrixXf> packedWeights(weights);
+  * for(int i=0; i<n; ++i)
+  * {
+  *   outputs[i].setZero();
+  *   packedWeights.addProductTo(inputs[i], outputs[i]);  // outputs[i] += weights * inputs[i]
+  * }
+  * \endcode
+  * The scalar factor and the conjugation of the packed expression are folded into the packed
+  * data, e.g., \c PackedMatrix<MatrixXf>(2*weights) costs the same as packing \c weights alone.
+  *
+  * The packed layout depends on the blocking of the kernel, it is therefore specific to the
+  * scalar type, to the cache size the library is tuned for and to the target architecture.
+  * Packing only pays off for products which are large enough to use the cache friendly kernel.
+  *
+  * \sa MatrixBase::noalias()
+  */
+template<typename MatrixType> class PackedMatrix
+{
+  public:
+    typedef typename MatrixType::Scalar Scalar;
+    typedef Matrix<Scalar, Dynamic, 1> PackedVectorType;
+
+    /** Default constructor without any packed data, compute() must be called before any product. */
+    PackedMatrix() : m_rows(0), m_cols(0) {}
+
+    /** Packs \a matrix, see compute(). */
+    template<typename OtherDerived>
+    PackedMatrix(const MatrixBase<OtherDerived>& matrix)
+    {
+      compute(matrix);
+    }
+
+    /** Packs \a matrix, replacing any previously packed data. */
+    template<typename OtherDerived>
+    void compute(const MatrixBase<OtherDerived>& matrix);
+
+    /** \returns the number of rows of the packed matrix */
+    inline int rows() const { return m_rows; }
+    /** \returns the number of columns of the packed matrix */
+    inline int cols() const { return m_cols; }
+
+    /** Accumulates \a alpha times the product of the packed matrix by \a rhs into \a dst,
+      * i.e., \a dst \c += \a alpha \c * \c *this \c * \a rhs, without any temporary when \a dst is a
+      * column major matrix with direct access. As with noalias(), \a dst must not alias \a rhs.
+      */
+    template<typename RhsDerived, typename DestDerived>
+    void addProductTo(const MatrixBase<RhsDerived>& rhs, MatrixBase<DestDerived>& dst,
+                      const Scalar& alpha = Scalar(1)) const;
+
+    /** \returns the product of the packed matrix by \a rhs */
+    template<typename RhsDerived>
+    inline const Matrix<Scalar, MatrixType::RowsAtCompileTime, RhsDerived::ColsAtCompileTime>
+    operator*(const MatrixBase<RhsDerived>& rhs) const
+    {
+      Matrix<Scalar, MatrixType::RowsAtCompileTime, RhsDerived::ColsAtCompileTime> res
+        = Matrix<Scalar, MatrixType::RowsAtCompileTime, RhsDerived::ColsAtCompileTime>::Zero(rows(), rhs.cols());
+      addProductTo(rhs, res);
+      return res;
+    }
+
+  protected:
+    template<typename RhsDerived, typename DestDerived>
+    void _addProductTo(const RhsDerived& rhs, DestDerived& dst, const Scalar& alpha) const;
+
+    PackedVectorType m_packed;
+    int m_rows, m_cols;
+};
+
+template<typename MatrixType>
+template<typename OtherDerived>
+void PackedMatrix<MatrixType>::compute(const MatrixBase<OtherDerived>& matrix)
+{
+  typedef ei_blas_traits<OtherDerived> BlasTraits;
+  typedef typename ei_product_copy_lhs<typename BlasTraits::_ExtractType>::type LhsCopy;
+  typedef typename ei_unref<LhsCopy>::type _LhsCopy;
+  LhsCopy lhs(BlasTraits::extract(matrix.derived()));
+  m_rows = lhs.rows();
+  m_cols = lhs.cols();
+  m_packed.resize(m_rows*m_cols);
+  ei_cache_friendly_pack_lhs<Scalar>(m_rows, m_cols,
+    _LhsCopy::Flags&RowMajorBit, BlasTraits::NeedToConjugate,
+    (const Scalar*)&(lhs.const_cast_derived().coeffRef(0,0)), lhs.stride(),
+    BlasTraits::extractScalarFactor(matrix.derived()), m_packed.data());
+}
+
+template<typename MatrixType>
+template<typename RhsDerived, typename DestDerived>
+void PackedMatrix<MatrixType>::addProductTo(const MatrixBase<RhsDerived>& rhs, MatrixBase<DestDerived>& dst,
+                                            const Scalar& alpha) const
+{
+  ei_assert(rhs.rows()==cols() && dst.rows()==rows() && dst.cols()==rhs.cols()
+    && "invalid matrix product" && "if you wanted a coeff-wise or a dot product use the respective explicit functions");
+  if (m_rows==0 || m_cols==0 || rhs.cols()==0)
+    return;
+  if ((int(ei_traits<DestDerived>::Flags)&DirectAccessBit) && !(int(ei_traits<DestDerived>::Flags)&RowMajorBit))
+    _addProductTo(rhs.derived(), dst.derived(), alpha);
+  else
+  {
+    // the kernel writes a column major result
+    typename ei_plain_matrix_type_column_major<DestDerived>::type res
+      = ei_plain_matrix_type_column_major<DestDerived>::type::Zero(dst.rows(), dst.cols());
+    _addProductTo(rhs.derived(), res, alpha);
+    dst += res;
+  }
+}
+
+template<typename MatrixType>
+template<typename RhsDerived, typename DestDerived>
+void PackedMatrix<MatrixType>::_addProductTo(const RhsDerived& rhs, DestDerived& dst, const Scalar& alpha) const
+{
+  typedef ei_blas_traits<RhsDerived> BlasTraits;
+  typedef typename ei_product_copy_rhs<typename BlasTraits::_ExtractType>::type RhsCopy;
+  typedef typename ei_unref<RhsCopy>::type _RhsCopy;
+  RhsCopy rhsCopy(BlasTraits::extract(rhs));
+  ei_cache_friendly_product_packed<Scalar>(m_rows, rhsCopy.cols(), m_cols, m_packed.data(),
+    _RhsCopy::Flags&RowMajorBit, BlasTraits::NeedToConjugate,
+    (const Scalar*)&(rhsCopy.const_cast_derived().coeffRef(0,0)), rhsCopy.stride(),
+    (Scalar*)&(dst.coeffRef(0,0)), dst.stride(), alpha * BlasTraits::extractScalarFactor(rhs));
+}
+
+#endif // EIGEN_PACKEDMATRIX_H
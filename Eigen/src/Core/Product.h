@@ -36,6 +36,123 @@ struct ei_product_coeff_impl;
 template<int StorageOrder, int Index, typename Lhs, typename Rhs, typename PacketScalar, int LoadMode>
 struct ei_product_packet_impl;
 
+/** \internal
+  * \class ei_blas_traits
+  *
+  * Strips the scalar factors, the transpositions and the conjugations off an operand of a cache
+  * friendly product, so that the kernels can work on the underlying coefficients and apply these
+  * operations themselves. extract() returns the stripped expression as an \c ExtractType, which
+  * is either a reference or a lightweight expression (\c _ExtractType is the type without reference),
+  * extractScalarFactor() returns the product of the stripped factors and \c NeedToConjugate tells
+  * whether the coefficients of the stripped expression have to be conjugated.
+  * \c HasDirectAccess tells whether the stripped expression can be handed to the kernels as is.
+  */
+template<typename XprType> struct ei_blas_traits
+{
+  typedef typename ei_traits<XprType>::Scalar Scalar;
+  typedef const XprType& ExtractType;
+  typedef XprType _ExtractType;
+  enum {
+    IsTransformed = 0,
+    NeedToConjugate = 0,
+    HasDirectAccess = (int(ei_traits<XprType>::Flags)&DirectAccessBit) ? 1 : 0
+  };
+  static inline ExtractType extract(const XprType& x) { return x; }
+  static inline Scalar extractScalarFactor(const XprType&) { return Scalar(1); }
+};
+
+// common part of the specializations for the expressions wrapping a single expression of type
+// NestedXpr, StoresPlainMatrix tells whether the wrapper stores an evaluated copy of it
+template<typename XprType, typename NestedXpr, bool StoresPlainMatrix> struct ei_blas_traits_wrapper
+ : ei_blas_traits<NestedXpr>
+{
+  typedef ei_blas_traits<NestedXpr> Base;
+  typedef typename Base::Scalar Scalar;
+  typedef typename Base::ExtractType ExtractType;
+  enum {
+    IsTransformed = 1,
+    // an operand storing an evaluated copy is not worth nesting by value
+    HasDirectAccess = Base::HasDirectAccess && !StoresPlainMatrix
+  };
+  static inline ExtractType extract(const XprType& x) { return Base::extract(x._expression()); }
+  static inline Scalar extractScalarFactor(const XprType& x) { return Base::extractScalarFactor(x._expression()); }
+};
+
+template<typename UnaryOp, typename NestedXpr> struct ei_blas_traits_unary
+ : ei_blas_traits_wrapper<CwiseUnaryOp<UnaryOp, NestedXpr>,
+                          typename ei_cleantype<typename NestedXpr::Nested>::type,
+                          ei_is_same_type<typename NestedXpr::Nested, typename ei_plain_matrix_type<NestedXpr>::type>::ret>
+{};
+
+template<typename Scalar, typename NestedXpr>
+struct ei_blas_traits<CwiseUnaryOp<ei_scalar_multiple_op<Scalar>, NestedXpr> >
+ : ei_blas_traits_unary<ei_scalar_multiple_op<Scalar>, NestedXpr>
+{
+  typedef ei_blas_traits_unary<ei_scalar_multiple_op<Scalar>, NestedXpr> Unary;
+  static inline Scalar extractScalarFactor(const CwiseUnaryOp<ei_scalar_multiple_op<Scalar>, NestedXpr>& x)
+  { return x._functor().m_other * Unary::Base::extractScalarFactor(x._expression()); }
+};
+
+template<typename Scalar, typename NestedXpr>
+struct ei_blas_traits<CwiseUnaryOp<ei_scalar_opposite_op<Scalar>, NestedXpr> >
+ : ei_blas_traits_unary<ei_scalar_opposite_op<Scalar>, NestedXpr>
+{
+  typedef ei_blas_traits_unary<ei_scalar_opposite_op<Scalar>, NestedXpr> Unary;
+  static inline Scalar extractScalarFactor(const CwiseUnaryOp<ei_scalar_opposite_op<Scalar>, NestedXpr>& x)
+  { return -Unary::Base::extractScalarFactor(x._expression()); }
+};
+
+template<typename Scalar, typename NestedXpr>
+struct ei_blas_traits<CwiseUnaryOp<ei_scalar_conjugate_op<Scalar>, NestedXpr> >
+ : ei_blas_traits_unary<ei_scalar_conjugate_op<Scalar>, NestedXpr>
+{
+  typedef ei_blas_traits_unary<ei_scalar_conjugate_op<Scalar>, NestedXpr> Unary;
+  enum { NeedToConjugate = !Unary::Base::NeedToConjugate };
+  static inline Scalar extractScalarFactor(const CwiseUnaryOp<ei_scalar_conjugate_op<Scalar>, NestedXpr>& x)
+  { return ei_conj(Unary::Base::extractScalarFactor(x._expression())); }
+};
+
+template<typename NestedXpr>
+struct ei_blas_traits<NestByValue<NestedXpr> >
+ : ei_blas_traits_wrapper<NestByValue<NestedXpr>, NestedXpr,
+                          ei_is_same_type<NestedXpr, typename ei_plain_matrix_type<NestedXpr>::type>::ret>
+{
+  typedef ei_blas_traits_wrapper<NestByValue<NestedXpr>, NestedXpr,
+                                 ei_is_same_type<NestedXpr, typename ei_plain_matrix_type<NestedXpr>::type>::ret> Wrapper;
+  enum { IsTransformed = Wrapper::Base::IsTransformed };
+};
+
+template<typename NestedXpr>
+struct ei_blas_traits<Transpose<NestedXpr> >
+ : ei_blas_traits_wrapper<Transpose<NestedXpr>,
+                          typename ei_cleantype<typename NestedXpr::Nested>::type,
+                          ei_is_same_type<typename NestedXpr::Nested, typename ei_plain_matrix_type<NestedXpr>::type>::ret>
+{
+  typedef ei_blas_traits_wrapper<Transpose<NestedXpr>,
+                                 typename ei_cleantype<typename NestedXpr::Nested>::type,
+                                 ei_is_same_type<typename NestedXpr::Nested, typename ei_plain_matrix_type<NestedXpr>::type>::ret> Wrapper;
+  typedef typename Wrapper::Base Base;
+  // a stripped expression returned by value has to be nested by value in the transposition
+  typedef typename ei_meta_if<ei_is_same_type<typename Base::ExtractType, typename Base::_ExtractType>::ret,
+                              NestByValue<typename Base::_ExtractType>,
+                              typename Base::_ExtractType>::ret _NestedExtractType;
+  typedef Transpose<_NestedExtractType> ExtractType;
+  typedef ExtractType _ExtractType;
+  enum { IsTransformed = Base::IsTransformed };
+  static inline ExtractType extract(const Transpose<NestedXpr>& x)
+  { return ExtractType(Base::extract(x._expression())); }
+};
+
+/** \internal \returns the nested type of an operand of a cache friendly product:
+  * a transformed operand with direct access is nested by value, so that the scalar factor
+  * and the conjugation can be folded into the kernel instead of evaluating a copy of the operand. */
+template<typename T, int n, typename PlainMatrixType = typename ei_eval<T>::type> struct ei_product_nested
+{
+  typedef typename ei_meta_if<ei_blas_traits<T>::IsTransformed && ei_blas_traits<T>::HasDirectAccess,
+                              T,
+                              typename ei_nested<T,n,PlainMatrixType>::type>::ret type;
+};
+
 /** \class ProductReturnType
   *
   * \brief Helper class to get the correct and optimized returned type of operator*
@@ -66,10 +183,10 @@ struct ProductReturnType
 template<typename Lhs, typename Rhs>
 struct ProductReturnType<Lhs,Rhs,CacheFriendlyProduct>
 {
-  typedef typename ei_nested<Lhs,Rhs::ColsAtCompileTime>::type LhsNested;
+  typedef typename ei_product_nested<Lhs,Rhs::ColsAtCompileTime>::type LhsNested;
 
-  typedef typename ei_nested<Rhs,Lhs::RowsAtCompileTime,
-                             typename ei_plain_matrix_type_column_major<Rhs>::type
+  typedef typename ei_product_nested<Rhs,Lhs::RowsAtCompileTime,
+                                     typename ei_plain_matrix_type_column_major<Rhs>::type
                    >::type RhsNested;
 
   typedef Product<LhsNested, RhsNested, CacheFriendlyProduct> Type;
@@ -149,7 +266,7 @@ struct ei_traits<Product<LhsNested, RhsNested, ProductMode> >
     Flags = ((unsigned int)(LhsFlags | RhsFlags) & HereditaryBits & RemovedBits)
           | EvalBeforeAssigningBit
           | EvalBeforeNestingBit
-          | (CanVectorizeLhs || CanVectorizeRhs ? PacketAccessBit : 0)
+          | ((EvalToRowMajor ? CanVectorizeRhs : CanVectorizeLhs) ? PacketAccessBit : 0)
           | (LhsFlags & RhsFlags & AlignedBit),
 
     CoeffReadCost = InnerSize == Dynamic ? Dynamic
@@ -205,10 +322,10 @@ template<typename LhsNested, typename RhsNested, int ProductMode> class Product
     }
 
     /** \internal
-      * compute \a res += \c *this using the cache friendly product.
+      * compute \a res += \a alpha * \c *this using the cache friendly product.
       */
     template<typename DestDerived>
-    void _cacheFriendlyEvalAndAdd(DestDerived& res) const;
+    void _cacheFriendlyEvalAndAdd(DestDerived& res, const Scalar& alpha) const;
 
     /** \internal
       * \returns whether it is worth it to use the cache friendly product.
@@ -394,7 +511,7 @@ struct ei_product_coeff_vectorized_dyn_selector
     res = ei_dot_impl<
       Block<Lhs, 1, ei_traits<Lhs>::ColsAtCompileTime>,
       Block<Rhs, ei_traits<Rhs>::RowsAtCompileTime, 1>,
-      LinearVectorization, NoUnrolling>::run(lhs.row(row), rhs.col(col));
+      LinearVectorization, NoUnrolling, false>::run(lhs.row(row), rhs.col(col));
   }
 };
 
@@ -408,7 +525,7 @@ struct ei_product_coeff_vectorized_dyn_selector<Lhs,Rhs,1,RhsCols>
     res = ei_dot_impl<
       Lhs,
       Block<Rhs, ei_traits<Rhs>::RowsAtCompileTime, 1>,
-      LinearVectorization, NoUnrolling>::run(lhs, rhs.col(col));
+      LinearVectorization, NoUnrolling, false>::run(lhs, rhs.col(col));
   }
 };
 
@@ -420,7 +537,7 @@ struct ei_product_coeff_vectorized_dyn_selector<Lhs,Rhs,LhsRows,1>
     res = ei_dot_impl<
       Block<Lhs, 1, ei_traits<Lhs>::ColsAtCompileTime>,
       Rhs,
-      LinearVectorization, NoUnrolling>::run(lhs.row(row), rhs);
+      LinearVectorization, NoUnrolling, false>::run(lhs.row(row), rhs);
   }
 };
 
@@ -432,7 +549,7 @@ struct ei_product_coeff_vectorized_dyn_selector<Lhs,Rhs,1,1>
     res = ei_dot_impl<
       Lhs,
       Rhs,
-      LinearVectorization, NoUnrolling>::run(lhs, rhs);
+      LinearVectorization, NoUnrolling, false>::run(lhs, rhs);
   }
 };
 
@@ -517,25 +634,157 @@ struct ei_product_packet_impl<ColMajor, Dynamic, Lhs, Rhs, PacketScalar, LoadMod
 
 template<typename Scalar, typename RhsType>
 static void ei_cache_friendly_product_colmajor_times_vector(
-  int size, const Scalar* lhs, int lhsStride, const RhsType& rhs, Scalar* res);
+  int size, const Scalar* lhs, int lhsStride, const RhsType& rhs, Scalar* res, int resIncr, Scalar alpha);
 
 template<typename Scalar, typename ResType>
 static void ei_cache_friendly_product_rowmajor_times_vector(
-  const Scalar* lhs, int lhsStride, const Scalar* rhs, int rhsSize, ResType& res);
+  const Scalar* lhs, int lhsStride, const Scalar* rhs, int rhsSize, ResType& res, int rhsIncr, Scalar alpha);
+
+/** \internal \returns the distance in memory between two consecutive coefficients
+  * of the vector \a v which must have the DirectAccessBit */
+template<typename Derived>
+inline int ei_vector_increment(const MatrixBase<Derived>& v)
+{
+  const bool isRowVector = Derived::RowsAtCompileTime==1
+                       || (Derived::ColsAtCompileTime!=1 && v.rows()==1);
+  return isRowVector == bool(int(Derived::Flags)&RowMajorBit) ? 1 : v.stride();
+}
+
+template<typename T> struct ei_product_copy_rhs
+{
+  typedef typename ei_meta_if<
+      (!(int(ei_traits<T>::Flags) & DirectAccessBit)),
+      typename ei_plain_matrix_type_column_major<T>::type,
+      const T&
+    >::ret type;
+};
+
+template<typename T> struct ei_product_copy_lhs
+{
+  typedef typename ei_meta_if<
+      (!(int(ei_traits<T>::Flags) & DirectAccessBit)),
+      typename ei_plain_matrix_type<T>::type,
+      const T&
+    >::ret type;
+};
+
+template<typename Scalar>
+static void ei_cache_friendly_triangular_product(int mode, int size, int cols,
+  bool triRowMajor, bool conjTri, const Scalar* tri, int triStride,
+  bool rhsRowMajor, bool conjRhs, const Scalar* rhs, int rhsStride,
+  bool resRowMajor, Scalar* res, int resStride, Scalar alpha, Scalar triAlpha);
+
+/* Describes a triangular operand of a matrix product. Mode gathers its triangular flags, and the
+ * expression nested by a Part is extracted as is, since the triangular kernel never reads the
+ * opposite half.
+ */
+template<typename XprType> struct ei_triangular_product_traits : ei_blas_traits<XprType>
+{
+  enum {
+    Mode = int(ei_traits<XprType>::Flags) & (UpperTriangularBit|LowerTriangularBit|UnitDiagBit|ZeroDiagBit|SelfAdjointBit),
+    IsTriangular = (!(Mode&SelfAdjointBit)) && ((Mode&UpperTriangularBit)==0) != ((Mode&LowerTriangularBit)==0)
+  };
+};
+
+template<typename NestedXpr, unsigned int PartMode> struct ei_triangular_product_traits<Part<NestedXpr,PartMode> >
+ : ei_blas_traits_wrapper<Part<NestedXpr,PartMode>, NestedXpr, false>
+{
+  enum {
+    Mode = PartMode,
+    IsTriangular = (!(Mode&SelfAdjointBit)) && ((Mode&UpperTriangularBit)==0) != ((Mode&LowerTriangularBit)==0)
+  };
+};
+
+/* Dispatches a matrix * matrix product with a triangular operand to the triangular kernel,
+ * which skips the zero half of the triangular matrix.
+ */
+template<typename ProductType,
+  int TriangularSide = ei_triangular_product_traits<typename ei_traits<ProductType>::_LhsNested>::IsTriangular ? 1
+                     : ei_triangular_product_traits<typename ei_traits<ProductType>::_RhsNested>::IsTriangular ? 2 : 0>
+struct ei_triangular_product_selector
+{
+  typedef typename ProductType::Scalar Scalar;
+
+  template<typename DestDerived>
+  inline static void run(DestDerived& res, const ProductType& product, const Scalar& alpha)
+  {
+    product._cacheFriendlyEvalAndAdd(res, alpha);
+  }
+};
+
+// triangular * dense
+template<typename ProductType>
+struct ei_triangular_product_selector<ProductType,1>
+{
+  typedef typename ProductType::Scalar Scalar;
+  typedef ei_triangular_product_traits<typename ei_traits<ProductType>::_LhsNested> LhsTraits;
+  typedef ei_blas_traits<typename ei_traits<ProductType>::_RhsNested> RhsBlasTraits;
+  typedef typename ei_product_copy_lhs<typename LhsTraits::_ExtractType>::type LhsCopy;
+  typedef typename ei_unref<LhsCopy>::type _LhsCopy;
+  typedef typename ei_product_copy_rhs<typename RhsBlasTraits::_ExtractType>::type RhsCopy;
+  typedef typename ei_unref<RhsCopy>::type _RhsCopy;
+
+  template<typename DestDerived>
+  static void run(DestDerived& res, const ProductType& product, const Scalar& alpha)
+  {
+    LhsCopy lhs(LhsTraits::extract(product.lhs()));
+    RhsCopy rhs(RhsBlasTraits::extract(product.rhs()));
+    ei_cache_friendly_triangular_product<Scalar>(LhsTraits::Mode, lhs.rows(), rhs.cols(),
+      _LhsCopy::Flags&RowMajorBit, LhsTraits::NeedToConjugate,
+      (const Scalar*)&(lhs.const_cast_derived().coeffRef(0,0)), lhs.stride(),
+      _RhsCopy::Flags&RowMajorBit, RhsBlasTraits::NeedToConjugate,
+      (const Scalar*)&(rhs.const_cast_derived().coeffRef(0,0)), rhs.stride(),
+      DestDerived::Flags&RowMajorBit, (Scalar*)&(res.coeffRef(0,0)), res.stride(),
+      alpha * RhsBlasTraits::extractScalarFactor(product.rhs()), LhsTraits::extractScalarFactor(product.lhs()));
+  }
+};
+
+// dense * triangular, computed as the transposed triangular * dense product
+template<typename ProductType>
+struct ei_triangular_product_selector<ProductType,2>
+{
+  typedef typename ProductType::Scalar Scalar;
+  typedef ei_blas_traits<typename ei_traits<ProductType>::_LhsNested> LhsBlasTraits;
+  typedef ei_triangular_product_traits<typename ei_traits<ProductType>::_RhsNested> RhsTraits;
+  typedef typename ei_product_copy_lhs<typename LhsBlasTraits::_ExtractType>::type LhsCopy;
+  typedef typename ei_unref<LhsCopy>::type _LhsCopy;
+  typedef typename ei_product_copy_lhs<typename RhsTraits::_ExtractType>::type RhsCopy;
+  typedef typename ei_unref<RhsCopy>::type _RhsCopy;
+
+  template<typename DestDerived>
+  static void run(DestDerived& res, const ProductType& product, const Scalar& alpha)
+  {
+    LhsCopy lhs(LhsBlasTraits::extract(product.lhs()));
+    RhsCopy rhs(RhsTraits::extract(product.rhs()));
+    const int transposedMode = (RhsTraits::Mode & ~(UpperTriangularBit|LowerTriangularBit))
+                             | (RhsTraits::Mode&UpperTriangularBit ? LowerTriangularBit : UpperTriangularBit);
+    ei_cache_friendly_triangular_product<Scalar>(transposedMode, rhs.cols(), lhs.rows(),
+      !(_RhsCopy::Flags&RowMajorBit), RhsTraits::NeedToConjugate,
+      (const Scalar*)&(rhs.const_cast_derived().coeffRef(0,0)), rhs.stride(),
+      !(_LhsCopy::Flags&RowMajorBit), LhsBlasTraits::NeedToConjugate,
+      (const Scalar*)&(lhs.const_cast_derived().coeffRef(0,0)), lhs.stride(),
+      !(DestDerived::Flags&RowMajorBit), (Scalar*)&(res.coeffRef(0,0)), res.stride(),
+      alpha * LhsBlasTraits::extractScalarFactor(product.lhs()), RhsTraits::extractScalarFactor(product.rhs()));
+  }
+};
 
 template<typename ProductType,
   int LhsRows  = ei_traits<ProductType>::RowsAtCompileTime,
   int LhsOrder = int(ei_traits<ProductType>::LhsFlags)&RowMajorBit ? RowMajor : ColMajor,
-  int LhsHasDirectAccess = int(ei_traits<ProductType>::LhsFlags)&DirectAccessBit? HasDirectAccess : NoDirectAccess,
+  int LhsHasDirectAccess = ei_blas_traits<typename ei_traits<ProductType>::_LhsNested>::HasDirectAccess
+                       && !ei_blas_traits<typename ei_traits<ProductType>::_LhsNested>::NeedToConjugate ? HasDirectAccess : NoDirectAccess,
   int RhsCols  = ei_traits<ProductType>::ColsAtCompileTime,
   int RhsOrder = int(ei_traits<ProductType>::RhsFlags)&RowMajorBit ? RowMajor : ColMajor,
-  int RhsHasDirectAccess = int(ei_traits<ProductType>::RhsFlags)&DirectAccessBit? HasDirectAccess : NoDirectAccess>
+  int RhsHasDirectAccess = ei_blas_traits<typename ei_traits<ProductType>::_RhsNested>::HasDirectAccess
+                       && !ei_blas_traits<typename ei_traits<ProductType>::_RhsNested>::NeedToConjugate ? HasDirectAccess : NoDirectAccess>
 struct ei_cache_friendly_product_selector
 {
+  typedef typename ProductType::Scalar Scalar;
+
   template<typename DestDerived>
-  inline static void run(DestDerived& res, const ProductType& product)
+  inline static void run(DestDerived& res, const ProductType& product, const Scalar& alpha)
   {
-    product._cacheFriendlyEvalAndAdd(res);
+    ei_triangular_product_selector<ProductType>::run(res, product, alpha);
   }
 };
 
@@ -543,12 +792,14 @@ struct ei_cache_friendly_product_selector
 template<typename ProductType, int LhsRows, int RhsOrder, int RhsAccess>
 struct ei_cache_friendly_product_selector<ProductType,LhsRows,ColMajor,NoDirectAccess,1,RhsOrder,RhsAccess>
 {
+  typedef typename ProductType::Scalar Scalar;
+
   template<typename DestDerived>
-  inline static void run(DestDerived& res, const ProductType& product)
+  inline static void run(DestDerived& res, const ProductType& product, const Scalar& alpha)
   {
     const int size = product.rhs().rows();
     for (int k=0; k<size; ++k)
-        res += product.rhs().coeff(k) * product.lhs().col(k);
+        res += (alpha * product.rhs().coeff(k)) * product.lhs().col(k);
   }
 };
 
@@ -558,24 +809,27 @@ template<typename ProductType, int LhsRows, int RhsOrder, int RhsAccess>
 struct ei_cache_friendly_product_selector<ProductType,LhsRows,ColMajor,HasDirectAccess,1,RhsOrder,RhsAccess>
 {
   typedef typename ProductType::Scalar Scalar;
+  typedef ei_blas_traits<typename ei_traits<ProductType>::_LhsNested> LhsBlasTraits;
 
   template<typename DestDerived>
-  inline static void run(DestDerived& res, const ProductType& product)
+  inline static void run(DestDerived& res, const ProductType& product, const Scalar& alpha)
   {
-    enum {
-      EvalToRes = (ei_packet_traits<Scalar>::size==1)
-                ||((DestDerived::Flags&ActualPacketAccessBit) && (!(DestDerived::Flags & RowMajorBit))) };
+    typename LhsBlasTraits::ExtractType lhs = LhsBlasTraits::extract(product.lhs());
+    const Scalar actualAlpha = alpha * LhsBlasTraits::extractScalarFactor(product.lhs());
+
+    // the kernel deals with unaligned and strided destinations by itself
+    enum { EvalToRes = DestDerived::Flags&DirectAccessBit };
     Scalar* EIGEN_RESTRICT _res;
     if (EvalToRes)
-       _res = &res.coeffRef(0);
+       _res = &res.coeffRef(0,0);
     else
     {
       _res = ei_aligned_stack_new(Scalar,res.size());
       Map<Matrix<Scalar,DestDerived::RowsAtCompileTime,1> >(_res, res.size()) = res;
     }
     ei_cache_friendly_product_colmajor_times_vector(res.size(),
-      &product.lhs().const_cast_derived().coeffRef(0,0), product.lhs().stride(),
-      product.rhs(), _res);
+      &lhs.const_cast_derived().coeffRef(0,0), lhs.stride(),
+      product.rhs(), _res, EvalToRes ? ei_vector_increment(res) : 1, actualAlpha);
 
     if (!EvalToRes)
     {
@@ -589,12 +843,14 @@ struct ei_cache_friendly_product_selector<ProductType,LhsRows,ColMajor,HasDirect
 template<typename ProductType, int LhsOrder, int LhsAccess, int RhsCols>
 struct ei_cache_friendly_product_selector<ProductType,1,LhsOrder,LhsAccess,RhsCols,RowMajor,NoDirectAccess>
 {
+  typedef typename ProductType::Scalar Scalar;
+
   template<typename DestDerived>
-  inline static void run(DestDerived& res, const ProductType& product)
+  inline static void run(DestDerived& res, const ProductType& product, const Scalar& alpha)
   {
     const int cols = product.lhs().cols();
     for (int j=0; j<cols; ++j)
-      res += product.lhs().coeff(j) * product.rhs().row(j);
+      res += (alpha * product.lhs().coeff(j)) * product.rhs().row(j);
   }
 };
 
@@ -604,24 +860,27 @@ template<typename ProductType, int LhsOrder, int LhsAccess, int RhsCols>
 struct ei_cache_friendly_product_selector<ProductType,1,LhsOrder,LhsAccess,RhsCols,RowMajor,HasDirectAccess>
 {
   typedef typename ProductType::Scalar Scalar;
+  typedef ei_blas_traits<typename ei_traits<ProductType>::_RhsNested> RhsBlasTraits;
 
   template<typename DestDerived>
-  inline static void run(DestDerived& res, const ProductType& product)
+  inline static void run(DestDerived& res, const ProductType& product, const Scalar& alpha)
   {
-    enum {
-      EvalToRes = (ei_packet_traits<Scalar>::size==1)
-                ||((DestDerived::Flags & ActualPacketAccessBit) && (DestDerived::Flags & RowMajorBit)) };
+    typename RhsBlasTraits::ExtractType rhs = RhsBlasTraits::extract(product.rhs());
+    const Scalar actualAlpha = alpha * RhsBlasTraits::extractScalarFactor(product.rhs());
+
+    // the kernel deals with unaligned and strided destinations by itself
+    enum { EvalToRes = DestDerived::Flags&DirectAccessBit };
     Scalar* EIGEN_RESTRICT _res;
     if (EvalToRes)
-       _res = &res.coeffRef(0);
+       _res = &res.coeffRef(0,0);
     else
     {
       _res = ei_aligned_stack_new(Scalar, res.size());
       Map<Matrix<Scalar,DestDerived::SizeAtCompileTime,1> >(_res, res.size()) = res;
     }
     ei_cache_friendly_product_colmajor_times_vector(res.size(),
-      &product.rhs().const_cast_derived().coeffRef(0,0), product.rhs().stride(),
-      product.lhs().transpose(), _res);
+      &rhs.const_cast_derived().coeffRef(0,0), rhs.stride(),
+      product.lhs().transpose(), _res, EvalToRes ? ei_vector_increment(res) : 1, actualAlpha);
 
     if (!EvalToRes)
     {
@@ -636,24 +895,29 @@ template<typename ProductType, int LhsRows, int RhsOrder, int RhsAccess>
 struct ei_cache_friendly_product_selector<ProductType,LhsRows,RowMajor,HasDirectAccess,1,RhsOrder,RhsAccess>
 {
   typedef typename ProductType::Scalar Scalar;
+  typedef ei_blas_traits<typename ei_traits<ProductType>::_LhsNested> LhsBlasTraits;
   typedef typename ei_traits<ProductType>::_RhsNested Rhs;
-  enum {
-      UseRhsDirectly = ((ei_packet_traits<Scalar>::size==1) || (Rhs::Flags&ActualPacketAccessBit))
-                     && (!(Rhs::Flags & RowMajorBit)) };
+  // the kernel deals with unaligned and strided rhs by itself
+  enum { UseRhsDirectly = Rhs::Flags&DirectAccessBit };
 
   template<typename DestDerived>
-  inline static void run(DestDerived& res, const ProductType& product)
+  inline static void run(DestDerived& res, const ProductType& product, const Scalar& alpha)
   {
+    typename LhsBlasTraits::ExtractType lhs = LhsBlasTraits::extract(product.lhs());
+    const Scalar actualAlpha = alpha * LhsBlasTraits::extractScalarFactor(product.lhs());
+
     Scalar* EIGEN_RESTRICT _rhs;
     if (UseRhsDirectly)
-       _rhs = &product.rhs().const_cast_derived().coeffRef(0);
+       _rhs = &product.rhs().const_cast_derived().coeffRef(0,0);
     else
     {
       _rhs = ei_aligned_stack_new(Scalar, product.rhs().size());
       Map<Matrix<Scalar,Rhs::SizeAtCompileTime,1> >(_rhs, product.rhs().size()) = product.rhs();
     }
-    ei_cache_friendly_product_rowmajor_times_vector(&product.lhs().const_cast_derived().coeffRef(0,0), product.lhs().stride(),
-                                                    _rhs, product.rhs().size(), res);
+    ei_cache_friendly_product_rowmajor_times_vector(&lhs.const_cast_derived().coeffRef(0,0), lhs.stride(),
+                                                    _rhs, product.rhs().size(), res,
+                                                    UseRhsDirectly ? ei_vector_increment(product.rhs()) : 1,
+                                                    actualAlpha);
 
     if (!UseRhsDirectly) ei_aligned_stack_delete(Scalar, _rhs, product.rhs().size());
   }
@@ -664,24 +928,29 @@ template<typename ProductType, int LhsOrder, int LhsAccess, int RhsCols>
 struct ei_cache_friendly_product_selector<ProductType,1,LhsOrder,LhsAccess,RhsCols,ColMajor,HasDirectAccess>
 {
   typedef typename ProductType::Scalar Scalar;
+  typedef ei_blas_traits<typename ei_traits<ProductType>::_RhsNested> RhsBlasTraits;
   typedef typename ei_traits<ProductType>::_LhsNested Lhs;
-  enum {
-      UseLhsDirectly = ((ei_packet_traits<Scalar>::size==1) || (Lhs::Flags&ActualPacketAccessBit))
-                     && (Lhs::Flags & RowMajorBit) };
+  // the kernel deals with unaligned and strided lhs by itself
+  enum { UseLhsDirectly = Lhs::Flags&DirectAccessBit };
 
   template<typename DestDerived>
-  inline static void run(DestDerived& res, const ProductType& product)
+  inline static void run(DestDerived& res, const ProductType& product, const Scalar& alpha)
   {
+    typename RhsBlasTraits::ExtractType rhs = RhsBlasTraits::extract(product.rhs());
+    const Scalar actualAlpha = alpha * RhsBlasTraits::extractScalarFactor(product.rhs());
+
     Scalar* EIGEN_RESTRICT _lhs;
     if (UseLhsDirectly)
-       _lhs = &product.lhs().const_cast_derived().coeffRef(0);
+       _lhs = &product.lhs().const_cast_derived().coeffRef(0,0);
     else
     {
       _lhs = ei_aligned_stack_new(Scalar, product.lhs().size());
       Map<Matrix<Scalar,Lhs::SizeAtCompileTime,1> >(_lhs, product.lhs().size()) = product.lhs();
     }
-    ei_cache_friendly_product_rowmajor_times_vector(&product.rhs().const_cast_derived().coeffRef(0,0), product.rhs().stride(),
-                                                    _lhs, product.lhs().size(), res);
+    ei_cache_friendly_product_rowmajor_times_vector(&rhs.const_cast_derived().coeffRef(0,0), rhs.stride(),
+                                                    _lhs, product.lhs().size(), res,
+                                                    UseLhsDirectly ? ei_vector_increment(product.lhs()) : 1,
+                                                    actualAlpha);
 
     if(!UseLhsDirectly) ei_aligned_stack_delete(Scalar, _lhs, product.lhs().size());
   }
@@ -707,7 +976,7 @@ inline Derived&
 MatrixBase<Derived>::operator+=(const Flagged<Product<Lhs,Rhs,CacheFriendlyProduct>, 0, EvalBeforeNestingBit | EvalBeforeAssigningBit>& other)
 {
   if (other._expression()._useCacheFriendlyProduct())
-    ei_cache_friendly_product_selector<Product<Lhs,Rhs,CacheFriendlyProduct> >::run(const_cast_derived(), other._expression());
+    ei_cache_friendly_product_selector<Product<Lhs,Rhs,CacheFriendlyProduct> >::run(const_cast_derived(), other._expression(), Scalar(1));
   else
     lazyAssign(derived() + other._expression());
   return derived();
@@ -720,7 +989,7 @@ inline Derived& MatrixBase<Derived>::lazyAssign(const Product<Lhs,Rhs,CacheFrien
   if (product._useCacheFriendlyProduct())
   {
     setZero();
-    ei_cache_friendly_product_selector<Product<Lhs,Rhs,CacheFriendlyProduct> >::run(const_cast_derived(), product);
+    ei_cache_friendly_product_selector<Product<Lhs,Rhs,CacheFriendlyProduct> >::run(const_cast_derived(), product, Scalar(1));
   }
   else
   {
@@ -729,40 +998,26 @@ inline Derived& MatrixBase<Derived>::lazyAssign(const Product<Lhs,Rhs,CacheFrien
   return derived();
 }
 
-template<typename T> struct ei_product_copy_rhs
-{
-  typedef typename ei_meta_if<
-         (ei_traits<T>::Flags & RowMajorBit)
-      || (!(ei_traits<T>::Flags & DirectAccessBit)),
-      typename ei_plain_matrix_type_column_major<T>::type,
-      const T&
-    >::ret type;
-};
-
-template<typename T> struct ei_product_copy_lhs
-{
-  typedef typename ei_meta_if<
-      (!(int(ei_traits<T>::Flags) & DirectAccessBit)),
-      typename ei_plain_matrix_type<T>::type,
-      const T&
-    >::ret type;
-};
-
 template<typename Lhs, typename Rhs, int ProductMode>
 template<typename DestDerived>
-inline void Product<Lhs,Rhs,ProductMode>::_cacheFriendlyEvalAndAdd(DestDerived& res) const
+inline void Product<Lhs,Rhs,ProductMode>::_cacheFriendlyEvalAndAdd(DestDerived& res, const Scalar& alpha) const
 {
-  typedef typename ei_product_copy_lhs<_LhsNested>::type LhsCopy;
+  typedef ei_blas_traits<_LhsNested> LhsBlasTraits;
+  typedef ei_blas_traits<_RhsNested> RhsBlasTraits;
+  typedef typename ei_product_copy_lhs<typename LhsBlasTraits::_ExtractType>::type LhsCopy;
   typedef typename ei_unref<LhsCopy>::type _LhsCopy;
-  typedef typename ei_product_copy_rhs<_RhsNested>::type RhsCopy;
+  typedef typename ei_product_copy_rhs<typename RhsBlasTraits::_ExtractType>::type RhsCopy;
   typedef typename ei_unref<RhsCopy>::type _RhsCopy;
-  LhsCopy lhs(m_lhs);
-  RhsCopy rhs(m_rhs);
+  LhsCopy lhs(LhsBlasTraits::extract(m_lhs));
+  RhsCopy rhs(RhsBlasTraits::extract(m_rhs));
   ei_cache_friendly_product<Scalar>(
     rows(), cols(), lhs.cols(),
-    _LhsCopy::Flags&RowMajorBit, (const Scalar*)&(lhs.const_cast_derived().coeffRef(0,0)), lhs.stride(),
-    _RhsCopy::Flags&RowMajorBit, (const Scalar*)&(rhs.const_cast_derived().coeffRef(0,0)), rhs.stride(),
-    Flags&RowMajorBit, (Scalar*)&(res.coeffRef(0,0)), res.stride()
+    _LhsCopy::Flags&RowMajorBit, LhsBlasTraits::NeedToConjugate,
+    (const Scalar*)&(lhs.const_cast_derived().coeffRef(0,0)), lhs.stride(),
+    _RhsCopy::Flags&RowMajorBit, RhsBlasTraits::NeedToConjugate,
+    (const Scalar*)&(rhs.const_cast_derived().coeffRef(0,0)), rhs.stride(),
+    DestDerived::Flags&RowMajorBit, (Scalar*)&(res.coeffRef(0,0)), res.stride(),
+    alpha * LhsBlasTraits::extractScalarFactor(m_lhs) * RhsBlasTraits::extractScalarFactor(m_rhs), Scalar(1)
   );
 }
 
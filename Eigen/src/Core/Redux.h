@@ -26,6 +26,291 @@
 #ifndef EIGEN_REDUX_H
 #define EIGEN_REDUX_H
 
+/***************************************************************************
+* Part 1 : the reduction engine used by the dynamic-size paths of
+*          redux(), sum(), dot() and squaredNorm()
+***************************************************************************/
+
+/** \internal combines two partial results of a reduction, either packet-wise or coefficient-wise */
+template<typename BinaryOp, bool Vectorize> struct ei_redux_combine
+{
+  template<typename T>
+  EIGEN_STRONG_INLINE static T run(const BinaryOp& func, const T& a, const T& b) { return func(a, b); }
+};
+
+template<typename BinaryOp> struct ei_redux_combine<BinaryOp, true>
+{
+  template<typename T>
+  EIGEN_STRONG_INLINE static T run(const BinaryOp& func, const T& a, const T& b) { return func.packetOp(a, b); }
+};
+
+/** \internal loads either a packet or a coefficient of a reduction evaluator */
+template<bool Vectorize> struct ei_redux_load
+{
+  template<typename Evaluator>
+  EIGEN_STRONG_INLINE static typename Evaluator::Scalar run(const Evaluator& eval, int index) { return eval.coeff(index); }
+};
+
+template<> struct ei_redux_load<true>
+{
+  template<typename Evaluator>
+  EIGEN_STRONG_INLINE static typename Evaluator::PacketScalar run(const Evaluator& eval, int index) { return eval.packet(index); }
+};
+
+/** \internal the default reduction evaluator, simply forwarding the linear accessors of a matrix expression */
+template<typename Derived, int LoadMode = Unaligned>
+struct ei_redux_evaluator
+{
+  typedef typename Derived::Scalar Scalar;
+  typedef typename ei_packet_traits<Scalar>::type PacketScalar;
+  enum { Flags = Derived::Flags };
+
+  ei_redux_evaluator(const Derived& mat) : m_mat(mat) {}
+
+  EIGEN_STRONG_INLINE Scalar coeff(int index) const { return m_mat.coeff(index); }
+  EIGEN_STRONG_INLINE PacketScalar packet(int index) const { return m_mat.template packet<LoadMode>(index); }
+
+  const Derived& m_mat;
+};
+
+/** \internal reduction evaluator whose coefficients are the reductions of the columns of an expression
+  * which does not have the LinearAccessBit.
+  */
+template<typename BinaryOp, typename Derived>
+struct ei_redux_column_evaluator
+{
+  typedef typename ei_result_of<BinaryOp(typename Derived::Scalar)>::type Scalar;
+  typedef Scalar PacketScalar;
+  enum { Flags = Derived::Flags };
+
+  ei_redux_column_evaluator(const Derived& mat, const BinaryOp& func) : m_mat(mat), m_func(func) {}
+
+  Scalar coeff(int col) const
+  {
+    Scalar res = m_mat.coeff(0, col);
+    for(int i = 1; i < m_mat.rows(); ++i)
+      res = m_func(res, m_mat.coeff(i, col));
+    return res;
+  }
+
+  const Derived& m_mat;
+  const BinaryOp& m_func;
+};
+
+/** \internal the type of the partial results of a reduction: packets if \a Vectorize is true, coefficients otherwise */
+template<typename Evaluator, bool Vectorize> struct ei_redux_unit
+{
+  typedef typename Evaluator::Scalar type;
+};
+
+template<typename Evaluator> struct ei_redux_unit<Evaluator, true>
+{
+  typedef typename Evaluator::PacketScalar type;
+};
+
+/** \internal
+  * Reduces \a count consecutive units (packets if \a Vectorize is true, coefficients otherwise) of an evaluator.
+  *
+  * A single accumulator makes the loop bound by the latency of \a func rather than by its throughput,
+  * so the range is cut into four contiguous quarters which are reduced simultaneously by independent
+  * accumulators. Their partial results are combined in order, hence \a func only needs to be associative.
+  *
+  * Above EIGEN_PARALLEL_REDUX_THRESHOLD coefficients per thread, the range is first split into one chunk
+  * per thread, and the partial results of the chunks are combined by a pairwise tree reduction. The
+  * evaluators having the NonRepeatableBit, like Random(), are always reduced by the calling thread.
+  */
+template<typename BinaryOp, typename Evaluator, bool Vectorize>
+struct ei_redux_engine
+{
+  typedef typename Evaluator::Scalar Scalar;
+  typedef typename ei_redux_unit<Evaluator, Vectorize>::type Unit;
+  typedef ei_redux_combine<BinaryOp, Vectorize> Combine;
+  typedef ei_redux_load<Vectorize> Load;
+  enum { Step = Vectorize ? ei_packet_traits<Scalar>::size : 1 };
+
+  static Unit runRange(const Evaluator& eval, const BinaryOp& func, int start, int count)
+  {
+    ei_internal_assert(count>0);
+    if(count < 4)
+    {
+      Unit res = Load::run(eval, start);
+      for(int k = 1; k < count; ++k)
+        res = Combine::run(func, res, Load::run(eval, start + k*Step));
+      return res;
+    }
+
+    const int quarter = count/4;
+    const int start1 = start + quarter*Step;
+    const int start2 = start1 + quarter*Step;
+    const int start3 = start2 + quarter*Step;
+    const int end = start + count*Step;
+    Unit res0 = Load::run(eval, start),
+         res1 = Load::run(eval, start1),
+         res2 = Load::run(eval, start2),
+         res3 = Load::run(eval, start3);
+    for(int offset = Step; offset < quarter*Step; offset += Step)
+    {
+      res0 = Combine::run(func, res0, Load::run(eval, start  + offset));
+      res1 = Combine::run(func, res1, Load::run(eval, start1 + offset));
+      res2 = Combine::run(func, res2, Load::run(eval, start2 + offset));
+      res3 = Combine::run(func, res3, Load::run(eval, start3 + offset));
+    }
+    // the last quarter also gets the few remaining units
+    for(int index = start3 + quarter*Step; index < end; index += Step)
+      res3 = Combine::run(func, res3, Load::run(eval, index));
+    return Combine::run(func, Combine::run(func, res0, res1), Combine::run(func, res2, res3));
+  }
+
+  /** \a unitCost is the number of coefficients each unit stands for */
+  static Unit run(const Evaluator& eval, const BinaryOp& func, int start, int count, int unitCost = Step)
+  {
+    #ifdef EIGEN_PARALLELIZE
+    const int chunks = (int(Evaluator::Flags) & NonRepeatableBit) ? 1
+                     : std::min(count, ei_parallel_chunks(count*unitCost, EIGEN_PARALLEL_REDUX_THRESHOLD));
+    if(chunks > 1)
+    {
+      const int chunkSize = count/chunks;
+      Unit* partial = ei_aligned_stack_new(Unit, chunks);
+      #pragma omp parallel for num_threads(chunks)
+      for(int c = 0; c < chunks; ++c)
+        partial[c] = runRange(eval, func, start + c*chunkSize*Step, c+1 == chunks ? count - c*chunkSize : chunkSize);
+      for(int stride = 1; stride < chunks; stride *= 2)
+        for(int c = 0; c+stride < chunks; c += 2*stride)
+          partial[c] = Combine::run(func, partial[c], partial[c+stride]);
+      Unit res = partial[0];
+      ei_aligned_stack_delete(Unit, partial, chunks);
+      return res;
+    }
+    #else
+    static_cast<void>(unitCost); // suppress unused variable warning
+    #endif
+    return runRange(eval, func, start, count);
+  }
+};
+
+/** \internal \returns the reduction of the coefficients of the packet \a a using \a func */
+template<typename BinaryOp, typename PacketScalar>
+inline typename ei_unpacket_traits<PacketScalar>::type ei_predux(const BinaryOp& func, const PacketScalar& a)
+{
+  typedef typename ei_unpacket_traits<PacketScalar>::type Scalar;
+  const int PacketSize = ei_unpacket_traits<PacketScalar>::size;
+  EIGEN_ALIGN_128 Scalar coeffs[PacketSize];
+  ei_pstore(coeffs, a);
+  Scalar res = coeffs[0];
+  for(int i = 1; i < PacketSize; ++i)
+    res = func(res, coeffs[i]);
+  return res;
+}
+
+template<typename Scalar, typename PacketScalar>
+inline Scalar ei_predux(const ei_scalar_sum_op<Scalar>&, const PacketScalar& a)
+{
+  return ei_predux(a);
+}
+
+/** \internal
+  * Reduces the \a size coefficients of a linear evaluator. If \a Vectorize is true, the coefficients
+  * [alignedStart, alignedStart + k*PacketSize) are reduced by packets, and the few remaining ones one at a time.
+  */
+template<typename BinaryOp, typename Evaluator, bool Vectorize>
+struct ei_redux_linear_impl
+{
+  typedef typename Evaluator::Scalar Scalar;
+  static Scalar run(const Evaluator& eval, const BinaryOp& func, int size, int = 0)
+  {
+    return ei_redux_engine<BinaryOp, Evaluator, false>::run(eval, func, 0, size);
+  }
+};
+
+template<typename BinaryOp, typename Evaluator>
+struct ei_redux_linear_impl<BinaryOp, Evaluator, true>
+{
+  typedef typename Evaluator::Scalar Scalar;
+  static Scalar run(const Evaluator& eval, const BinaryOp& func, int size, int alignedStart = 0)
+  {
+    const int packetSize = ei_packet_traits<Scalar>::size;
+    const int alignedSize = ((size-alignedStart)/packetSize)*packetSize;
+    const int alignedEnd = alignedStart + alignedSize;
+
+    // too small to vectorize anything.
+    // since this is dynamic-size hence inefficient anyway for such small sizes, don't try to optimize.
+    if(alignedSize == 0)
+      return ei_redux_linear_impl<BinaryOp, Evaluator, false>::run(eval, func, size);
+
+    Scalar res = ei_predux(func, ei_redux_engine<BinaryOp, Evaluator, true>::run(eval, func, alignedStart, alignedSize/packetSize));
+    for(int index = 0; index < alignedStart; ++index)
+      res = func(res, eval.coeff(index));
+    for(int index = alignedEnd; index < size; ++index)
+      res = func(res, eval.coeff(index));
+    return res;
+  }
+};
+
+/***************************************************************************
+* Part 2 : implementation of redux()
+***************************************************************************/
+
+template<typename BinaryOp, typename Derived>
+struct ei_redux_traits
+{
+  enum {
+    Vectorization = (int(Derived::Flags)&ActualPacketAccessBit)
+                 && (int(Derived::Flags)&LinearAccessBit)
+                 && ei_functor_traits<BinaryOp>::PacketAccess
+                  ? LinearVectorization
+                  : NoVectorization,
+    // the LinearAccessBit alone does not guarantee that the operands of a cwise expression share
+    // the same storage order, this is only ensured for packet access or direct access.
+    LinearAccess = (int(Derived::Flags)&LinearAccessBit)
+                && ((int(Derived::Flags)&DirectAccessBit) || int(Vectorization)==LinearVectorization) ? 1 : 0
+  };
+};
+
+template<typename BinaryOp, typename Derived,
+         int Vectorization = ei_redux_traits<BinaryOp, Derived>::Vectorization,
+         int LinearAccess = ei_redux_traits<BinaryOp, Derived>::LinearAccess>
+struct ei_redux_dynamic_impl
+{
+  typedef typename ei_result_of<BinaryOp(typename Derived::Scalar)>::type Scalar;
+  static Scalar run(const Derived& mat, const BinaryOp& func)
+  {
+    ei_redux_column_evaluator<BinaryOp, Derived> eval(mat, func);
+    return ei_redux_engine<BinaryOp, ei_redux_column_evaluator<BinaryOp, Derived>, false>
+             ::run(eval, func, 0, mat.cols(), mat.rows());
+  }
+};
+
+template<typename BinaryOp, typename Derived>
+struct ei_redux_dynamic_impl<BinaryOp, Derived, NoVectorization, 1>
+{
+  typedef typename ei_result_of<BinaryOp(typename Derived::Scalar)>::type Scalar;
+  static Scalar run(const Derived& mat, const BinaryOp& func)
+  {
+    return ei_redux_linear_impl<BinaryOp, ei_redux_evaluator<Derived>, false>
+             ::run(ei_redux_evaluator<Derived>(mat), func, mat.size());
+  }
+};
+
+template<typename BinaryOp, typename Derived>
+struct ei_redux_dynamic_impl<BinaryOp, Derived, LinearVectorization, 1>
+{
+  typedef typename ei_result_of<BinaryOp(typename Derived::Scalar)>::type Scalar;
+  enum {
+    alignment = (Derived::Flags & DirectAccessBit) || (Derived::Flags & AlignedBit)
+              ? Aligned : Unaligned
+  };
+  static Scalar run(const Derived& mat, const BinaryOp& func)
+  {
+    const int size = mat.size();
+    const int alignedStart =  (Derived::Flags & AlignedBit)
+                           || !(Derived::Flags & DirectAccessBit)
+                           ? 0
+                           : ei_alignmentOffset(&mat.const_cast_derived().coeffRef(0), size);
+    return ei_redux_linear_impl<BinaryOp, ei_redux_evaluator<Derived, alignment>, true>
+             ::run(ei_redux_evaluator<Derived, alignment>(mat), func, size, alignedStart);
+  }
+};
+
 template<typename BinaryOp, typename Derived, int Start, int Length>
 struct ei_redux_impl
 {
@@ -66,14 +351,7 @@ struct ei_redux_impl<BinaryOp, Derived, Start, Dynamic>
   static Scalar run(const Derived& mat, const BinaryOp& func)
   {
     ei_assert(mat.rows()>0 && mat.cols()>0 && "you are using a non initialized matrix");
-    Scalar res;
-    res = mat.coeff(0,0);
-    for(int i = 1; i < mat.rows(); ++i)
-      res = func(res, mat.coeff(i, 0));
-    for(int j = 1; j < mat.cols(); ++j)
-      for(int i = 0; i < mat.rows(); ++i)
-        res = func(res, mat.coeff(i, j));
-    return res;
+    return ei_redux_dynamic_impl<BinaryOp, Derived>::run(mat, func);
   }
 };
 
@@ -82,6 +360,9 @@ struct ei_redux_impl<BinaryOp, Derived, Start, Dynamic>
   * The template parameter \a BinaryOp is the type of the functor \a func which must be
   * an assiociative operator. Both current STL and TR1 functor styles are handled.
   *
+  * For dynamic sizes, the reduction keeps several independent accumulators in flight, and large
+  * expressions are reduced by several threads when OpenMP is enabled (see EIGEN_PARALLEL_REDUX_THRESHOLD).
+  *
   * \sa MatrixBase::sum(), MatrixBase::minCoeff(), MatrixBase::maxCoeff(), MatrixBase::colwise(), MatrixBase::rowwise()
   */
 template<typename Derived>
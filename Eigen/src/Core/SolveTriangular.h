@@ -190,7 +190,8 @@ struct ei_solve_triangular_selector<Lhs,Rhs,UpLo,ColMajor|IsDense>
           IsLowerTriangular ? size-endBlock : endBlock+1,
           &(lhs.const_cast_derived().coeffRef(IsLowerTriangular ? endBlock : 0, IsLowerTriangular ? startBlock : endBlock+1)),
           lhs.stride(),
-          btmp, &(other.coeffRef(IsLowerTriangular ? endBlock : 0, c)));
+          btmp, &(other.coeffRef(IsLowerTriangular ? endBlock : 0, c)),
+          (int(Rhs::Flags)&RowMajorBit) ? other.stride() : 1, Scalar(1));
 // 				if (IsLowerTriangular)
 //           other.col(c).end(size-endBlock) += (lhs.block(endBlock, startBlock, size-endBlock, endBlock-startBlock)
 //                                           * other.col(c).block(startBlock,endBlock-startBlock)).lazy();
@@ -220,6 +221,86 @@ struct ei_solve_triangular_selector<Lhs,Rhs,UpLo,ColMajor|IsDense>
   }
 };
 
+/** \internal
+  * Solves the columns \a start to \a end of \a other, per diagonal block of EIGEN_DECOMPOSITION_BLOCK_SIZE
+  * rows: each diagonal block is solved by ei_solve_triangular_selector, and the remaining rows are then
+  * updated at once by a cache friendly matrix product.
+  */
+template<typename Lhs, typename Rhs>
+struct ei_solve_triangular_blocked_kernel
+{
+  enum {
+    Mode = int(Lhs::Flags) & (UpperTriangularBit|LowerTriangularBit|UnitDiagBit),
+    IsLowerTriangular = int(Lhs::Flags) & LowerTriangularBit
+  };
+  typedef Flagged<Block<Lhs>, Mode, 0> DiagonalBlockType;
+
+  ei_solve_triangular_blocked_kernel(const Lhs& lhs, Rhs& other) : m_lhs(lhs), m_other(other) {}
+
+  void operator()(int start, int end) const
+  {
+    const int size = m_lhs.cols();
+    const int cols = end-start;
+    const int blockSize = EIGEN_DECOMPOSITION_BLOCK_SIZE;
+    for(int i = 0; i < size; i += blockSize)
+    {
+      // the diagonal blocks are processed from the top for a lower triangular matrix, and from the bottom otherwise
+      const int actualBlockSize = std::min(blockSize, size-i);
+      const int k = IsLowerTriangular ? i : size-i-actualBlockSize;
+
+      // Flagged only references the block, which must therefore outlive it
+      const Block<Lhs> diagonalBlockExpression(m_lhs, k, k, actualBlockSize, actualBlockSize);
+      DiagonalBlockType diagonalBlock(diagonalBlockExpression);
+      Block<Rhs> x(m_other, k, start, actualBlockSize, cols);
+      ei_solve_triangular_selector<DiagonalBlockType, Block<Rhs> >::run(diagonalBlock, x);
+
+      const int remaining = IsLowerTriangular ? size-k-actualBlockSize : k;
+      if(remaining > 0)
+      {
+        const int r = IsLowerTriangular ? k+actualBlockSize : 0;
+        Block<Rhs>(m_other, r, start, remaining, cols).noalias()
+          -= Block<Lhs>(m_lhs, r, k, remaining, actualBlockSize) * x;
+      }
+    }
+  }
+
+  const Lhs& m_lhs;
+  Rhs& m_other;
+
+  private:
+    ei_solve_triangular_blocked_kernel& operator=(const ei_solve_triangular_blocked_kernel&);
+};
+
+/** \internal
+  * Entry point of the in-place triangular solve. Large systems with several right hand sides are solved
+  * per block (see ei_solve_triangular_blocked_kernel), and the columns of the right hand side are split
+  * across several threads if OpenMP is enabled. Other systems, and the triangular expressions without direct
+  * access such as a marked Part, are directly solved by ei_solve_triangular_selector.
+  */
+template<typename Lhs, typename Rhs, bool IsPart = ei_is_part<Lhs>::value>
+struct ei_solve_triangular_blocked
+{
+  static void run(const Lhs& lhs, Rhs& other)
+  {
+    if(!(int(Lhs::Flags) & DirectAccessBit) || lhs.cols() < 2*EIGEN_DECOMPOSITION_BLOCK_SIZE || other.cols() < 2)
+    {
+      ei_solve_triangular_selector<Lhs,Rhs>::run(lhs, other);
+      return;
+    }
+    ei_parallelize(ei_solve_triangular_blocked_kernel<Lhs,Rhs>(lhs, other), other.cols(), EIGEN_DECOMPOSITION_BLOCK_SIZE);
+  }
+};
+
+// transform a Part xpr to a Flagged xpr
+template<typename Lhs, unsigned int LhsMode, typename Rhs>
+struct ei_solve_triangular_blocked<Part<Lhs,LhsMode>,Rhs,true>
+{
+  static void run(const Part<Lhs,LhsMode>& lhs, Rhs& other)
+  {
+    ei_solve_triangular_blocked<Flagged<Lhs,LhsMode,0>,Rhs>::run(lhs._expression(), other);
+  }
+};
+
 /** "in-place" version of MatrixBase::solveTriangular() where the result is written in \a other
   *
   * \nonstableyet
@@ -245,7 +326,7 @@ void MatrixBase<Derived>::solveTriangularInPlace(const MatrixBase<OtherDerived>&
     typename ei_plain_matrix_type_column_major<OtherDerived>::type, OtherDerived&>::ret OtherCopy;
   OtherCopy otherCopy(other.derived());
 
-  ei_solve_triangular_selector<Derived, typename ei_unref<OtherCopy>::type>::run(derived(), otherCopy);
+  ei_solve_triangular_blocked<Derived, typename ei_unref<OtherCopy>::type>::run(derived(), otherCopy);
 
   if (copy)
     other = otherCopy;
@@ -246,6 +246,9 @@ template<> inline void ei_pstoreu(int*    to , const v4i&    from )
   vec_st( MSQ, 0, (unsigned char *)to );                    // Store the MSQ part
 }
 
+template<> inline v4f    ei_pconj(const v4f&   a) { return a; }
+template<> inline v4i    ei_pconj(const v4i&   a) { return a; }
+
 template<> inline float  ei_pfirst(const v4f&  a)
 {
   float __attribute__(aligned(16)) af[4];
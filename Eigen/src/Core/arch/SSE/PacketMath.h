@@ -92,6 +92,10 @@ template<> EIGEN_STRONG_INLINE __m128i ei_pmax<__m128i>(const __m128i& a, const
   return _mm_or_si128(_mm_and_si128(mask,a),_mm_andnot_si128(mask,b));
 }
 
+template<> EIGEN_STRONG_INLINE __m128  ei_pconj<__m128>(const __m128&  a) { return a; }
+template<> EIGEN_STRONG_INLINE __m128d ei_pconj<__m128d>(const __m128d& a) { return a; }
+template<> EIGEN_STRONG_INLINE __m128i ei_pconj<__m128i>(const __m128i& a) { return a; }
+
 template<> EIGEN_STRONG_INLINE __m128  ei_pload<float>(const float*   from) { return _mm_load_ps(from); }
 template<> EIGEN_STRONG_INLINE __m128d ei_pload<double>(const double*  from) { return _mm_load_pd(from); }
 template<> EIGEN_STRONG_INLINE __m128i ei_pload<int>(const int* from) { return _mm_load_si128(reinterpret_cast<const __m128i*>(from)); }
@@ -114,6 +118,14 @@ template<> EIGEN_STRONG_INLINE void ei_pstoreu<float>(float*  to, const __m128&
 template<> EIGEN_STRONG_INLINE void ei_pstoreu<double>(double* to, const __m128d& from) { _mm_storeu_pd(to, from); }
 template<> EIGEN_STRONG_INLINE void ei_pstoreu<int>(int*    to, const __m128i& from) { _mm_storeu_si128(reinterpret_cast<__m128i*>(to), from); }
 
+template<> EIGEN_STRONG_INLINE void ei_pstream<float>(float*  to, const __m128&  from) { _mm_stream_ps(to, from); }
+template<> EIGEN_STRONG_INLINE void ei_pstream<double>(double* to, const __m128d& from) { _mm_stream_pd(to, from); }
+template<> EIGEN_STRONG_INLINE void ei_pstream<int>(int*    to, const __m128i& from) { _mm_stream_si128(reinterpret_cast<__m128i*>(to), from); }
+
+template<> EIGEN_STRONG_INLINE void ei_pstream_fence<__m128>()  { _mm_sfence(); }
+template<> EIGEN_STRONG_INLINE void ei_pstream_fence<__m128d>() { _mm_sfence(); }
+template<> EIGEN_STRONG_INLINE void ei_pstream_fence<__m128i>() { _mm_sfence(); }
+
 template<> EIGEN_STRONG_INLINE float  ei_pfirst<__m128>(const __m128&  a) { return _mm_cvtss_f32(a); }
 template<> EIGEN_STRONG_INLINE double ei_pfirst<__m128d>(const __m128d& a) { return _mm_cvtsd_f64(a); }
 template<> EIGEN_STRONG_INLINE int    ei_pfirst<__m128i>(const __m128i& a) { return _mm_cvtsi128_si32(a); }
@@ -308,4 +320,112 @@ struct ei_palign_impl<Offset,__m128d>
 };
 #endif
 
+/***************************************************************************
+* complex<float>: a packet holds two complex numbers stored as (re0, im0, re1, im1)
+***************************************************************************/
+
+struct ei_packet2cf
+{
+  EIGEN_STRONG_INLINE ei_packet2cf() {}
+  EIGEN_STRONG_INLINE explicit ei_packet2cf(const __m128& a) : v(a) {}
+  __m128 v;
+};
+
+template<> struct ei_packet_traits<std::complex<float> > { typedef ei_packet2cf type; enum {size=2}; };
+template<> struct ei_unpacket_traits<ei_packet2cf> { typedef std::complex<float> type; enum {size=2}; };
+
+template<> EIGEN_STRONG_INLINE ei_packet2cf ei_pset1<std::complex<float> >(const std::complex<float>& from)
+{
+  return ei_packet2cf(_mm_setr_ps(ei_real(from), ei_imag(from), ei_real(from), ei_imag(from)));
+}
+
+template<> EIGEN_STRONG_INLINE ei_packet2cf ei_padd<ei_packet2cf>(const ei_packet2cf& a, const ei_packet2cf& b)
+{ return ei_packet2cf(_mm_add_ps(a.v,b.v)); }
+template<> EIGEN_STRONG_INLINE ei_packet2cf ei_psub<ei_packet2cf>(const ei_packet2cf& a, const ei_packet2cf& b)
+{ return ei_packet2cf(_mm_sub_ps(a.v,b.v)); }
+
+template<> EIGEN_STRONG_INLINE ei_packet2cf ei_pconj<ei_packet2cf>(const ei_packet2cf& a)
+{
+  const __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(0x00000000,0x80000000,0x00000000,0x80000000));
+  return ei_packet2cf(_mm_xor_ps(a.v,mask));
+}
+
+template<> EIGEN_STRONG_INLINE ei_packet2cf ei_pmul<ei_packet2cf>(const ei_packet2cf& a, const ei_packet2cf& b)
+{
+  // (ar*br - ai*bi, ai*br + ar*bi)
+  __m128 re = _mm_mul_ps(a.v, _mm_shuffle_ps(b.v, b.v, _MM_SHUFFLE(2,2,0,0)));
+  __m128 im = _mm_mul_ps(_mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2,3,0,1)), _mm_shuffle_ps(b.v, b.v, _MM_SHUFFLE(3,3,1,1)));
+  #ifdef __SSE3__
+  return ei_packet2cf(_mm_addsub_ps(re, im));
+  #else
+  const __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(0x80000000,0x00000000,0x80000000,0x00000000));
+  return ei_packet2cf(_mm_add_ps(re, _mm_xor_ps(im, mask)));
+  #endif
+}
+
+template<> EIGEN_STRONG_INLINE ei_packet2cf ei_pdiv<ei_packet2cf>(const ei_packet2cf& a, const ei_packet2cf& b)
+{
+  // a/b = a*conj(b) / |b|^2
+  __m128 num = ei_pmul(a, ei_pconj(b)).v;
+  __m128 b2 = _mm_mul_ps(b.v, b.v);
+  return ei_packet2cf(_mm_div_ps(num, _mm_add_ps(b2, _mm_shuffle_ps(b2, b2, _MM_SHUFFLE(2,3,0,1)))));
+}
+
+// complex numbers are not ordered: these select whole coefficients according to their real parts only,
+// like the std::min/std::max specializations of the packetmath test. They are never used by the
+// min/max functors, which do not have packet access for complex scalars.
+template<> EIGEN_STRONG_INLINE ei_packet2cf ei_pmin<ei_packet2cf>(const ei_packet2cf& a, const ei_packet2cf& b)
+{
+  __m128 mask = _mm_cmplt_ps(a.v, b.v);
+  mask = _mm_shuffle_ps(mask, mask, _MM_SHUFFLE(2,2,0,0));
+  return ei_packet2cf(_mm_or_ps(_mm_and_ps(mask, a.v), _mm_andnot_ps(mask, b.v)));
+}
+template<> EIGEN_STRONG_INLINE ei_packet2cf ei_pmax<ei_packet2cf>(const ei_packet2cf& a, const ei_packet2cf& b)
+{
+  __m128 mask = _mm_cmplt_ps(a.v, b.v);
+  mask = _mm_shuffle_ps(mask, mask, _MM_SHUFFLE(2,2,0,0));
+  return ei_packet2cf(_mm_or_ps(_mm_and_ps(mask, b.v), _mm_andnot_ps(mask, a.v)));
+}
+
+template<> EIGEN_STRONG_INLINE ei_packet2cf ei_pload<std::complex<float> >(const std::complex<float>* from)
+{ return ei_packet2cf(_mm_load_ps(reinterpret_cast<const float*>(from))); }
+template<> EIGEN_STRONG_INLINE ei_packet2cf ei_ploadu<std::complex<float> >(const std::complex<float>* from)
+{ return ei_packet2cf(_mm_loadu_ps(reinterpret_cast<const float*>(from))); }
+
+template<> EIGEN_STRONG_INLINE void ei_pstore<std::complex<float> >(std::complex<float>* to, const ei_packet2cf& from)
+{ _mm_store_ps(reinterpret_cast<float*>(to), from.v); }
+template<> EIGEN_STRONG_INLINE void ei_pstoreu<std::complex<float> >(std::complex<float>* to, const ei_packet2cf& from)
+{ _mm_storeu_ps(reinterpret_cast<float*>(to), from.v); }
+template<> EIGEN_STRONG_INLINE void ei_pstream<std::complex<float> >(std::complex<float>* to, const ei_packet2cf& from)
+{ _mm_stream_ps(reinterpret_cast<float*>(to), from.v); }
+template<> EIGEN_STRONG_INLINE void ei_pstream_fence<ei_packet2cf>() { _mm_sfence(); }
+
+template<> EIGEN_STRONG_INLINE std::complex<float> ei_pfirst<ei_packet2cf>(const ei_packet2cf& a)
+{
+  return std::complex<float>(_mm_cvtss_f32(a.v), _mm_cvtss_f32(_mm_shuffle_ps(a.v, a.v, 1)));
+}
+
+template<> EIGEN_STRONG_INLINE std::complex<float> ei_predux<ei_packet2cf>(const ei_packet2cf& a)
+{
+  return ei_pfirst(ei_packet2cf(_mm_add_ps(a.v, _mm_movehl_ps(a.v,a.v))));
+}
+
+template<> EIGEN_STRONG_INLINE ei_packet2cf ei_preduxp<ei_packet2cf>(const ei_packet2cf* vecs)
+{
+  return ei_packet2cf(_mm_add_ps(_mm_movelh_ps(vecs[0].v,vecs[1].v), _mm_movehl_ps(vecs[1].v,vecs[0].v)));
+}
+
+template<int Offset>
+struct ei_palign_impl<Offset,ei_packet2cf>
+{
+  EIGEN_STRONG_INLINE static void run(ei_packet2cf& first, const ei_packet2cf& second)
+  {
+    if (Offset==1)
+    {
+      first.v = _mm_movehl_ps(first.v, first.v);
+      first.v = _mm_movelh_ps(first.v, second.v);
+    }
+  }
+};
+
 #endif // EIGEN_PACKET_MATH_SSE_H
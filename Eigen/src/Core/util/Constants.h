@@ -178,11 +178,18 @@ const unsigned int LowerTriangularBit = 0x800;
   * means the expression includes sparse matrices and the sparse path has to be taken. */
 const unsigned int SparseBit = 0x1000;
 
+/** \ingroup flags
+  *
+  * means the coefficients of the expression must be computed once each and in order, e.g. because they
+  * are drawn from std::rand(), so that the expression cannot be evaluated by several threads */
+const unsigned int NonRepeatableBit = 0x2000;
+
 // list of flags that are inherited by default
 const unsigned int HereditaryBits = RowMajorBit
                                   | EvalBeforeNestingBit
                                   | EvalBeforeAssigningBit
-                                  | SparseBit;
+                                  | SparseBit
+                                  | NonRepeatableBit;
 
 // Possible values for the Mode parameter of part() and of extract()
 const unsigned int UpperTriangular = UpperTriangularBit;
@@ -196,7 +203,8 @@ const unsigned int UnitUpperTriangular = UpperTriangularBit | UnitDiagBit;
 const unsigned int UnitLowerTriangular = LowerTriangularBit | UnitDiagBit;
 const unsigned int Diagonal = UpperTriangular | LowerTriangular;
 
-enum { Aligned, Unaligned };
+// Streaming is only meaningful as a store mode: an aligned store bypassing the caches (see ei_pstream())
+enum { Aligned, Unaligned, Streaming };
 enum { ForceAligned, AsRequested };
 enum { ConditionalJumpCost = 5 };
 enum CornerType { TopLeft, TopRight, BottomLeft, BottomRight };
@@ -232,6 +240,13 @@ enum {
   AutoAlign = 0x2
 };
 
+// Possible values for the computation options of the SVD decompositions, which can be combined
+// with operator|. Skipping the singular vectors which are not needed saves most of the work.
+enum {
+  ComputeU = 0x1,
+  ComputeV = 0x2
+};
+
 enum {
   IsDense         = 0,
   IsSparse        = SparseBit,
@@ -34,6 +34,7 @@ template<typename _Scalar, int _Rows, int _Cols,
 
 template<typename ExpressionType, unsigned int Added, unsigned int Removed> class Flagged;
 template<typename ExpressionType> class NestByValue;
+template<typename ExpressionType> class NoAlias;
 template<typename ExpressionType> class SwapWrapper;
 template<typename MatrixType> class Minor;
 template<typename MatrixType, int BlockRows=Dynamic, int BlockCols=Dynamic, int PacketAccess=AsRequested,
@@ -92,9 +93,19 @@ struct IOFormat;
 template<typename Scalar>
 void ei_cache_friendly_product(
   int _rows, int _cols, int depth,
-  bool _lhsRowMajor, const Scalar* _lhs, int _lhsStride,
-  bool _rhsRowMajor, const Scalar* _rhs, int _rhsStride,
-  bool resRowMajor, Scalar* res, int resStride);
+  bool _lhsRowMajor, bool _conjLhs, const Scalar* _lhs, int _lhsStride,
+  bool _rhsRowMajor, bool _conjRhs, const Scalar* _rhs, int _rhsStride,
+  bool resRowMajor, Scalar* res, int resStride, Scalar alpha, Scalar beta);
+
+template<typename Scalar>
+void ei_cache_friendly_pack_lhs(int rows, int depth,
+  bool lhsRowMajor, bool conjLhs, const Scalar* lhs, int lhsStride, Scalar alpha, Scalar* packed);
+
+template<typename Scalar>
+void ei_cache_friendly_product_packed(
+  int rows, int cols, int depth, const Scalar* packedLhs,
+  bool rhsRowMajor, bool conjRhs, const Scalar* rhs, int rhsStride,
+  Scalar* res, int resStride, Scalar alpha);
 
 // Array module
 template<typename ConditionMatrixType, typename ThenMatrixType, typename ElseMatrixType> class Select;
@@ -102,6 +113,7 @@ template<typename MatrixType, typename BinaryOp, int Direction> class PartialRed
 template<typename ExpressionType, int Direction> class PartialRedux;
 
 template<typename MatrixType> class LU;
+template<typename MatrixType> class PartialPivLU;
 template<typename MatrixType> class QR;
 template<typename MatrixType> class SVD;
 template<typename MatrixType> class LLT;
@@ -60,6 +60,62 @@
 #define EIGEN_TUNE_FOR_CPU_CACHE_SIZE (sizeof(float)*256*256)
 #endif
 
+/** \internal Defines the minimal number of coefficients each thread has to reduce before sum(), dot(),
+  *            squaredNorm() and redux() split a dynamic-size reduction across several threads.
+  *            This only has an effect if OpenMP is enabled (see EIGEN_DONT_PARALLELIZE).
+  */
+#ifndef EIGEN_PARALLEL_REDUX_THRESHOLD
+#define EIGEN_PARALLEL_REDUX_THRESHOLD 65536
+#endif
+
+/** \internal Defines the minimal cost (number of coefficients times their read cost) each thread has to
+  *            assign before a dynamic-size assignment is split across several threads.
+  *            This only has an effect if OpenMP is enabled (see EIGEN_DONT_PARALLELIZE).
+  */
+#ifndef EIGEN_PARALLEL_ASSIGN_THRESHOLD
+#define EIGEN_PARALLEL_ASSIGN_THRESHOLD 131072
+#endif
+
+/** \internal Defines the maximal size in bytes of the block of the lhs packed by the matrix product kernel,
+  *            which is allocated on the stack. Products with a longer inner dimension are performed per slice
+  *            of the depth, so that this block never approaches the stack size of a thread.
+  */
+#ifndef EIGEN_PRODUCT_MAX_PACKED_LHS_SIZE
+#define EIGEN_PRODUCT_MAX_PACKED_LHS_SIZE (8*EIGEN_TUNE_FOR_CPU_CACHE_SIZE)
+#endif
+
+/** \internal Defines the width of the panels of the blocked decompositions (see LLT and LDLT). The updates
+  *            of the trailing matrix are then performed by the cache friendly matrix product, and are split
+  *            across several threads if OpenMP is enabled. Matrices smaller than twice this size are
+  *            factorized in a single panel.
+  */
+#ifndef EIGEN_DECOMPOSITION_BLOCK_SIZE
+#define EIGEN_DECOMPOSITION_BLOCK_SIZE 64
+#endif
+
+/** \internal Defines the minimal cost (number of multiply-adds times their cost) of the panel products each
+  *            thread has to perform before the update of the trailing matrix of a blocked decomposition is
+  *            split across several threads. This only has an effect if OpenMP is enabled (see EIGEN_DONT_PARALLELIZE).
+  */
+#ifndef EIGEN_PARALLEL_UPDATE_THRESHOLD
+#define EIGEN_PARALLEL_UPDATE_THRESHOLD 1048576
+#endif
+
+/** Defines the size in bytes above which a linearly vectorized assignment writes its destination
+  * with non-temporal stores (see MatrixBase::streamingAssign()). Such a destination is much larger than the
+  * last level cache, and caching it would only evict useful data.
+  */
+#ifndef EIGEN_STREAMING_STORE_THRESHOLD
+#define EIGEN_STREAMING_STORE_THRESHOLD (64*EIGEN_TUNE_FOR_CPU_CACHE_SIZE)
+#endif
+
+/** Defines the default minimal size in bytes of the blocks which follow the large allocation policy
+  * (see class LargeAllocationPolicy).
+  */
+#ifndef EIGEN_LARGE_ALLOCATION_THRESHOLD
+#define EIGEN_LARGE_ALLOCATION_THRESHOLD (32*1024*1024)
+#endif
+
 // FIXME this should go away quickly
 #ifdef EIGEN_TUNE_FOR_L2_CACHE_SIZE
 #error EIGEN_TUNE_FOR_L2_CACHE_SIZE is now called EIGEN_TUNE_FOR_CPU_CACHE_SIZE.
@@ -158,6 +214,41 @@ using Eigen::ei_cos;
 
 #define EIGEN_RESTRICT __restrict
 
+/* EIGEN_THREAD_LOCAL gives each thread its own instance of a static POD variable.
+ * It is left undefined when the compiler does not support it, in which case
+ * the per-thread scratch memory is disabled.
+ */
+#ifndef EIGEN_THREAD_LOCAL
+  #if (defined __GNUC__)
+    #define EIGEN_THREAD_LOCAL __thread
+  #elif (defined _MSC_VER)
+    #define EIGEN_THREAD_LOCAL __declspec(thread)
+  #endif
+#endif
+
+/* EIGEN_HAVE_RVALUE_REFERENCES is defined when the compiler supports the C++11 rvalue references.
+ * The dynamic-size objects then get move constructors and move assignment operators.
+ * MSVC 2010 to 2013 support rvalue references but never generate implicit move operations, so that
+ * with these compilers the classes without explicit ones, such as the decompositions, are still copied.
+ */
+#ifndef EIGEN_HAVE_RVALUE_REFERENCES
+  #if (__cplusplus >= 201103L) || (defined __GXX_EXPERIMENTAL_CXX0X__) || (defined _MSC_VER && _MSC_VER >= 1600)
+    #define EIGEN_HAVE_RVALUE_REFERENCES
+  #endif
+#endif
+
+/* EIGEN_NOEXCEPT marks the move operations as not throwing, so that the standard containers move the
+ * elements instead of copying them when they reallocate. It is empty for the compilers without noexcept.
+ */
+#ifndef EIGEN_NOEXCEPT
+  #if (__cplusplus >= 201103L) || (defined __GXX_EXPERIMENTAL_CXX0X__ && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))) \
+   || (defined _MSC_VER && _MSC_VER >= 1900)
+    #define EIGEN_NOEXCEPT noexcept
+  #else
+    #define EIGEN_NOEXCEPT
+  #endif
+#endif
+
 #ifndef EIGEN_STACK_ALLOCATION_LIMIT
 #define EIGEN_STACK_ALLOCATION_LIMIT 16000000
 #endif
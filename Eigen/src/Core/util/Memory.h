@@ -67,40 +67,414 @@ inline void ei_handmade_aligned_free(void *ptr)
     free(*(reinterpret_cast<void**>(ptr) - 1));
 }
 
-/** \internal allocates \a size bytes. The returned pointer is guaranteed to have 16 bytes alignment.
-  * On allocation error, the returned pointer is undefined, but if exceptions are enabled then a std::bad_alloc is thrown.
+#ifdef EIGEN_ALLOCATION_HOOKS
+
+/** \brief Heap usage of a thread, as recorded when EIGEN_ALLOCATION_HOOKS is defined
+  *
+  * \sa class AllocationTracker
   */
-inline void* ei_aligned_malloc(size_t size)
+struct AllocationStats
 {
-  #ifdef EIGEN_NO_MALLOC
-    ei_assert(false && "heap allocation is forbidden (EIGEN_NO_MALLOC is defined)");
+  size_t allocations;    ///< number of heap blocks allocated
+  size_t deallocations;  ///< number of heap blocks freed
+  size_t allocatedBytes; ///< total number of bytes allocated
+  size_t currentBytes;   ///< number of bytes currently allocated
+  size_t peakBytes;      ///< largest value currentBytes has reached
+};
+
+/** \internal per-thread accounting state of the allocation hooks */
+struct ei_allocation_state
+{
+  AllocationStats stats;
+  const char* tag;
+};
+
+/** \internal \returns the accounting state of the calling thread */
+inline ei_allocation_state& ei_thread_allocation_state()
+{
+  #ifdef EIGEN_THREAD_LOCAL
+  static EIGEN_THREAD_LOCAL ei_allocation_state state = { { 0, 0, 0, 0, 0 }, 0 };
+  #else
+  static ei_allocation_state state = { { 0, 0, 0, 0, 0 }, 0 };
+  #endif
+  return state;
+}
+
+/** \internal type of the functions called by Eigen on each heap allocation and deallocation */
+typedef void (*ei_allocation_hook)(const void* ptr, size_t size, const char* tag);
+
+/** \internal \returns the hooks shared by all threads: [0] is called on allocation, [1] on deallocation */
+inline ei_allocation_hook* ei_allocation_hooks()
+{
+  static ei_allocation_hook hooks[2] = { 0, 0 };
+  return hooks;
+}
+
+/** \internal records the allocation of the block \a ptr of \a size bytes */
+inline void ei_record_allocation(const void* ptr, size_t size)
+{
+  ei_allocation_state& state = ei_thread_allocation_state();
+  ++state.stats.allocations;
+  state.stats.allocatedBytes += size;
+  state.stats.currentBytes += size;
+  state.stats.peakBytes = std::max(state.stats.peakBytes, state.stats.currentBytes);
+  if(ei_allocation_hooks()[0])
+    ei_allocation_hooks()[0](ptr, size, state.tag);
+}
+
+/** \internal records the deallocation of the block \a ptr of \a size bytes */
+inline void ei_record_deallocation(const void* ptr, size_t size)
+{
+  ei_allocation_state& state = ei_thread_allocation_state();
+  ++state.stats.deallocations;
+  state.stats.currentBytes -= size;
+  if(ei_allocation_hooks()[1])
+    ei_allocation_hooks()[1](ptr, size, state.tag);
+}
+
+/** \internal \a block has been allocated with \a offset extra bytes, at least 16, in front of the \a size bytes
+  * requested by the user. Stores \a size and \a offset in the last 16 of them, records the allocation and
+  * \returns the user pointer. */
+inline void* ei_track_allocation(void* block, size_t size, size_t offset = 16)
+{
+  if(!block) return 0;
+  void* ptr = static_cast<char*>(block) + offset;
+  static_cast<size_t*>(ptr)[-2] = size;
+  static_cast<size_t*>(ptr)[-1] = offset;
+  ei_record_allocation(ptr, size);
+  return ptr;
+}
+
+/** \internal records the deallocation of the user pointer \a ptr returned by ei_track_allocation()
+  * and \returns the underlying block */
+inline void* ei_track_deallocation(void* ptr)
+{
+  if(!ptr) return 0;
+  ei_record_deallocation(ptr, static_cast<size_t*>(ptr)[-2]);
+  return static_cast<char*>(ptr) - static_cast<size_t*>(ptr)[-1];
+}
+
+/** \class AllocationTracker
+  *
+  * \brief Reports the heap allocations performed by Eigen
+  *
+  * This class is only available when EIGEN_ALLOCATION_HOOKS is defined before including Eigen.
+  * Then every block allocated by Eigen on the heap (the data of dynamic-size matrices, the large
+  * temporaries of the products and decompositions, the objects using EIGEN_MAKE_ALIGNED_OPERATOR_NEW, ...)
+  * is counted in the statistics of the calling thread, and the user hooks, if any, are called.
+  * Contrary to EIGEN_NO_MALLOC, which aborts on the first allocation, this lets you find which
+  * expressions allocate in a critical loop of a production build:
+  * \code
+  * #define EIGEN_ALLOCATION_HOOKS
+  * #include <Eigen/Core>
+  * void onAllocate(const void* ptr, size_t size, const char* tag)
+  * { std::cerr << (tag ? tag : "?") << ": " << size << " bytes\n"; }
+  * // ...
+  * AllocationTracker::setHooks(onAllocate, 0);
+  * AllocationTracker::resetStats();
+  * {
+  *   AllocationTag tag("update step");
+  *   c = a * b; // every allocation is reported with the tag "update step"
+  * }
+  * std::cerr << AllocationTracker::stats().allocations << " allocations\n";
+  * \endcode
+  * To this end each block is 16 bytes larger than requested, and stores its size. The blocks which follow
+  * a LargeAllocationPolicy are a huge page larger instead, so that they remain aligned on a huge page.
+  * Memory must be freed by the thread which allocated it for the statistics of that thread to remain exact.
+  *
+  * \sa class AllocationTag, struct AllocationStats
+  */
+class AllocationTracker
+{
+  public:
+    /** The type of the hooks. \a ptr and \a size describe the block, \a tag is the current
+      * tag of the thread (see class AllocationTag), or 0. */
+    typedef ei_allocation_hook Hook;
+
+    /** \returns the heap usage of the calling thread since the last call to resetStats() */
+    static const AllocationStats& stats() { return ei_thread_allocation_state().stats; }
+
+    /** Resets the statistics of the calling thread. The memory still in use is not counted anymore. */
+    static void resetStats()
+    {
+      AllocationStats& stats = ei_thread_allocation_state().stats;
+      stats.allocations = stats.deallocations = stats.allocatedBytes = stats.currentBytes = stats.peakBytes = 0;
+    }
+
+    /** Makes all the threads call \a onAllocate after each heap allocation, and \a onFree before
+      * each deallocation. Pass 0 to remove a hook. This is not thread safe: the hooks should be
+      * set while no other thread uses Eigen. */
+    static void setHooks(Hook onAllocate, Hook onFree)
+    {
+      ei_allocation_hooks()[0] = onAllocate;
+      ei_allocation_hooks()[1] = onFree;
+    }
+};
+
+/** \class AllocationTag
+  *
+  * \brief Labels the heap allocations of the calling thread while it is alive
+  *
+  * The \a tag passed to the constructor is given to the hooks of AllocationTracker, and the
+  * previous tag is restored by the destructor. The string is not copied.
+  *
+  * \sa class AllocationTracker
+  */
+class AllocationTag
+{
+  public:
+    explicit AllocationTag(const char* tag) : m_previous(ei_thread_allocation_state().tag)
+    {
+      ei_thread_allocation_state().tag = tag;
+    }
+    ~AllocationTag() { ei_thread_allocation_state().tag = m_previous; }
+  protected:
+    const char* m_previous;
+  private:
+    AllocationTag(const AllocationTag&);
+    AllocationTag& operator=(const AllocationTag&);
+};
+
+#endif // EIGEN_ALLOCATION_HOOKS
+
+#if (defined __linux__) && EIGEN_HAS_POSIX_MEMALIGN && !EIGEN_MALLOC_ALREADY_ALIGNED
+  #define EIGEN_HAS_LARGE_ALLOCATION_POLICY 1
+#else
+  #define EIGEN_HAS_LARGE_ALLOCATION_POLICY 0
+#endif
+
+/** \internal the policy applied by ei_aligned_malloc() to the large blocks (see class LargeAllocationPolicy) */
+struct ei_large_allocation_settings
+{
+  int policy;       // requested policy, a combination of LargeAllocationPolicy flags
+  size_t threshold; // minimal size in bytes of the blocks the policy applies to
+};
+
+/** \internal \returns the large allocation settings shared by all threads */
+inline ei_large_allocation_settings& ei_current_large_allocation_settings()
+{
+  static ei_large_allocation_settings settings = { 0, EIGEN_LARGE_ALLOCATION_THRESHOLD };
+  return settings;
+}
+
+/** \internal \returns the policy applied to the last large block allocated by the calling thread */
+inline int& ei_last_large_allocation_policy()
+{
+  #ifdef EIGEN_THREAD_LOCAL
+  static EIGEN_THREAD_LOCAL int applied = 0;
+  #else
+  static int applied = 0;
+  #endif
+  return applied;
+}
+
+/** \class LargeAllocationPolicy
+  *
+  * \brief Controls how the very large blocks are allocated
+  *
+  * Products and sparse matrix-vector products on matrices of several GB suffer from TLB misses, and,
+  * on machines with several NUMA nodes, from the first touch placement which puts all the pages on the
+  * node of the thread initializing the data. This class lets you opt in a special treatment of the blocks
+  * of at least \a threshold bytes allocated by Eigen, e.g., the coefficients of large dynamic-size matrices:
+  *  - \b HugePages: the block is aligned on a 2 MB boundary and advised to use transparent huge pages,
+  *  - \b NumaInterleave: the pages of the block are interleaved over all the allowed NUMA nodes,
+  *  - \b ParallelFirstTouch: the pages of the block are touched by the OpenMP threads, each thread
+  *    touching one contiguous range of pages. The parallel loops of Eigen which process the whole block
+  *    linearly split it the same way, but the other ones, e.g. those of the products, do not. This requires
+  *    OpenMP (see EIGEN_DONT_PARALLELIZE) and is useless together with NumaInterleave.
+  *
+  * \code
+  * LargeAllocationPolicy::set(LargeAllocationPolicy::HugePages | LargeAllocationPolicy::ParallelFirstTouch);
+  * MatrixXf a(20000,20000);
+  * std::cout << (LargeAllocationPolicy::lastApplied() & LargeAllocationPolicy::HugePages) << std::endl;
+  * \endcode
+  * Each part of the policy depends on the support of the operating system, and may be refused, e.g., if
+  * transparent huge pages are disabled: lastApplied() tells which parts have actually been applied.
+  * This is only supported on Linux. Elsewhere the policy is ignored.
+  */
+class LargeAllocationPolicy
+{
+  public:
+    enum {
+      None = 0x0,
+      HugePages = 0x1,
+      NumaInterleave = 0x2,
+      ParallelFirstTouch = 0x4
+    };
+
+    /** Applies \a policy to the blocks of at least \a threshold bytes allocated by any thread
+      * from now on. This is not thread safe. */
+    static void set(int policy, size_t threshold = EIGEN_LARGE_ALLOCATION_THRESHOLD)
+    {
+      ei_current_large_allocation_settings().policy = policy;
+      ei_current_large_allocation_settings().threshold = threshold;
+    }
+
+    /** \returns the requested policy */
+    static int policy() { return ei_current_large_allocation_settings().policy; }
+
+    /** \returns the minimal size of the blocks the policy applies to */
+    static size_t threshold() { return ei_current_large_allocation_settings().threshold; }
+
+    /** \returns the parts of the policy which have actually been applied to the last block of at least
+      * threshold() bytes allocated by the calling thread, or None if there is no such block */
+    static int lastApplied() { return ei_last_large_allocation_policy(); }
+};
+
+#if EIGEN_HAS_LARGE_ALLOCATION_POLICY
+// the values of MPOL_INTERLEAVE and MPOL_F_MEMS_ALLOWED, which are part of the ABI of the Linux kernel:
+// <numaif.h> is not always installed, and declares MPOL_INTERLEAVE as an enumerator rather than a macro
+#ifndef EIGEN_MPOL_INTERLEAVE
+#define EIGEN_MPOL_INTERLEAVE 3
+#endif
+#ifndef EIGEN_MPOL_F_MEMS_ALLOWED
+#define EIGEN_MPOL_F_MEMS_ALLOWED (1<<2)
+#endif
+
+/** \internal writes the first byte of the pages \a start to \a end of \a data */
+struct ei_first_touch_kernel
+{
+  ei_first_touch_kernel(char* data, size_t pageSize) : m_data(data), m_pageSize(pageSize) {}
+  void operator()(int start, int end) const
+  {
+    for(int i=start; i<end; ++i)
+      m_data[i*m_pageSize] = 0;
+  }
+  char* m_data;
+  size_t m_pageSize;
+};
+
+/** \internal \returns the size of the huge pages, on which the large blocks are aligned */
+inline size_t ei_huge_page_size() { return size_t(2)*1024*1024; }
+
+/** \internal allocates \a size bytes following the large allocation policy \a policy, after \a offset bytes
+  * which are left alone, \a offset being a multiple of ei_huge_page_size(). The block is aligned on a huge page
+  * and can be freed by free(). \returns 0 on failure, in which case LargeAllocationPolicy::lastApplied() is None. */
+inline void* ei_large_aligned_malloc(size_t size, int policy, size_t offset = 0)
+{
+  ei_internal_assert(offset % ei_huge_page_size() == 0);
+  void *result;
+  if(posix_memalign(&result, ei_huge_page_size(), offset + size))
+  {
+    // there is no such block
+    ei_last_large_allocation_policy() = LargeAllocationPolicy::None;
+    return 0;
+  }
+  char* data = static_cast<char*>(result) + offset;
+  const size_t pageSize = sysconf(_SC_PAGESIZE);
+  const size_t length = size & ~(pageSize-1);
+  int applied = 0;
+  // the policy only applies to the whole pages of the block, a block smaller than a page is left alone
+  if(length==0)
+    policy = LargeAllocationPolicy::None;
+
+  #ifdef MADV_HUGEPAGE
+  if((policy & LargeAllocationPolicy::HugePages) && madvise(data, length, MADV_HUGEPAGE)==0)
+    applied |= LargeAllocationPolicy::HugePages;
+  #endif
+
+  #if (defined SYS_mbind) && (defined SYS_get_mempolicy)
+  if(policy & LargeAllocationPolicy::NumaInterleave)
+  {
+    // interleave over the nodes the thread may allocate on, if there are several of them
+    const int MaxNodes = 1024;
+    const int BitsPerWord = 8*sizeof(unsigned long);
+    unsigned long nodes[MaxNodes/BitsPerWord];
+    int mode, nodeCount = 0;
+    if(syscall(SYS_get_mempolicy, &mode, nodes, MaxNodes, 0, EIGEN_MPOL_F_MEMS_ALLOWED)==0)
+      for(int i=0; i<MaxNodes; ++i)
+        nodeCount += (nodes[i/BitsPerWord] >> (i%BitsPerWord)) & 1;
+    if(nodeCount>1 && syscall(SYS_mbind, data, length, EIGEN_MPOL_INTERLEAVE, nodes, MaxNodes, 0)==0)
+      applied |= LargeAllocationPolicy::NumaInterleave;
+  }
+  #endif
+
+  #ifdef EIGEN_PARALLELIZE
+  if((policy & LargeAllocationPolicy::ParallelFirstTouch) && ei_max_threads()>1)
+  {
+    // one contiguous range of pages per thread, split by ei_parallelize() like the linear loops over the whole block
+    ei_first_touch_kernel kernel(data, pageSize);
+    ei_parallelize(kernel, int(length/pageSize), 1);
+    applied |= LargeAllocationPolicy::ParallelFirstTouch;
+  }
+  #endif
+
+  ei_last_large_allocation_policy() = applied;
+  return result;
+}
+#endif
+
+/** \internal like ei_aligned_malloc(), but also allowed when EIGEN_NO_MALLOC is defined. This is only
+  * used for the memory the user explicitly asks for, like the reserve of a ScratchScope.
+  */
+inline void* ei_unchecked_aligned_malloc(size_t size)
+{
+  #ifdef EIGEN_ALLOCATION_HOOKS
+    const size_t requested = size;
+    size_t offset = 16;
+    size += offset;
   #endif
 
   void *result;
-  #if EIGEN_HAS_POSIX_MEMALIGN && !EIGEN_MALLOC_ALREADY_ALIGNED
+  #if EIGEN_HAS_LARGE_ALLOCATION_POLICY
+  const ei_large_allocation_settings& large = ei_current_large_allocation_settings();
+  if(large.policy && size>=large.threshold)
+  {
+    #ifdef EIGEN_ALLOCATION_HOOKS
+      // the header gets a whole huge page, so that the user block remains aligned on a huge page. Only the
+      // page of the header is touched.
+      offset = ei_huge_page_size();
+      result = ei_large_aligned_malloc(requested, large.policy, offset);
+    #else
+      result = ei_large_aligned_malloc(size, large.policy);
+    #endif
     #ifdef EIGEN_EXCEPTIONS
-      const int failed =
+      if(!result) throw std::bad_alloc();
     #endif
-    posix_memalign(&result, 16, size);
-  #else
-    #if EIGEN_MALLOC_ALREADY_ALIGNED
-      result = malloc(size);
-    #elif EIGEN_HAS_MM_MALLOC
-      result = _mm_malloc(size, 16);
-    #elif (defined _MSC_VER)
-      result = _aligned_malloc(size, 16);
+  }
+  else
+  #endif
+  {
+    #if EIGEN_HAS_POSIX_MEMALIGN && !EIGEN_MALLOC_ALREADY_ALIGNED
+      #ifdef EIGEN_EXCEPTIONS
+        const int failed =
+      #endif
+      posix_memalign(&result, 16, size);
     #else
-      result = ei_handmade_aligned_malloc(size);
+      #if EIGEN_MALLOC_ALREADY_ALIGNED
+        result = malloc(size);
+      #elif EIGEN_HAS_MM_MALLOC
+        result = _mm_malloc(size, 16);
+      #elif (defined _MSC_VER)
+        result = _aligned_malloc(size, 16);
+      #else
+        result = ei_handmade_aligned_malloc(size);
+      #endif
+      #ifdef EIGEN_EXCEPTIONS
+        const int failed = (result == 0);
+      #endif
     #endif
     #ifdef EIGEN_EXCEPTIONS
-      const int failed = (result == 0);
+      if(failed)
+        throw std::bad_alloc();
     #endif
+  }
+  #ifdef EIGEN_ALLOCATION_HOOKS
+    return ei_track_allocation(result, requested, offset);
+  #else
+    return result;
   #endif
-  #ifdef EIGEN_EXCEPTIONS
-    if(failed)
-      throw std::bad_alloc();
+}
+
+/** \internal allocates \a size bytes. The returned pointer is guaranteed to have 16 bytes alignment.
+  * On allocation error, the returned pointer is undefined, but if exceptions are enabled then a std::bad_alloc is thrown.
+  */
+inline void* ei_aligned_malloc(size_t size)
+{
+  #ifdef EIGEN_NO_MALLOC
+    ei_assert(false && "heap allocation is forbidden (EIGEN_NO_MALLOC is defined)");
   #endif
-  return result;
+  return ei_unchecked_aligned_malloc(size);
 }
 
 /** allocates \a size bytes. If Align is true, then the returned ptr is 16-byte-aligned.
@@ -117,7 +491,11 @@ template<> inline void* ei_conditional_aligned_malloc<false>(size_t size)
     ei_assert(false && "heap allocation is forbidden (EIGEN_NO_MALLOC is defined)");
   #endif
 
-  void *result = malloc(size);
+  #ifdef EIGEN_ALLOCATION_HOOKS
+    void *result = ei_track_allocation(malloc(size+16), size);
+  #else
+    void *result = malloc(size);
+  #endif
   #ifdef EIGEN_EXCEPTIONS
     if(!result) throw std::bad_alloc();
   #endif
@@ -144,6 +522,9 @@ template<typename T, bool Align> inline T* ei_conditional_aligned_new(size_t siz
   */
 inline void ei_aligned_free(void *ptr)
 {
+  #ifdef EIGEN_ALLOCATION_HOOKS
+    ptr = ei_track_deallocation(ptr);
+  #endif
   #if EIGEN_MALLOC_ALREADY_ALIGNED
     free(ptr);
   #elif EIGEN_HAS_POSIX_MEMALIGN
@@ -166,6 +547,9 @@ template<bool Align> inline void ei_conditional_aligned_free(void *ptr)
 
 template<> inline void ei_conditional_aligned_free<false>(void *ptr)
 {
+  #ifdef EIGEN_ALLOCATION_HOOKS
+    ptr = ei_track_deallocation(ptr);
+  #endif
   free(ptr);
 }
 
@@ -196,6 +580,108 @@ template<typename T, bool Align> inline void ei_conditional_aligned_delete(T *pt
   ei_conditional_aligned_free<Align>(ptr);
 }
 
+/** \internal the functions allocating the coefficients of the dynamic-size matrices and of the
+  * sparse storages, or 0 to use ei_aligned_malloc() (see class StorageAllocator) */
+struct ei_storage_allocator
+{
+  void* (*allocate)(size_t size);
+  void (*deallocate)(void* ptr, size_t size);
+};
+
+/** \internal \returns the storage allocator shared by all threads */
+inline ei_storage_allocator& ei_current_storage_allocator()
+{
+  static ei_storage_allocator allocator = { 0, 0 };
+  return allocator;
+}
+
+/** \internal allocates and default-constructs \a size objects of type T with the storage allocator.
+  * The returned pointer is guaranteed to have 16 bytes alignment. */
+template<typename T> inline T* ei_storage_new(size_t size)
+{
+  const ei_storage_allocator& allocator = ei_current_storage_allocator();
+  if(!allocator.allocate)
+    return ei_aligned_new<T>(size);
+  void *void_result = allocator.allocate(sizeof(T)*size);
+  if(!void_result)
+  {
+    // like malloc, the user allocator may return a null pointer for 0 bytes
+    #ifdef EIGEN_EXCEPTIONS
+      if(size>0) throw std::bad_alloc();
+    #endif
+    return 0;
+  }
+  ei_assert(size_t(void_result)%16==0 && "the storage allocator must return 16 bytes aligned memory");
+  #ifdef EIGEN_ALLOCATION_HOOKS
+    ei_record_allocation(void_result, sizeof(T)*size);
+  #endif
+  return ::new(void_result) T[size];
+}
+
+/** \internal deletes objects constructed with ei_storage_new()
+  * The \a size parameters tells on how many objects to call the destructor of T.
+  */
+template<typename T> inline void ei_storage_delete(T *ptr, size_t size)
+{
+  const ei_storage_allocator& allocator = ei_current_storage_allocator();
+  if(!allocator.deallocate)
+  {
+    ei_aligned_delete(ptr, size);
+    return;
+  }
+  if(!ptr) return;
+  ei_delete_elements_of_array<T>(ptr, size);
+  #ifdef EIGEN_ALLOCATION_HOOKS
+    ei_record_deallocation(ptr, sizeof(T)*size);
+  #endif
+  allocator.deallocate(ptr, sizeof(T)*size);
+}
+
+/** \class StorageAllocator
+  *
+  * \brief Lets the user provide the memory of the dynamic-size matrices
+  *
+  * By default the coefficients of the dynamic-size matrices and vectors, of SparseMatrix, SparseVector
+  * and of the internal sparse accumulators are allocated with Eigen's aligned malloc. Calling
+  * StorageAllocator::set() replaces it by user functions, e.g., to put large matrices on huge pages,
+  * in a NUMA-local pool, or in shared memory:
+  * \code
+  * void* myAllocate(size_t size) { return myPool.allocate(size, 16); }
+  * void myDeallocate(void* ptr, size_t size) { myPool.deallocate(ptr, size); }
+  * int main()
+  * {
+  *   StorageAllocator::set(myAllocate, myDeallocate);
+  *   MatrixXf m(1000,1000); // allocated by myAllocate
+  * }
+  * \endcode
+  * The allocation function must return memory aligned on a 16 bytes boundary, which the vectorized
+  * code relies on, and may be called with a \a size of 0, in which case it may return a null pointer.
+  * The deallocation function receives the size which was passed to the allocation, and is not called
+  * on null pointers.
+  *
+  * The allocator is global: it must be set while no dynamic-size object exists, since the memory of
+  * an object is always given back to the current allocator. The internal temporaries which are not
+  * matrices (see ScratchScope) keep using Eigen's aligned malloc.
+  */
+class StorageAllocator
+{
+  public:
+    typedef void* (*AllocateFunction)(size_t size);
+    typedef void (*DeallocateFunction)(void* ptr, size_t size);
+
+    /** Makes all the dynamic-size storages use \a allocate and \a deallocate. Passing 0 for both
+      * restores the default allocator. */
+    static void set(AllocateFunction allocate, DeallocateFunction deallocate)
+    {
+      ei_assert((allocate==0) == (deallocate==0) && "the two functions must be set together");
+      ei_current_storage_allocator().allocate = allocate;
+      ei_current_storage_allocator().deallocate = deallocate;
+    }
+
+    /** \returns true if user functions are currently set */
+    static bool isSet() { return ei_current_storage_allocator().allocate != 0; }
+};
+
 /** \internal \returns the number of elements which have to be skipped such that data are 16 bytes aligned */
 template<typename Scalar>
 inline static int ei_alignmentOffset(const Scalar* ptr, int maxOffset)
@@ -210,11 +696,235 @@ inline static int ei_alignmentOffset(const Scalar* ptr, int maxOffset)
           : 0;
 }
 
+/** \internal per-thread bump allocator backing the internal temporaries which are too large
+  * for the stack. It only owns memory while a ScratchScope is alive in the calling thread;
+  * otherwise every request is forwarded to ei_aligned_malloc().
+  * Allocations are released in reverse order, like stack allocations.
+  */
+struct ei_scratch_arena
+{
+  char* data;      // the current block, or 0
+  size_t capacity; // size of the current block in bytes
+  size_t top;      // number of bytes currently handed out
+  size_t last;     // offset of the last allocation which has not been freed, 0 if there is none
+  size_t peak;     // largest top which has been requested since the outermost scope was opened
+  int scopes;      // number of alive ScratchScope in this thread
+};
+
+/** \internal the 16 bytes in front of each allocation of the scratch arena. They chain the allocations
+  * which have not been released yet, so that a free in the wrong order cannot release live memory. */
+struct ei_scratch_header
+{
+  size_t previous; // offset of the previous allocation which has not been released, 0 if there is none
+  size_t freed;    // whether ei_scratch_free() has been called on this allocation
+};
+
+#ifdef EIGEN_THREAD_LOCAL
+inline ei_scratch_arena& ei_thread_scratch_arena()
+{
+  static EIGEN_THREAD_LOCAL ei_scratch_arena arena = { 0, 0, 0, 0, 0, 0 };
+  return arena;
+}
+
+/** \internal \returns the header of the allocation at \a offset in the arena \a a */
+inline ei_scratch_header& ei_scratch_header_at(ei_scratch_arena& a, size_t offset)
+{
+  return *reinterpret_cast<ei_scratch_header*>(a.data + offset - 16);
+}
+
+/** \internal replaces the block of the arena \a a, which must be empty, by a block of \a size bytes.
+  * This is the only place where the arena itself touches the heap. The block goes through the same
+  * allocator as the other temporaries, so that it is seen by the allocation hooks and follows the
+  * large allocation policy. */
+inline void ei_scratch_arena_resize(ei_scratch_arena& a, size_t size)
+{
+  ei_assert(a.top==0 && "the scratch memory is still in use");
+  ei_aligned_free(a.data);
+  a.data = size ? static_cast<char*>(ei_unchecked_aligned_malloc(size)) : 0;
+  a.capacity = size;
+}
+#endif
+
+/** \internal allocates \a size bytes of 16 bytes aligned scratch memory. The memory
+  * \b must be freed by ei_scratch_free() in the reverse order of the allocations. */
+inline void* ei_scratch_alloc(size_t size)
+{
+  #ifdef EIGEN_THREAD_LOCAL
+  ei_scratch_arena& a = ei_thread_scratch_arena();
+  const size_t bytes = 16 + ((size+15) & ~size_t(15));
+  if(a.scopes>0 && a.top==0 && a.peak>a.capacity)
+  {
+    // the previous requests did not fit: grow once to what they needed
+    #ifdef EIGEN_NO_MALLOC
+      ei_assert(false && "heap allocation is forbidden (EIGEN_NO_MALLOC is defined), reserve more scratch memory");
+    #endif
+    ei_scratch_arena_resize(a, a.peak);
+  }
+  if(a.top+bytes <= a.capacity)
+  {
+    const size_t offset = a.top + 16;
+    ei_scratch_header& header = ei_scratch_header_at(a, offset);
+    header.previous = a.last;
+    header.freed = 0;
+    a.last = offset;
+    a.top += bytes;
+    return a.data + offset;
+  }
+  if(a.scopes>0)
+    a.peak = std::max(a.peak, a.top+bytes);
+  #endif
+  return ei_aligned_malloc(size);
+}
+
+/** \internal frees memory allocated with ei_scratch_alloc().
+  *
+  * Freeing an allocation which is not the last one is an error, which is asserted. Even when assertions
+  * are disabled, such an allocation is only marked as freed: it is released, together with the memory
+  * above it, once the allocations above it have been freed too. Freeing an allocation twice is a no-op.
+  */
+inline void ei_scratch_free(void* ptr)
+{
+  #ifdef EIGEN_THREAD_LOCAL
+  ei_scratch_arena& a = ei_thread_scratch_arena();
+  if(ptr>=a.data && ptr<a.data+a.capacity)
+  {
+    const size_t offset = static_cast<char*>(ptr) - a.data;
+    if(offset>=a.top || ei_scratch_header_at(a, offset).freed)
+    {
+      ei_assert(false && "scratch memory freed twice");
+      return;
+    }
+    ei_scratch_header_at(a, offset).freed = 1;
+    const bool inOrder = offset==a.last;
+    // release the last allocation, and the ones below it which were freed out of order
+    while(a.last!=0 && ei_scratch_header_at(a, a.last).freed)
+    {
+      a.top = a.last - 16;
+      a.last = ei_scratch_header_at(a, a.last).previous;
+    }
+    ei_assert(inOrder && "scratch memory freed out of order");
+    return;
+  }
+  #endif
+  ei_aligned_free(ptr);
+}
+
+/** \internal allocates and default-constructs \a size objects of type T in the scratch memory */
+template<typename T> inline T* ei_scratch_new(size_t size)
+{
+  return ::new(ei_scratch_alloc(sizeof(T)*size)) T[size];
+}
+
+/** \internal deletes objects constructed with ei_scratch_new() */
+template<typename T> inline void ei_scratch_delete(T *ptr, size_t size)
+{
+  ei_delete_elements_of_array<T>(ptr, size);
+  ei_scratch_free(ptr);
+}
+
+/** \internal storage for \a Size objects of type T, 16 bytes aligned, used by the algorithms
+  * to hold their work vectors. It is a plain array when Size is known at compile time, and
+  * lives in the scratch memory otherwise.
+  */
+template<typename T, int Size> class ei_scratch_buffer
+{
+  public:
+    explicit ei_scratch_buffer(int size) { ei_assert(size<=Size); static_cast<void>(size); }
+    inline T* data() { return m_data; }
+  protected:
+    EIGEN_ALIGN_128 T m_data[Size];
+};
+
+template<typename T> class ei_scratch_buffer<T, Dynamic>
+{
+  public:
+    explicit ei_scratch_buffer(int size) : m_data(ei_scratch_new<T>(size)), m_size(size) {}
+    ~ei_scratch_buffer() { ei_scratch_delete<T>(m_data, m_size); }
+    inline T* data() { return m_data; }
+  protected:
+    T* m_data;
+    int m_size;
+  private:
+    ei_scratch_buffer(const ei_scratch_buffer&);
+    ei_scratch_buffer& operator=(const ei_scratch_buffer&);
+};
+
+/** \class ScratchScope
+  *
+  * \brief Keeps the internal temporaries of the calling thread off the heap
+  *
+  * Products, solvers and decompositions need temporary buffers. The small ones live on the stack,
+  * while the others are taken from a per-thread scratch memory. Outside of any ScratchScope, this
+  * memory is freed as soon as it is not used anymore, so each large temporary costs a heap allocation.
+  * While a ScratchScope is alive, the scratch memory of its thread is kept, and it grows to the
+  * largest amount of memory the previous operations have needed. Hence a loop running the same
+  * computations does not allocate anymore after its first iterations:
+  * \code
+  * MatrixXf a(1000,1000), b(1000,1000), c(1000,1000);
+  * {
+  *   ScratchScope scratch(64*1024*1024); // optional initial size in bytes
+  *   for(int i=0; i<n; ++i)
+  *   {
+  *     // ... update a and b
+  *     c.noalias() = a * b; // the packed blocks of a and b are taken from the scratch memory
+  *   }
+  * } // the scratch memory is freed here
+  * \endcode
+  * Scopes can be nested, the memory is released when the outermost one is destroyed.
+  * Only the requests made while a scope is alive are taken into account to size the scratch memory.
+  * When the compiler does not support thread local storage (see EIGEN_THREAD_LOCAL),
+  * this class does nothing.
+  */
+class ScratchScope
+{
+  public:
+    /** Opens a scope, and makes sure at least \a reserveBytes bytes of scratch memory are available.
+      * Each temporary takes 16 more bytes than its size, rounded up to a multiple of 16. */
+    explicit ScratchScope(size_t reserveBytes = 0)
+    {
+      #ifdef EIGEN_THREAD_LOCAL
+      ei_scratch_arena& a = ei_thread_scratch_arena();
+      ++a.scopes;
+      if(reserveBytes>a.capacity && a.top==0)
+        ei_scratch_arena_resize(a, (reserveBytes+15) & ~size_t(15));
+      #else
+      static_cast<void>(reserveBytes); // suppress unused variable warning
+      #endif
+    }
+
+    ~ScratchScope()
+    {
+      #ifdef EIGEN_THREAD_LOCAL
+      ei_scratch_arena& a = ei_thread_scratch_arena();
+      if(--a.scopes==0)
+      {
+        ei_scratch_arena_resize(a, 0);
+        a.peak = 0;
+      }
+      #endif
+    }
+
+    /** \returns the number of bytes of scratch memory currently owned by the calling thread */
+    static size_t capacity()
+    {
+      #ifdef EIGEN_THREAD_LOCAL
+      return ei_thread_scratch_arena().capacity;
+      #else
+      return 0;
+      #endif
+    }
+
+  private:
+    ScratchScope(const ScratchScope&);
+    ScratchScope& operator=(const ScratchScope&);
+};
+
 /** \internal
   * ei_aligned_stack_alloc(SIZE) allocates an aligned buffer of SIZE bytes
   * on the stack if SIZE is smaller than EIGEN_STACK_ALLOCATION_LIMIT.
-  * Otherwise the memory is allocated on the heap.
-  * Data allocated with ei_aligned_stack_alloc \b must be freed by calling ei_aligned_stack_free(PTR,SIZE).
+  * Otherwise the memory is taken from the scratch memory of the thread (see class ScratchScope).
+  * Data allocated with ei_aligned_stack_alloc \b must be freed by calling ei_aligned_stack_free(PTR,SIZE),
+  * in the reverse order of the allocations.
   * \code
   * float * data = ei_aligned_stack_alloc(float,array.size());
   * // ...
@@ -224,11 +934,11 @@ inline static int ei_alignmentOffset(const Scalar* ptr, int maxOffset)
 #ifdef __linux__
   #define ei_aligned_stack_alloc(SIZE) (SIZE<=EIGEN_STACK_ALLOCATION_LIMIT) \
                                     ? alloca(SIZE) \
-                                    : ei_aligned_malloc(SIZE)
-  #define ei_aligned_stack_free(PTR,SIZE) if(SIZE>EIGEN_STACK_ALLOCATION_LIMIT) ei_aligned_free(PTR)
+                                    : ei_scratch_alloc(SIZE)
+  #define ei_aligned_stack_free(PTR,SIZE) if(SIZE>EIGEN_STACK_ALLOCATION_LIMIT) ei_scratch_free(PTR)
 #else
-  #define ei_aligned_stack_alloc(SIZE) ei_aligned_malloc(SIZE)
-  #define ei_aligned_stack_free(PTR,SIZE) ei_aligned_free(PTR)
+  #define ei_aligned_stack_alloc(SIZE) ei_scratch_alloc(SIZE)
+  #define ei_aligned_stack_free(PTR,SIZE) ei_scratch_free(PTR)
 #endif
 
 #define ei_aligned_stack_new(TYPE,SIZE) ::new(ei_aligned_stack_alloc(sizeof(TYPE)*SIZE)) TYPE[SIZE]
@@ -374,4 +1084,11 @@ public:
     }
 };
 
+/** \internal all the aligned allocators are interchangeable */
+template<class T1, class T2>
+inline bool operator==(const aligned_allocator<T1>&, const aligned_allocator<T2>&) { return true; }
+
+template<class T1, class T2>
+inline bool operator!=(const aligned_allocator<T1>&, const aligned_allocator<T2>&) { return false; }
+
 #endif // EIGEN_MEMORY_H
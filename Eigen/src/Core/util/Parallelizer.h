@@ -0,0 +1,102 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra. Eigen itself is part of the KDE project.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_PARALLELIZER_H
+#define EIGEN_PARALLELIZER_H
+
+/** \internal \returns the number of threads the parallel kernels are allowed to use from the calling context.
+  * This is always 1 if OpenMP is not enabled (see EIGEN_DONT_PARALLELIZE), or if we already are inside
+  * a parallel region, so that nested calls never oversubscribe the machine.
+  */
+inline int ei_max_threads()
+{
+  #ifdef EIGEN_PARALLELIZE
+    return omp_in_parallel() ? 1 : omp_get_max_threads();
+  #else
+    return 1;
+  #endif
+}
+
+/** \internal \returns the number of chunks a loop over \a size coefficients has to be split into,
+  * such that each chunk holds at least \a threshold coefficients and there is at most one chunk per thread.
+  */
+inline int ei_parallel_chunks(int size, int threshold)
+{
+  const int maxChunks = size / std::max(threshold, 1);
+  return maxChunks < 2 ? 1 : std::min(ei_max_threads(), maxChunks);
+}
+
+/** \internal Calls \a kernel(start,end) on contiguous sub-ranges covering [0,\a size), one per thread.
+  * Each chunk holds at least \a threshold units, and all but the last one hold a multiple of \a granularity units.
+  * The kernel must be safe to call concurrently on disjoint ranges.
+  */
+template<typename Kernel>
+inline void ei_parallelize(const Kernel& kernel, int size, int threshold, int granularity = 1)
+{
+  #ifdef EIGEN_PARALLELIZE
+  const int chunks = ei_parallel_chunks(size, threshold);
+  if(chunks > 1)
+  {
+    const int chunkSize = ((size/chunks + granularity - 1) / granularity) * granularity;
+    #pragma omp parallel for num_threads(chunks)
+    for(int c = 0; c < chunks; ++c)
+    {
+      const int start = std::min(c*chunkSize, size);
+      const int end = c+1 == chunks ? size : std::min(start+chunkSize, size);
+      if(start < end)
+        kernel(start, end);
+    }
+    return;
+  }
+  #else
+  static_cast<void>(threshold); // suppress unused variable warning
+  static_cast<void>(granularity);
+  #endif
+  kernel(0, size);
+}
+
+/** \internal Calls \a kernel(start,end) on the consecutive sub-ranges of \a granularity units covering [0,\a size),
+  * in order. They are handed out to the threads as soon as these are idle, with one thread per \a threshold units
+  * at most, which balances the loops whose units do not have the same cost.
+  * The kernel must be safe to call concurrently on disjoint ranges.
+  */
+template<typename Kernel>
+inline void ei_parallelize_dynamic(const Kernel& kernel, int size, int threshold, int granularity)
+{
+  #ifdef EIGEN_PARALLELIZE
+  const int threads = ei_parallel_chunks(size, threshold);
+  if(threads > 1)
+  {
+    const int count = (size + granularity - 1) / granularity;
+    #pragma omp parallel for num_threads(threads) schedule(dynamic)
+    for(int c = 0; c < count; ++c)
+      kernel(c*granularity, std::min((c+1)*granularity, size));
+    return;
+  }
+  #else
+  static_cast<void>(threshold); // suppress unused variable warning
+  static_cast<void>(granularity);
+  #endif
+  kernel(0, size);
+}
+
+#endif // EIGEN_PARALLELIZER_H
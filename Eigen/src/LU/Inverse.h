@@ -160,7 +160,7 @@ struct ei_compute_inverse
 {
   static inline void run(const MatrixType& matrix, MatrixType* result)
   {
-    LU<MatrixType> lu(matrix);
+    PartialPivLU<MatrixType> lu(matrix);
     lu.computeInverse(result);
   }
 };
@@ -92,11 +92,23 @@ template<typename MatrixType> class LU
                    MatrixType::MaxColsAtCompileTime  // so it has the same number of rows and at most as many columns.
     > ImageResultType;
 
+    /** Default Constructor.
+      *
+      * The default constructor is useful in cases in which the user intends to
+      * perform decompositions via LU::compute(const MatrixType&).
+      */
+    LU() : m_originalMatrix(0), m_det_pq(0), m_rank(0) {}
+
     /** Constructor.
       *
       * \param matrix the matrix of which to compute the LU decomposition.
       */
-    LU(const MatrixType& matrix);
+    LU(const MatrixType& matrix) : m_originalMatrix(0), m_det_pq(0), m_rank(0)
+    {
+      compute(matrix);
+    }
+
+    void compute(const MatrixType& matrix);
 
     /** \returns the LU decomposition matrix: the upper-triangular part is U, the
       * unit-lower-triangular part is L (at least for square matrices; in the non-square
@@ -317,7 +329,7 @@ template<typename MatrixType> class LU
     }
 
   protected:
-    const MatrixType& m_originalMatrix;
+    const MatrixType* m_originalMatrix;
     MatrixType m_lu;
     IntColVectorType m_p;
     IntRowVectorType m_q;
@@ -325,19 +337,30 @@ template<typename MatrixType> class LU
     int m_rank;
 };
 
+/** Computes / recomputes the LU decomposition A = PLUQ of \a matrix
+  *
+  * The storage of the decomposition is reused when \a matrix has the same size as the previous one,
+  * and the work vectors come from the scratch memory (see class ScratchScope), so decomposing matrices
+  * of a given size in a loop does not allocate after the first iteration.
+  *
+  * The decomposition keeps a reference to \a matrix, which is used by computeImage() and image().
+  */
 template<typename MatrixType>
-LU<MatrixType>::LU(const MatrixType& matrix)
-  : m_originalMatrix(matrix),
-    m_lu(matrix),
-    m_p(matrix.rows()),
-    m_q(matrix.cols())
+void LU<MatrixType>::compute(const MatrixType& matrix)
 {
+  m_originalMatrix = &matrix;
+  m_lu = matrix;
+  m_p.resize(matrix.rows());
+  m_q.resize(matrix.cols());
+
   const int size = matrix.diagonal().size();
   const int rows = matrix.rows();
   const int cols = matrix.cols();
 
-  IntColVectorType rows_transpositions(matrix.rows());
-  IntRowVectorType cols_transpositions(matrix.cols());
+  ei_scratch_buffer<int, IntColVectorType::SizeAtCompileTime> rows_transpositions_buffer(rows);
+  ei_scratch_buffer<int, IntRowVectorType::SizeAtCompileTime> cols_transpositions_buffer(cols);
+  Map<IntColVectorType> rows_transpositions(rows_transpositions_buffer.data(), rows);
+  Map<IntRowVectorType> cols_transpositions(cols_transpositions_buffer.data(), cols);
   int number_of_transpositions = 0;
 
   RealScalar biggest = RealScalar(0);
@@ -451,16 +474,16 @@ template<typename ImageMatrixType>
 void LU<MatrixType>::computeImage(ImageMatrixType *result) const
 {
   ei_assert(m_rank > 0);
-  result->resize(m_originalMatrix.rows(), m_rank);
+  result->resize(m_originalMatrix->rows(), m_rank);
   for(int i = 0; i < m_rank; ++i)
-    result->col(i) = m_originalMatrix.col(m_q.coeff(i));
+    result->col(i) = m_originalMatrix->col(m_q.coeff(i));
 }
 
 template<typename MatrixType>
 const typename LU<MatrixType>::ImageResultType
 LU<MatrixType>::image() const
 {
-  ImageResultType result(m_originalMatrix.rows(), m_rank);
+  ImageResultType result(m_originalMatrix->rows(), m_rank);
   computeImage(&result);
   return result;
 }
@@ -0,0 +1,278 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra. Eigen itself is part of the KDE project.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_PARTIALPIVLU_H
+#define EIGEN_PARTIALPIVLU_H
+
+/** \ingroup LU_Module
+  *
+  * \class PartialPivLU
+  *
+  * \brief LU decomposition of a square invertible matrix, with partial pivoting
+  *
+  * \param MatrixType the type of the matrix of which we are computing the LU decomposition
+  *
+  * This class represents a LU decomposition of a square invertible matrix, with partial pivoting: the matrix A
+  * is decomposed as A = PLU where L is unit-lower-triangular, U is upper-triangular, and P
+  * is a permutation matrix.
+  *
+  * Only the rows are permuted, and each pivot is searched in a single column. This makes this
+  * decomposition much faster than the complete pivoting of class LU, and large matrices are
+  * factorized per panel of EIGEN_DECOMPOSITION_BLOCK_SIZE columns, so that most of the work
+  * is done by the cache friendly matrix product.
+  *
+  * The price to pay is that this decomposition is not rank-revealing, and is only stable for invertible
+  * matrices. So it is the right choice to solve square systems, compute the determinant or the inverse
+  * of a matrix known to be invertible, but class LU must be used whenever the matrix may be singular or
+  * its kernel, image or rank are needed.
+  *
+  * \sa MatrixBase::partialPivLu(), MatrixBase::determinant(), MatrixBase::inverse(), class LU
+  */
+template<typename MatrixType> class PartialPivLU
+{
+  public:
+
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename NumTraits<typename MatrixType::Scalar>::Real RealScalar;
+    typedef Matrix<int, MatrixType::RowsAtCompileTime, 1> IntColVectorType;
+
+    /** Default Constructor.
+      *
+      * The default constructor is useful in cases in which the user intends to
+      * perform decompositions via PartialPivLU::compute(const MatrixType&).
+      */
+    PartialPivLU() : m_det_p(0), m_isInitialized(false) {}
+
+    /** Constructor.
+      *
+      * \param matrix the matrix of which to compute the LU decomposition.
+      */
+    PartialPivLU(const MatrixType& matrix)
+      : m_det_p(0), m_isInitialized(false)
+    {
+      compute(matrix);
+    }
+
+    void compute(const MatrixType& matrix);
+
+    /** \returns the LU decomposition matrix: the upper-triangular part is U, the
+      * unit-lower-triangular part is L.
+      */
+    inline const MatrixType& matrixLU() const
+    {
+      ei_assert(m_isInitialized && "PartialPivLU is not initialized.");
+      return m_lu;
+    }
+
+    /** \returns a vector of integers, whose size is the number of rows of the matrix being decomposed,
+      * representing the P permutation i.e. the permutation of the rows: the row \c i of LU
+      * comes from the row \c permutationP()[i] of the matrix being decomposed.
+      */
+    inline const IntColVectorType& permutationP() const
+    {
+      ei_assert(m_isInitialized && "PartialPivLU is not initialized.");
+      return m_p;
+    }
+
+    /** This method finds the solution x to the equation Ax=b, where A is the matrix of which
+      * *this is the LU decomposition.
+      *
+      * \param b the right-hand-side of the equation to solve. Can be a vector or a matrix,
+      *          the only requirement in order for the equation to make sense is that
+      *          b.rows()==A.rows(), where A is the matrix of which *this is the LU decomposition.
+      * \param result a pointer to the vector or matrix in which to store the solution.
+      *          Resized if necessary, so that result->rows()==A.cols() and result->cols()==b.cols().
+      *
+      * \note The matrix A is assumed to be invertible, otherwise *result is left with undefined
+      *       coefficients. Use class LU to solve singular or non-square systems.
+      *
+      * \sa MatrixBase::solveTriangular(), inverse(), computeInverse()
+      */
+    template<typename OtherDerived, typename ResultType>
+    void solve(const MatrixBase<OtherDerived>& b, ResultType *result) const;
+
+    /** \returns the determinant of the matrix of which *this is the LU decomposition.
+      * It has only linear complexity as the LU decomposition has already been computed.
+      *
+      * \warning a determinant can be very big or small, so for matrices
+      * of large enough dimension, there is a risk of overflow/underflow.
+      *
+      * \sa MatrixBase::determinant()
+      */
+    typename ei_traits<MatrixType>::Scalar determinant() const;
+
+    /** Computes the inverse of the matrix of which *this is the LU decomposition.
+      *
+      * \param result a pointer to the matrix into which to store the inverse. Resized if needed.
+      *
+      * \note If this matrix is not invertible, *result is left with undefined coefficients.
+      *
+      * \sa MatrixBase::computeInverse(), inverse()
+      */
+    inline void computeInverse(MatrixType *result) const
+    {
+      solve(MatrixType::Identity(m_lu.rows(), m_lu.cols()), result);
+    }
+
+    /** \returns the inverse of the matrix of which *this is the LU decomposition.
+      *
+      * \note If this matrix is not invertible, the returned matrix has undefined coefficients.
+      *
+      * \sa computeInverse(), MatrixBase::inverse()
+      */
+    inline MatrixType inverse() const
+    {
+      MatrixType result;
+      computeInverse(&result);
+      return result;
+    }
+
+  protected:
+    void computePanel(int k, int panelEnd, int& number_of_transpositions);
+
+    MatrixType m_lu;
+    IntColVectorType m_p;
+    int m_det_p;
+    bool m_isInitialized;
+};
+
+/** \internal
+  * Factorizes the columns \a k to \a panelEnd of m_lu, below the row \a k, by the unblocked
+  * algorithm. The rows are swapped in the whole matrix, and their final position is stored in m_p.
+  */
+template<typename MatrixType>
+void PartialPivLU<MatrixType>::computePanel(int k, int panelEnd, int& number_of_transpositions)
+{
+  const int size = m_lu.rows();
+  for(int j = k; j < panelEnd; ++j)
+  {
+    int row_of_biggest_in_col;
+    m_lu.col(j).end(size-j).cwise().abs().maxCoeff(&row_of_biggest_in_col);
+    row_of_biggest_in_col += j;
+
+    if(j != row_of_biggest_in_col)
+    {
+      m_lu.row(j).swap(m_lu.row(row_of_biggest_in_col));
+      std::swap(m_p.coeffRef(j), m_p.coeffRef(row_of_biggest_in_col));
+      ++number_of_transpositions;
+    }
+
+    // an exactly zero pivot means that the matrix is singular, and there is nothing to eliminate
+    const int endSize = size-j-1;
+    if(endSize > 0 && m_lu.coeff(j,j) != Scalar(0))
+    {
+      m_lu.col(j).end(endSize) /= m_lu.coeff(j,j);
+      for(int col = j + 1; col < panelEnd; ++col)
+        m_lu.col(col).end(endSize) -= m_lu.col(j).end(endSize) * m_lu.coeff(j,col);
+    }
+  }
+}
+
+/** Computes / recomputes the LU decomposition A = PLU of \a matrix
+  *
+  * Large matrices are factorized per panel of EIGEN_DECOMPOSITION_BLOCK_SIZE columns, right looking:
+  * each panel is factorized by the unblocked algorithm, the corresponding rows of U are obtained by a
+  * triangular solve, and the trailing matrix is then updated by a cache friendly rank-k product.
+  */
+template<typename MatrixType>
+void PartialPivLU<MatrixType>::compute(const MatrixType& matrix)
+{
+  ei_assert(matrix.rows() == matrix.cols() && "PartialPivLU is only for square matrices");
+  const int size = matrix.rows();
+  m_lu = matrix;
+  m_p.resize(size);
+  for(int k = 0; k < size; ++k) m_p.coeffRef(k) = k;
+
+  int number_of_transpositions = 0;
+  const int blockSize = size >= 2*EIGEN_DECOMPOSITION_BLOCK_SIZE ? EIGEN_DECOMPOSITION_BLOCK_SIZE : size;
+  for(int k = 0; k < size; k += blockSize)
+  {
+    const int panelEnd = std::min(k+blockSize, size);
+    computePanel(k, panelEnd, number_of_transpositions);
+
+    const int endSize = size-panelEnd;
+    if(endSize > 0)
+    {
+      // U12 = L11^-1 A12
+      m_lu.block(k, k, panelEnd-k, panelEnd-k).template marked<UnitLowerTriangular>()
+          .solveTriangularInPlace(m_lu.block(k, panelEnd, panelEnd-k, endSize));
+
+      // A22 -= L21 * U12
+      m_lu.corner(BottomRight, endSize, endSize).noalias()
+        -= m_lu.block(panelEnd, k, endSize, panelEnd-k) * m_lu.block(k, panelEnd, panelEnd-k, endSize);
+    }
+  }
+
+  m_det_p = (number_of_transpositions%2) ? -1 : 1;
+  m_isInitialized = true;
+}
+
+template<typename MatrixType>
+typename ei_traits<MatrixType>::Scalar PartialPivLU<MatrixType>::determinant() const
+{
+  ei_assert(m_isInitialized && "PartialPivLU is not initialized.");
+  return Scalar(m_det_p) * m_lu.diagonal().redux(ei_scalar_product_op<Scalar>());
+}
+
+template<typename MatrixType>
+template<typename OtherDerived, typename ResultType>
+void PartialPivLU<MatrixType>::solve(
+  const MatrixBase<OtherDerived>& b,
+  ResultType *result
+) const
+{
+  ei_assert(m_isInitialized && "PartialPivLU is not initialized.");
+  ei_assert(b.rows() == m_lu.rows());
+
+  /* The decomposition PA = LU can be rewritten as A = P^{-1} L U.
+   * So we proceed as follows:
+   * Step 1: compute c = Pb.
+   * Step 2: replace c by the solution x to Lx = c.
+   * Step 3: replace c by the solution x to Ux = c.
+   */
+  const int size = m_lu.rows();
+  result->resize(size, b.cols());
+
+  // Step 1
+  for(int i = 0; i < size; ++i) result->row(i) = b.row(m_p.coeff(i));
+
+  // Step 2
+  m_lu.template marked<UnitLowerTriangular>().solveTriangularInPlace(*result);
+
+  // Step 3
+  m_lu.template marked<UpperTriangular>().solveTriangularInPlace(*result);
+}
+
+/** \lu_module
+  *
+  * \return the partial-pivoting LU decomposition of \c *this.
+  *
+  * \sa class PartialPivLU
+  */
+template<typename Derived>
+inline const PartialPivLU<typename MatrixBase<Derived>::PlainMatrixType>
+MatrixBase<Derived>::partialPivLu() const
+{
+  return PartialPivLU<PlainMatrixType>(eval());
+}
+
+#endif // EIGEN_PARTIALPIVLU_H
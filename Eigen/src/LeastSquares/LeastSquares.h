@@ -25,6 +25,263 @@
 #ifndef EIGEN_LEASTSQUARES_H
 #define EIGEN_LEASTSQUARES_H
 
+/** \ingroup LeastSquares_Module
+  *
+  * \leastsquares_module
+  *
+  * \class LeastSquaresAccumulator
+  *
+  * \brief Incremental linear regression and hyperplane fitting
+  *
+  * \param VectorType the type of the data points
+  *
+  * This class accumulates the sufficient statistics of a stream of points, that is their
+  * number, their mean and their scatter matrix \f$ \sum_i \overline{(x_i-m)}(x_i-m)^T \f$, so that
+  * linearRegression() and fitHyperplane() can be recomputed at any time without keeping the points.
+  * Adding a point costs \f$ O(n^2) \f$ whatever the number of points already seen, and the fits only
+  * depend on the dimension \f$ n \f$ of the space. The mean and the scatter matrix are updated in the
+  * numerically stable way of Welford, and two accumulators, for instance filled by different threads
+  * from different parts of the data, are combined by merge() with the pairwise formula of Chan et al.
+  *
+  * Example:
+  * \code
+  * LeastSquaresAccumulator<Vector3d> acc;
+  * while(sensor.hasData())
+  * {
+  *   acc.add(sensor.read());
+  *   Hyperplane<double,3> plane;
+  *   acc.fitHyperplane(&plane);
+  * }
+  * \endcode
+  *
+  * \sa linearRegression(), fitHyperplane()
+  */
+template<typename VectorType> class LeastSquaresAccumulator
+{
+  public:
+
+    typedef typename VectorType::Scalar Scalar;
+    typedef typename NumTraits<Scalar>::Real RealScalar;
+    enum { Size = VectorType::SizeAtCompileTime };
+    typedef Matrix<Scalar,Size,Size> CovMatrixType;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW_IF_VECTORIZABLE_FIXED_SIZE(Scalar,Size==Dynamic ? Dynamic : Size*Size)
+
+    /** Default constructor for fixed size vectors. */
+    LeastSquaresAccumulator()
+      : m_count(0), m_mean(VectorType::Zero()), m_scatter(CovMatrixType::Zero())
+    {
+      EIGEN_STATIC_ASSERT_VECTOR_ONLY(VectorType)
+    }
+
+    /** Constructs an empty accumulator for points of dimension \a size. */
+    explicit LeastSquaresAccumulator(int size)
+      : m_count(0), m_mean(VectorType::Zero(size)), m_scatter(CovMatrixType::Zero(size, size))
+    {
+      EIGEN_STATIC_ASSERT_VECTOR_ONLY(VectorType)
+    }
+
+    /** Forgets all the points added so far. */
+    void reset()
+    {
+      m_count = 0;
+      m_mean.setZero();
+      m_scatter.setZero();
+    }
+
+    void add(const VectorType& point);
+    void add(int numPoints, VectorType **points);
+    template<typename Derived> void add(const MatrixBase<Derived>& points);
+    void merge(const LeastSquaresAccumulator& other);
+
+    /** \returns the dimension of the points */
+    inline int size() const { return m_mean.size(); }
+    /** \returns the number of points added so far */
+    inline int count() const { return m_count; }
+    /** \returns the mean of the points added so far */
+    inline const VectorType& mean() const { return m_mean; }
+    /** \returns the scatter matrix \f$ \sum_i \overline{(x_i-m)}(x_i-m)^T \f$ of the points added so far */
+    inline const CovMatrixType& scatter() const { return m_scatter; }
+
+    bool linearRegression(VectorType *result, int funcOfOthers) const;
+    template<typename HyperplaneType>
+    void fitHyperplane(HyperplaneType *result, RealScalar* soundness = 0) const;
+
+  protected:
+    void mergeStatistics(int count, const VectorType& mean, const CovMatrixType& scatter);
+
+    int m_count;
+    VectorType m_mean;
+    CovMatrixType m_scatter;
+};
+
+/** Adds the point \a point. */
+template<typename VectorType>
+void LeastSquaresAccumulator<VectorType>::add(const VectorType& point)
+{
+  ei_assert(point.size() == size());
+  VectorType delta = point - m_mean;
+  ++m_count;
+  m_mean += delta / Scalar(m_count);
+  m_scatter += (delta.conjugate() * delta.transpose()).lazy() * (RealScalar(m_count-1) / RealScalar(m_count));
+}
+
+/** Adds the \a numPoints points pointed to by \a points, as passed to the function linearRegression(). */
+template<typename VectorType>
+void LeastSquaresAccumulator<VectorType>::add(int numPoints, VectorType **points)
+{
+  if (numPoints == 0)
+    return;
+
+  VectorType mean = VectorType::Zero(size());
+  for(int i = 0; i < numPoints; ++i)
+    mean += *(points[i]);
+  mean /= Scalar(numPoints);
+
+  CovMatrixType scatter = CovMatrixType::Zero(size(), size());
+  VectorType diff(size());
+  for(int i = 0; i < numPoints; ++i)
+  {
+    diff = *(points[i]) - mean;
+    scatter += (diff.conjugate() * diff.transpose()).lazy();
+  }
+  mergeStatistics(numPoints, mean, scatter);
+}
+
+/** Adds the columns of \a points. For large batches the scatter matrix of the batch is
+  * computed by a single matrix product. */
+template<typename VectorType>
+template<typename Derived>
+void LeastSquaresAccumulator<VectorType>::add(const MatrixBase<Derived>& points)
+{
+  ei_assert(points.rows() == size());
+  int numPoints = points.cols();
+  if (numPoints == 0)
+    return;
+
+  Matrix<Scalar,Size,Dynamic> centered = points;
+  VectorType mean = VectorType::Zero(size());
+  for(int i = 0; i < numPoints; ++i)
+    mean += centered.col(i);
+  mean /= Scalar(numPoints);
+  for(int i = 0; i < numPoints; ++i)
+    centered.col(i) -= mean;
+
+  CovMatrixType scatter(size(), size());
+  scatter.noalias() = centered.conjugate() * centered.transpose();
+  mergeStatistics(numPoints, mean, scatter);
+}
+
+/** Adds all the points accumulated by \a other, which must have the same dimension.
+  * The result does not depend on how the points were split between the two accumulators,
+  * up to rounding errors. */
+template<typename VectorType>
+void LeastSquaresAccumulator<VectorType>::merge(const LeastSquaresAccumulator& other)
+{
+  ei_assert(other.size() == size());
+  mergeStatistics(other.m_count, other.m_mean, other.m_scatter);
+}
+
+template<typename VectorType>
+void LeastSquaresAccumulator<VectorType>::mergeStatistics(int count, const VectorType& mean, const CovMatrixType& scatter)
+{
+  if (count == 0)
+    return;
+  if (m_count == 0)
+  {
+    m_count = count;
+    m_mean = mean;
+    m_scatter = scatter;
+    return;
+  }
+
+  RealScalar total = RealScalar(m_count) + RealScalar(count);
+  VectorType delta = mean - m_mean;
+  m_mean += delta * (RealScalar(count) / total);
+  m_scatter += scatter;
+  m_scatter += (delta.conjugate() * delta.transpose()).lazy() * (RealScalar(m_count) * RealScalar(count) / total);
+  m_count += count;
+}
+
+/** Computes the same fit as the function linearRegression() for the points added so far,
+  * by solving the centered normal equations with a LDLT decomposition.
+  *
+  * \returns false if the regression is not well defined, for instance when less
+  * points than coordinates have been added, or when some of the other coordinates are
+  * linearly dependent. Whether they are is decided relatively to the spread of each coordinate,
+  * so that the result does not depend on the scale of the data.
+  *
+  * \sa linearRegression()
+  */
+template<typename VectorType>
+bool LeastSquaresAccumulator<VectorType>::linearRegression(VectorType *result, int funcOfOthers) const
+{
+  int n = size();
+  ei_assert(funcOfOthers >= 0 && funcOfOthers < n);
+  ei_assert(m_count >= 1);
+  result->resize(n);
+
+  // the coefficients of the other coordinates, in their order, followed by the constant term
+  if(funcOfOthers>0)
+    result->start(funcOfOthers) = m_scatter.col(funcOfOthers).start(funcOfOthers);
+  if(funcOfOthers<n-1)
+    result->segment(funcOfOthers, n-funcOfOthers-1) = m_scatter.col(funcOfOthers).end(n-funcOfOthers-1);
+
+  bool ok = true;
+  if (n>1)
+  {
+    typename BlockReturnType<VectorType,Dynamic>::SubVectorType coeffs = result->start(n-1);
+    typedef typename ei_plain_matrix_type<Minor<CovMatrixType> >::type NormalMatrixType;
+    typedef Matrix<Scalar,NormalMatrixType::RowsAtCompileTime,1> ScalingType;
+
+    // the normal matrix is scaled to a unit diagonal, so that the rank test of LDLT, which
+    // uses an absolute threshold, does not depend on the scale of each coordinate
+    NormalMatrixType normal = m_scatter.minor(funcOfOthers, funcOfOthers);
+    ScalingType scaling(n-1);
+    for(int i = 0; i < n-1; ++i)
+    {
+      RealScalar d = ei_real(normal.coeff(i,i));
+      scaling.coeffRef(i) = d > RealScalar(0) ? Scalar(RealScalar(1)/ei_sqrt(d)) : Scalar(1);
+    }
+    for(int j = 0; j < n-1; ++j)
+      normal.col(j) = (normal.col(j).cwise() * scaling) * scaling.coeff(j);
+    coeffs.cwise() *= scaling;
+    ok = LDLT<NormalMatrixType>(normal).solveInPlace(coeffs);
+    coeffs.cwise() *= scaling;
+  }
+
+  // the fitted hyperplane passes through the mean
+  Scalar constant = m_mean.coeff(funcOfOthers);
+  if(funcOfOthers>0)
+    constant -= (result->start(funcOfOthers).cwise() * m_mean.start(funcOfOthers)).sum();
+  if(funcOfOthers<n-1)
+    constant -= (result->segment(funcOfOthers, n-funcOfOthers-1).cwise() * m_mean.end(n-funcOfOthers-1)).sum();
+  result->coeffRef(n-1) = constant;
+  return ok;
+}
+
+/** Computes the same fit as the function fitHyperplane() for the points added so far.
+  *
+  * \sa fitHyperplane()
+  */
+template<typename VectorType>
+template<typename HyperplaneType>
+void LeastSquaresAccumulator<VectorType>::fitHyperplane(HyperplaneType *result, RealScalar* soundness) const
+{
+  ei_assert(m_count >= 1);
+  ei_assert(size()+1 == result->coeffs().size());
+
+  // now we just have to pick the eigen vector with smallest eigen value
+  SelfAdjointEigenSolver<CovMatrixType> eig(m_scatter);
+  result->normal() = eig.eigenvectors().col(0);
+  if (soundness)
+    *soundness = eig.eigenvalues().coeff(0)/eig.eigenvalues().coeff(1);
+
+  // let's compute the constant coefficient such that the
+  // plane pass trough the mean point:
+  result->offset() = - (result->normal().cwise()* m_mean).sum();
+}
+
 /** \ingroup LeastSquares_Module
   *
   * \leastsquares_module
@@ -92,40 +349,21 @@
                         value of 0 means \f$x\f$, 1 means \f$y\f$,
                         2 means \f$z\f$, ...
   *
-  * \sa fitHyperplane()
+  * \returns false if the regression is not well defined, see LeastSquaresAccumulator::linearRegression()
+  *
+  * \sa fitHyperplane(), class LeastSquaresAccumulator
   */
 template<typename VectorType>
-void linearRegression(int numPoints,
+bool linearRegression(int numPoints,
                       VectorType **points,
                       VectorType *result,
                       int funcOfOthers )
 {
-  typedef typename VectorType::Scalar Scalar;
   EIGEN_STATIC_ASSERT_VECTOR_ONLY(VectorType)
   ei_assert(numPoints >= 1);
-  int size = points[0]->size();
-  ei_assert(funcOfOthers >= 0 && funcOfOthers < size);
-  result->resize(size);
-
-  Matrix<Scalar, Dynamic, VectorType::SizeAtCompileTime,
-         Dynamic, VectorType::MaxSizeAtCompileTime, RowMajorBit>
-    m(numPoints, size);
-  if(funcOfOthers>0)
-    for(int i = 0; i < numPoints; ++i)
-      m.row(i).start(funcOfOthers) = points[i]->start(funcOfOthers);
-  if(funcOfOthers<size-1)
-    for(int i = 0; i < numPoints; ++i)
-      m.row(i).block(funcOfOthers, size-funcOfOthers-1)
-        = points[i]->end(size-funcOfOthers-1);
-  for(int i = 0; i < numPoints; ++i)
-    m.row(i).coeffRef(size-1) = Scalar(1);
-
-  VectorType v(size);
-  v.setZero();
-  for(int i = 0; i < numPoints; ++i)
-    v += m.row(i).adjoint() * points[i]->coeff(funcOfOthers);
-
-  ei_assert((m.adjoint()*m).lu().solve(v, result));
+  LeastSquaresAccumulator<VectorType> acc(points[0]->size());
+  acc.add(numPoints, points);
+  return acc.linearRegression(result, funcOfOthers);
 }
 
 /** \ingroup LeastSquares_Module
@@ -153,7 +391,7 @@ void linearRegression(int numPoints,
   * The ratio of the smallest eigenvalue and the second one gives us a hint about the relevance
   * of the solution. This value is optionally returned in \a soundness.
   *
-  * \sa linearRegression()
+  * \sa linearRegression(), class LeastSquaresAccumulator
   */
 template<typename VectorType, typename HyperplaneType>
 void fitHyperplane(int numPoints,
@@ -161,37 +399,11 @@ void fitHyperplane(int numPoints,
                    HyperplaneType *result,
                    typename NumTraits<typename VectorType::Scalar>::Real* soundness = 0)
 {
-  typedef typename VectorType::Scalar Scalar;
-  typedef Matrix<Scalar,VectorType::SizeAtCompileTime,VectorType::SizeAtCompileTime> CovMatrixType;
   EIGEN_STATIC_ASSERT_VECTOR_ONLY(VectorType)
   ei_assert(numPoints >= 1);
-  int size = points[0]->size();
-  ei_assert(size+1 == result->coeffs().size());
-
-  // compute the mean of the data
-  VectorType mean = VectorType::Zero(size);
-  for(int i = 0; i < numPoints; ++i)
-    mean += *(points[i]);
-  mean /= numPoints;
-
-  // compute the covariance matrix
-  CovMatrixType covMat = CovMatrixType::Zero(size, size);
-  VectorType remean = VectorType::Zero(size);
-  for(int i = 0; i < numPoints; ++i)
-  {
-    VectorType diff = (*(points[i]) - mean).conjugate();
-    covMat += diff * diff.adjoint();
-  }
-
-  // now we just have to pick the eigen vector with smallest eigen value
-  SelfAdjointEigenSolver<CovMatrixType> eig(covMat);
-  result->normal() = eig.eigenvectors().col(0);
-  if (soundness)
-    *soundness = eig.eigenvalues().coeff(0)/eig.eigenvalues().coeff(1);
-
-  // let's compute the constant coefficient such that the
-  // plane pass trough the mean point:
-  result->offset() = - (result->normal().cwise()* mean).sum();
+  LeastSquaresAccumulator<VectorType> acc(points[0]->size());
+  acc.add(numPoints, points);
+  acc.fitHyperplane(result, soundness);
 }
 
 
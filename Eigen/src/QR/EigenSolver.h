@@ -36,7 +36,12 @@
   *
   * Currently it only support real matrices.
   *
-  * \note this code was adapted from JAMA (public domain)
+  * The matrix is first reduced to the Hessenberg form (see class HessenbergDecomposition), and then to the
+  * real Schur form by the Francis QR algorithm. Large matrices are processed by the small bulge multishift
+  * QR algorithm with aggressive early deflation, so that most of the work is done by cache friendly matrix
+  * products. The eigenvectors, which are the most expensive part, are only computed if requested.
+  *
+  * \note the double shift QR iteration and the back substitution were adapted from JAMA (public domain)
   *
   * \sa MatrixBase::eigenvalues(), SelfAdjointEigenSolver
   */
@@ -53,11 +58,16 @@ template<typename _MatrixType> class EigenSolver
     typedef Matrix<RealScalar, MatrixType::ColsAtCompileTime, 1> RealVectorType;
     typedef Matrix<RealScalar, Dynamic, 1> RealVectorTypeX;
 
-    EigenSolver(const MatrixType& matrix)
+    /** Constructor computing the eigenvalues of \a matrix, as well as its eigenvectors if
+      * \a computeEigenvectors is true.
+      *
+      * \sa compute()
+      */
+    EigenSolver(const MatrixType& matrix, bool computeEigenvectors = true)
       : m_eivec(matrix.rows(), matrix.cols()),
         m_eivalues(matrix.cols())
     {
-      compute(matrix);
+      compute(matrix, computeEigenvectors);
     }
 
 
@@ -94,23 +104,31 @@ template<typename _MatrixType> class EigenSolver
       *
       * \sa pseudoEigenvalueMatrix()
       */
-    const MatrixType& pseudoEigenvectors() const { return m_eivec; }
+    const MatrixType& pseudoEigenvectors() const
+    {
+      #ifndef NDEBUG
+      ei_assert(m_eigenvectorsOk);
+      #endif
+      return m_eivec;
+    }
 
     MatrixType pseudoEigenvalueMatrix() const;
 
     /** \returns the eigenvalues as a column vector */
     EigenvalueType eigenvalues() const { return m_eivalues; }
 
-    void compute(const MatrixType& matrix);
+    void compute(const MatrixType& matrix, bool computeEigenvectors = true);
 
   private:
 
-    void orthes(MatrixType& matH, RealVectorType& ort);
-    void hqr2(MatrixType& matH);
+    void hqr2(Map<MatrixType>& matH);
 
   protected:
     MatrixType m_eivec;
     EigenvalueType m_eivalues;
+    #ifndef NDEBUG
+    bool m_eigenvectorsOk;
+    #endif
 };
 
 /** \returns the real block diagonal matrix D of the eigenvalues.
@@ -120,7 +138,7 @@ template<typename _MatrixType> class EigenSolver
 template<typename MatrixType>
 MatrixType EigenSolver<MatrixType>::pseudoEigenvalueMatrix() const
 {
-  int n = m_eivec.cols();
+  int n = m_eivalues.size();
   MatrixType matD = MatrixType::Zero(n,n);
   for (int i=0; i<n; ++i)
   {
@@ -143,6 +161,9 @@ MatrixType EigenSolver<MatrixType>::pseudoEigenvalueMatrix() const
 template<typename MatrixType>
 typename EigenSolver<MatrixType>::EigenvectorType EigenSolver<MatrixType>::eigenvectors(void) const
 {
+  #ifndef NDEBUG
+  ei_assert(m_eigenvectorsOk);
+  #endif
   int n = m_eivec.cols();
   EigenvectorType matV(n,n);
   for (int j=0; j<n; ++j)
@@ -168,86 +189,6 @@ typename EigenSolver<MatrixType>::EigenvectorType EigenSolver<MatrixType>::eigen
   return matV;
 }
 
-template<typename MatrixType>
-void EigenSolver<MatrixType>::compute(const MatrixType& matrix)
-{
-  assert(matrix.cols() == matrix.rows());
-  int n = matrix.cols();
-  m_eivalues.resize(n,1);
-
-  MatrixType matH = matrix;
-  RealVectorType ort(n);
-
-  // Reduce to Hessenberg form.
-  orthes(matH, ort);
-
-  // Reduce Hessenberg to real Schur form.
-  hqr2(matH);
-}
-
-// Nonsymmetric reduction to Hessenberg form.
-template<typename MatrixType>
-void EigenSolver<MatrixType>::orthes(MatrixType& matH, RealVectorType& ort)
-{
-  //  This is derived from the Algol procedures orthes and ortran,
-  //  by Martin and Wilkinson, Handbook for Auto. Comp.,
-  //  Vol.ii-Linear Algebra, and the corresponding
-  //  Fortran subroutines in EISPACK.
-
-  int n = m_eivec.cols();
-  int low = 0;
-  int high = n-1;
-
-  for (int m = low+1; m <= high-1; ++m)
-  {
-    // Scale column.
-    RealScalar scale = matH.block(m, m-1, high-m+1, 1).cwise().abs().sum();
-    if (scale != 0.0)
-    {
-      // Compute Householder transformation.
-      RealScalar h = 0.0;
-      // FIXME could be rewritten, but this one looks better wrt cache
-      for (int i = high; i >= m; i--)
-      {
-        ort.coeffRef(i) = matH.coeff(i,m-1)/scale;
-        h += ort.coeff(i) * ort.coeff(i);
-      }
-      RealScalar g = ei_sqrt(h);
-      if (ort.coeff(m) > 0)
-        g = -g;
-      h = h - ort.coeff(m) * g;
-      ort.coeffRef(m) = ort.coeff(m) - g;
-
-      // Apply Householder similarity transformation
-      // H = (I-u*u'/h)*H*(I-u*u')/h)
-      int bSize = high-m+1;
-      matH.block(m, m, bSize, n-m) -= ((ort.segment(m, bSize)/h)
-        * (ort.segment(m, bSize).transpose() *  matH.block(m, m, bSize, n-m)).lazy()).lazy();
-
-      matH.block(0, m, high+1, bSize) -= ((matH.block(0, m, high+1, bSize) * ort.segment(m, bSize)).lazy()
-        * (ort.segment(m, bSize)/h).transpose()).lazy();
-
-      ort.coeffRef(m) = scale*ort.coeff(m);
-      matH.coeffRef(m,m-1) = scale*g;
-    }
-  }
-
-  // Accumulate transformations (Algol's ortran).
-  m_eivec.setIdentity();
-
-  for (int m = high-1; m >= low+1; m--)
-  {
-    if (matH.coeff(m,m-1) != 0.0)
-    {
-      ort.segment(m+1, high-m) = matH.col(m-1).segment(m+1, high-m);
-
-      int bSize = high-m+1;
-      m_eivec.block(m, m, bSize, bSize) += ( (ort.segment(m, bSize) /  (matH.coeff(m,m-1) * ort.coeff(m) ) )
-        * (ort.segment(m, bSize).transpose() * m_eivec.block(m, m, bSize, bSize)).lazy());
-    }
-  }
-}
-
 // Complex scalar division.
 template<typename Scalar>
 std::complex<Scalar> cdiv(Scalar xr, Scalar xi, Scalar yr, Scalar yi)
@@ -268,39 +209,35 @@ std::complex<Scalar> cdiv(Scalar xr, Scalar xi, Scalar yr, Scalar yi)
 }
 
 
-// Nonsymmetric reduction from Hessenberg to real Schur form.
-template<typename MatrixType>
-void EigenSolver<MatrixType>::hqr2(MatrixType& matH)
+/** \internal
+  * Reduces the diagonal block \a low .. \a high of the upper Hessenberg matrix \a matH to the real Schur form,
+  * by the Francis double shift QR algorithm, and stores its eigenvalues in the corresponding coefficients
+  * of \a eivalues. The remaining rows and columns of \a matH are updated as well if \a wantT is true, and
+  * the columns of \a matZ are updated by the orthogonal transformations if \a wantZ is true.
+  *
+  * This is the iteration of the Algol procedure hqr2, by Martin and Wilkinson, Handbook for Auto. Comp.,
+  * Vol.ii-Linear Algebra, and the corresponding Fortran subroutine in EISPACK. It is used for the small
+  * matrices and, by ei_real_schur(), for the small diagonal blocks and deflation windows of large ones.
+  */
+template<typename HessenbergType, typename SchurVectorsType, typename EigenvalueType>
+void ei_real_schur_double_shift(HessenbergType& matH, SchurVectorsType& matZ, EigenvalueType& eivalues,
+                                int low, int high, bool wantT, bool wantZ)
 {
-  //  This is derived from the Algol procedure hqr2,
-  //  by Martin and Wilkinson, Handbook for Auto. Comp.,
-  //  Vol.ii-Linear Algebra, and the corresponding
-  //  Fortran subroutine in EISPACK.
-
-  // Initialize
-  int nn = m_eivec.cols();
-  int n = nn-1;
-  int low = 0;
-  int high = nn-1;
-  Scalar eps = ei_pow(Scalar(2),ei_is_same_type<Scalar,float>::ret ? Scalar(-23) : Scalar(-52));
+  typedef typename HessenbergType::Scalar Scalar;
+  typedef typename EigenvalueType::Scalar Complex;
+  const Scalar eps = std::numeric_limits<Scalar>::epsilon();
+  const int rowStart = wantT ? 0 : low;
+  const int colEnd = wantT ? matH.cols() : high+1;
+  const int zRows = wantZ ? matZ.rows() : 0;
   Scalar exshift = 0.0;
-  Scalar p=0,q=0,r=0,s=0,z=0,t,w,x,y;
+  Scalar p=0,q=0,r=0,s=0,z=0,w,x,y;
 
-  // Store roots isolated by balanc and compute matrix norm
-  // FIXME to be efficient the following would requires a triangular reduxion code
-  // Scalar norm = matH.upper().cwise().abs().sum() + matH.corner(BottomLeft,n,n).diagonal().cwise().abs().sum();
   Scalar norm = 0.0;
-  for (int j = 0; j < nn; ++j)
-  {
-    // FIXME what's the purpose of the following since the condition is always false
-    if ((j < low) || (j > high))
-    {
-      m_eivalues.coeffRef(j) = Complex(matH.coeff(j,j), 0.0);
-    }
-    norm += matH.row(j).segment(std::max(j-1,0), nn-std::max(j-1,0)).cwise().abs().sum();
-  }
+  for (int j = low; j <= high; ++j)
+    norm += matH.row(j).segment(std::max(j-1,low), high+1-std::max(j-1,low)).cwise().abs().sum();
 
   // Outer loop over eigenvalue index
+  int n = high;
   int iter = 0;
   while (n >= low)
   {
@@ -311,8 +248,11 @@ void EigenSolver<MatrixType>::hqr2(MatrixType& matH)
       s = ei_abs(matH.coeff(l-1,l-1)) + ei_abs(matH.coeff(l,l));
       if (s == 0.0)
           s = norm;
-      if (ei_abs(matH.coeff(l,l-1)) < eps * s)
+      if (ei_abs(matH.coeff(l,l-1)) <= eps * s)
+      {
+        matH.coeffRef(l,l-1) = 0.0;
         break;
+      }
       l--;
     }
 
@@ -321,7 +261,7 @@ void EigenSolver<MatrixType>::hqr2(MatrixType& matH)
     if (l == n)
     {
       matH.coeffRef(n,n) = matH.coeff(n,n) + exshift;
-      m_eivalues.coeffRef(n) = Complex(matH.coeff(n,n), 0.0);
+      eivalues.coeffRef(n) = Complex(matH.coeff(n,n), 0.0);
       n--;
       iter = 0;
     }
@@ -343,8 +283,8 @@ void EigenSolver<MatrixType>::hqr2(MatrixType& matH)
         else
           z = p - z;
 
-        m_eivalues.coeffRef(n-1) = Complex(x + z, 0.0);
-        m_eivalues.coeffRef(n) = Complex(z!=0.0 ? x - w / z : m_eivalues.coeff(n-1).real(), 0.0);
+        eivalues.coeffRef(n-1) = Complex(x + z, 0.0);
+        eivalues.coeffRef(n) = Complex(z!=0.0 ? x - w / z : eivalues.coeff(n-1).real(), 0.0);
 
         x = matH.coeff(n,n-1);
         s = ei_abs(x) + ei_abs(z);
@@ -355,7 +295,7 @@ void EigenSolver<MatrixType>::hqr2(MatrixType& matH)
         q = q / r;
 
         // Row modification
-        for (int j = n-1; j < nn; ++j)
+        for (int j = n-1; j < colEnd; ++j)
         {
           z = matH.coeff(n-1,j);
           matH.coeffRef(n-1,j) = q * z + p * matH.coeff(n,j);
@@ -363,25 +303,26 @@ void EigenSolver<MatrixType>::hqr2(MatrixType& matH)
         }
 
         // Column modification
-        for (int i = 0; i <= n; ++i)
+        for (int i = rowStart; i <= n; ++i)
         {
           z = matH.coeff(i,n-1);
           matH.coeffRef(i,n-1) = q * z + p * matH.coeff(i,n);
           matH.coeffRef(i,n) = q * matH.coeff(i,n) - p * z;
         }
+        matH.coeffRef(n,n-1) = 0.0;
 
         // Accumulate transformations
-        for (int i = low; i <= high; ++i)
+        for (int i = 0; i < zRows; ++i)
         {
-          z = m_eivec.coeff(i,n-1);
-          m_eivec.coeffRef(i,n-1) = q * z + p * m_eivec.coeff(i,n);
-          m_eivec.coeffRef(i,n) = q * m_eivec.coeff(i,n) - p * z;
+          z = matZ.coeff(i,n-1);
+          matZ.coeffRef(i,n-1) = q * z + p * matZ.coeff(i,n);
+          matZ.coeffRef(i,n) = q * matZ.coeff(i,n) - p * z;
         }
       }
       else // Complex pair
       {
-        m_eivalues.coeffRef(n-1) = Complex(x + p, z);
-        m_eivalues.coeffRef(n)   = Complex(x + p, -z);
+        eivalues.coeffRef(n-1) = Complex(x + p, z);
+        eivalues.coeffRef(n)   = Complex(x + p, -z);
       }
       n = n - 2;
       iter = 0;
@@ -390,16 +331,12 @@ void EigenSolver<MatrixType>::hqr2(MatrixType& matH)
     {
       // Form shift
       x = matH.coeff(n,n);
-      y = 0.0;
-      w = 0.0;
-      if (l < n)
-      {
-          y = matH.coeff(n-1,n-1);
-          w = matH.coeff(n,n-1) * matH.coeff(n-1,n);
-      }
+      y = matH.coeff(n-1,n-1);
+      w = matH.coeff(n,n-1) * matH.coeff(n-1,n);
 
-      // Wilkinson's original ad hoc shift
-      if (iter == 10)
+      // Wilkinson's original ad hoc shift, repeated every ten iterations like in LAPACK's xLAHQR,
+      // since the small windows of ei_real_schur() may need more than two of them
+      if (iter % 10 == 0 && iter % 30 != 0)
       {
         exshift += x;
         for (int i = low; i <= n; ++i)
@@ -410,7 +347,7 @@ void EigenSolver<MatrixType>::hqr2(MatrixType& matH)
       }
 
       // MATLAB's new ad hoc shift
-      if (iter == 30)
+      if (iter % 30 == 0 && iter > 0)
       {
         s = Scalar((y - x) / 2.0);
         s = s * s + w;
@@ -502,7 +439,7 @@ void EigenSolver<MatrixType>::hqr2(MatrixType& matH)
           r = r / p;
 
           // Row modification
-          for (int j = k; j < nn; ++j)
+          for (int j = k; j < colEnd; ++j)
           {
             p = matH.coeff(k,j) + q * matH.coeff(k+1,j);
             if (notlast)
@@ -515,7 +452,7 @@ void EigenSolver<MatrixType>::hqr2(MatrixType& matH)
           }
 
           // Column modification
-          for (int i = 0; i <= std::min(n,k+3); ++i)
+          for (int i = rowStart; i <= std::min(n,k+3); ++i)
           {
             p = x * matH.coeff(i,k) + y * matH.coeff(i,k+1);
             if (notlast)
@@ -528,29 +465,471 @@ void EigenSolver<MatrixType>::hqr2(MatrixType& matH)
           }
 
           // Accumulate transformations
-          for (int i = low; i <= high; ++i)
+          for (int i = 0; i < zRows; ++i)
           {
-            p = x * m_eivec.coeff(i,k) + y * m_eivec.coeff(i,k+1);
+            p = x * matZ.coeff(i,k) + y * matZ.coeff(i,k+1);
             if (notlast)
             {
-              p = p + z * m_eivec.coeff(i,k+2);
-              m_eivec.coeffRef(i,k+2) = m_eivec.coeff(i,k+2) - p * r;
+              p = p + z * matZ.coeff(i,k+2);
+              matZ.coeffRef(i,k+2) = matZ.coeff(i,k+2) - p * r;
             }
-            m_eivec.coeffRef(i,k) = m_eivec.coeff(i,k) - p;
-            m_eivec.coeffRef(i,k+1) = m_eivec.coeff(i,k+1) - p * q;
+            matZ.coeffRef(i,k) = matZ.coeff(i,k) - p;
+            matZ.coeffRef(i,k+1) = matZ.coeff(i,k+1) - p * q;
           }
         }  // (s != 0)
       }  // k loop
     }  // check convergence
   }  // while (n >= low)
 
+  // the bulges leave some roundoff below the subdiagonal
+  for (int j = low; j < high-1; ++j)
+    matH.col(j).segment(j+2, high-j-1).setZero();
+}
+
+/** \internal
+  * Aggressive early deflation: computes the real Schur form T = V^T W V of the trailing \a windowSize x
+  * \a windowSize diagonal block W of the active block \a ktop .. \a kbot of \a matH, and looks for the
+  * eigenvalues of T whose coefficients in the "spike" s V(0,:), where s is the subdiagonal coefficient
+  * which couples W to the rest of the matrix, are negligible. These eigenvalues are deflated, even though
+  * no subdiagonal coefficient of \a matH is small.
+  *
+  * The eigenvalues of W are stored in \a eivalues. The deflated ones are final, the others are good
+  * shifts for the next multishift QR sweep. If some eigenvalues were deflated, the window is replaced by
+  * T, whose undeflated part is reduced back to the Hessenberg form, and the rest of the matrix is updated
+  * by cache friendly products. Otherwise \a matH is left unchanged.
+  *
+  * Unlike LAPACK's xLAQR3, the Schur form is not reordered, so that the deflation stops at the first
+  * eigenvalue, from the bottom of the window, which cannot be deflated.
+  *
+  * \returns the number of deflated eigenvalues
+  */
+template<typename HessenbergType, typename SchurVectorsType, typename EigenvalueType>
+int ei_real_schur_deflation_window(HessenbergType& matH, SchurVectorsType& matZ, EigenvalueType& eivalues,
+                                   int ktop, int kbot, int windowSize, bool wantT, bool wantZ)
+{
+  typedef typename HessenbergType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrixType;
+  typedef Matrix<Scalar,Dynamic,1> DenseVectorType;
+  typedef Matrix<typename EigenvalueType::Scalar,Dynamic,1> DenseEigenvalueType;
+  const Scalar eps = std::numeric_limits<Scalar>::epsilon();
+  const Scalar smallNum = std::numeric_limits<Scalar>::min() * (Scalar(kbot-ktop+1) / eps);
+  const int nw = windowSize;
+  const int kwtop = kbot-nw+1;
+  const Scalar s = kwtop > ktop ? matH.coeff(kwtop,kwtop-1) : Scalar(0);
+
+  DenseMatrixType matT = matH.block(kwtop, kwtop, nw, nw);
+  DenseMatrixType matV = DenseMatrixType::Identity(nw, nw);
+  DenseEigenvalueType windowEivalues(nw);
+  ei_real_schur_double_shift(matT, matV, windowEivalues, 0, nw-1, true, true);
+  eivalues.segment(kwtop, nw) = windowEivalues;
+
+  // deflation test of the 1x1 and 2x2 diagonal blocks of T, from the bottom
+  int ns = nw;
+  while (ns > 0)
+  {
+    const bool isPair = ns > 1 && matT.coeff(ns-1,ns-2) != Scalar(0);
+    Scalar foo = ei_abs(matT.coeff(ns-1,ns-1));
+    Scalar spike = ei_abs(s * matV.coeff(0,ns-1));
+    if (isPair)
+    {
+      foo += ei_sqrt(ei_abs(matT.coeff(ns-1,ns-2))) * ei_sqrt(ei_abs(matT.coeff(ns-2,ns-1)));
+      spike = std::max(spike, ei_abs(s * matV.coeff(0,ns-2)));
+    }
+    if (spike > std::max(smallNum, eps * foo))
+      break;
+    ns -= isPair ? 2 : 1;
+  }
+  const int nd = nw - ns;
+  if (nd == 0)
+    return 0;
+
+  if (ns > 1 && s != Scalar(0))
+  {
+    // householder transformation mapping the undeflated part of the spike onto beta e_1
+    DenseVectorType essential = matV.row(0).start(ns).transpose();
+    Scalar v0 = essential.coeff(0);
+    Scalar tailNorm2 = essential.end(ns-1).squaredNorm();
+    if (tailNorm2 != Scalar(0))
+    {
+      Scalar beta = ei_sqrt(v0*v0 + tailNorm2);
+      if (v0 >= 0)
+        beta = -beta;
+      essential.end(ns-1) /= (v0 - beta);
+      essential.coeffRef(0) = 1;
+      Scalar h = (beta - v0) / beta;
+      DenseVectorType tmp;
+      tmp = (matT.block(0, 0, ns, nw).transpose() * essential).lazy();
+      matT.block(0, 0, ns, nw) -= h * essential * tmp.transpose();
+      tmp = (matT.block(0, 0, ns, ns) * essential).lazy();
+      matT.block(0, 0, ns, ns) -= h * tmp * essential.transpose();
+      tmp = (matV.block(0, 0, nw, ns) * essential).lazy();
+      matV.block(0, 0, nw, ns) -= h * tmp * essential.transpose();
+    }
+
+    // the undeflated part is reduced back to the Hessenberg form, which keeps the spike unchanged
+    if (ns > 2)
+    {
+      HessenbergDecomposition<DenseMatrixType> hess(matT.block(0, 0, ns, ns));
+      DenseMatrixType matQ = hess.matrixQ();
+      matT.block(0, 0, ns, ns) = hess.matrixH();
+      if (ns < nw)
+        matT.block(0, ns, ns, nw-ns) = matQ.transpose() * matT.block(0, ns, ns, nw-ns);
+      matV.block(0, 0, nw, ns) = matV.block(0, 0, nw, ns) * matQ;
+    }
+  }
+
+  matH.block(kwtop, kwtop, nw, nw) = matT;
+  if (kwtop > ktop)
+    matH.coeffRef(kwtop, kwtop-1) = ns > 0 ? s * matV.coeff(0,0) : Scalar(0);
+
+  // apply the orthogonal transformation V to the rest of the matrix
+  const int rowStart = wantT ? 0 : ktop;
+  if (kwtop > rowStart)
+    matH.block(rowStart, kwtop, kwtop-rowStart, nw) = matH.block(rowStart, kwtop, kwtop-rowStart, nw) * matV;
+  if (wantT && kbot+1 < matH.cols())
+    matH.block(kwtop, kbot+1, nw, matH.cols()-kbot-1) = matV.transpose() * matH.block(kwtop, kbot+1, nw, matH.cols()-kbot-1);
+  if (wantZ)
+    matZ.block(0, kwtop, matZ.rows(), nw) = matZ.block(0, kwtop, matZ.rows(), nw) * matV;
+  return nd;
+}
+
+/** \internal
+  * Performs one multishift QR sweep on the active block \a ktop .. \a kbot of \a matH, with the pairs of
+  * shifts whose sums and products are the rows of \a shifts. Each pair of shifts introduces a 3x3 bulge
+  * at the top of the block, which is chased down to the bottom. The bulges follow each other three
+  * rows apart, like in LAPACK's xLAQR5.
+  *
+  * The chain of bulges is moved by slabs of a few steps, during which the reflectors are only applied
+  * to the diagonal window which contains the chain, and accumulated in an orthogonal matrix U. The rows
+  * above and the columns right of the window are then updated at once by cache friendly products.
+  */
+template<typename HessenbergType, typename SchurVectorsType, typename ShiftsType>
+void ei_real_schur_multishift_sweep(HessenbergType& matH, SchurVectorsType& matZ, const ShiftsType& shifts,
+                                    int ktop, int kbot, bool wantT, bool wantZ)
+{
+  typedef typename HessenbergType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrixType;
+  const int bulgeCount = shifts.rows();
+  const int rowStart = wantT ? 0 : ktop;
+  const int colEnd = wantT ? matH.cols() : kbot+1;
+  // at the step t, the bulge b is in the column k = ktop-1+t-3b, for ktop-1 <= k <= kbot-2
+  const int stepCount = kbot-ktop + 3*(bulgeCount-1);
+  const int slabSize = std::max(3*bulgeCount, 12);
+
+  DenseMatrixType matU;
+  for (int t0 = 0; t0 < stepCount; t0 += slabSize)
+  {
+    const int t1 = std::min(t0+slabSize, stepCount);
+    const int w0 = std::max(ktop-1, ktop-1+t0-3*(bulgeCount-1)) + 1;
+    const int w1 = std::min(std::min(kbot-2, ktop-2+t1) + 4, kbot);
+    const int windowSize = w1-w0+1;
+    matU = DenseMatrixType::Identity(windowSize, windowSize);
+
+    for (int t = t0; t < t1; ++t)
+    {
+      // the lower bulges move first
+      for (int b = 0; b < bulgeCount; ++b)
+      {
+        const int k = ktop-1+t-3*b;
+        if (k > kbot-2)
+          continue;
+        if (k < ktop-1)
+          break;
+        const bool notlast = k < kbot-2;
+
+        Scalar x0, x1, x2 = 0;
+        if (k == ktop-1)
+        {
+          // first column of (H - s_1 I) (H - s_2 I)
+          const Scalar sum = shifts.coeff(b,0), prod = shifts.coeff(b,1);
+          const Scalar h00 = matH.coeff(ktop,ktop), h10 = matH.coeff(ktop+1,ktop);
+          const Scalar h01 = matH.coeff(ktop,ktop+1), h11 = matH.coeff(ktop+1,ktop+1);
+          const Scalar scale = ei_abs(h00) + ei_abs(h10) + ei_abs(h01) + ei_abs(h11) + ei_abs(sum) + ei_sqrt(ei_abs(prod));
+          if (scale == Scalar(0))
+            continue;
+          x0 = (h00*(h00-sum) + h01*h10 + prod) / scale / scale;
+          x1 = h10*(h00+h11-sum) / scale / scale;
+          if (notlast)
+            x2 = h10*matH.coeff(ktop+2,ktop+1) / scale / scale;
+        }
+        else
+        {
+          x0 = matH.coeff(k+1,k);
+          x1 = matH.coeff(k+2,k);
+          if (notlast)
+            x2 = matH.coeff(k+3,k);
+        }
+
+        // householder transformation I - h v v^T with v = [1 v1 v2] mapping x onto beta e_1
+        const Scalar scale = ei_abs(x0) + ei_abs(x1) + ei_abs(x2);
+        if (scale == Scalar(0) || (x1 == Scalar(0) && x2 == Scalar(0)))
+          continue;
+        x0 /= scale; x1 /= scale; x2 /= scale;
+        Scalar beta = ei_sqrt(x0*x0 + x1*x1 + x2*x2);
+        if (x0 >= 0)
+          beta = -beta;
+        const Scalar h = (beta - x0) / beta;
+        const Scalar v1 = x1 / (x0 - beta), v2 = x2 / (x0 - beta);
+        if (k >= ktop)
+        {
+          matH.coeffRef(k+1,k) = beta * scale;
+          matH.coeffRef(k+2,k) = 0;
+          if (notlast)
+            matH.coeffRef(k+3,k) = 0;
+        }
+
+        // Row modification, within the window
+        for (int j = k+1; j <= w1; ++j)
+        {
+          Scalar p = matH.coeff(k+1,j) + v1 * matH.coeff(k+2,j);
+          if (notlast)
+          {
+            p += v2 * matH.coeff(k+3,j);
+            matH.coeffRef(k+3,j) -= h * p * v2;
+          }
+          matH.coeffRef(k+1,j) -= h * p;
+          matH.coeffRef(k+2,j) -= h * p * v1;
+        }
+
+        // Column modification, within the window
+        for (int i = w0; i <= std::min(k+4,kbot); ++i)
+        {
+          Scalar p = matH.coeff(i,k+1) + v1 * matH.coeff(i,k+2);
+          if (notlast)
+          {
+            p += v2 * matH.coeff(i,k+3);
+            matH.coeffRef(i,k+3) -= h * p * v2;
+          }
+          matH.coeffRef(i,k+1) -= h * p;
+          matH.coeffRef(i,k+2) -= h * p * v1;
+        }
+
+        // Accumulate transformations
+        const int uk = k+1-w0;
+        for (int i = 0; i < windowSize; ++i)
+        {
+          Scalar p = matU.coeff(i,uk) + v1 * matU.coeff(i,uk+1);
+          if (notlast)
+          {
+            p += v2 * matU.coeff(i,uk+2);
+            matU.coeffRef(i,uk+2) -= h * p * v2;
+          }
+          matU.coeffRef(i,uk) -= h * p;
+          matU.coeffRef(i,uk+1) -= h * p * v1;
+        }
+      }
+    }
+
+    // apply U to the rows above and to the columns right of the window
+    if (colEnd > w1+1)
+      matH.block(w0, w1+1, windowSize, colEnd-w1-1) = matU.transpose() * matH.block(w0, w1+1, windowSize, colEnd-w1-1);
+    if (w0 > rowStart)
+      matH.block(rowStart, w0, w0-rowStart, windowSize) = matH.block(rowStart, w0, w0-rowStart, windowSize) * matU;
+    if (wantZ)
+      matZ.block(0, w0, matZ.rows(), windowSize) = matZ.block(0, w0, matZ.rows(), windowSize) * matU;
+  }
+}
+
+/** \internal
+  * Computes the real Schur form T = Z^T H Z of the upper Hessenberg matrix \a matH, and its eigenvalues.
+  * The matrix \a matH is overwritten by T if \a wantT is true, otherwise only its eigenvalues are meaningful,
+  * and \a matZ is replaced by \a matZ Z if \a wantZ is true. The complex conjugate pairs of eigenvalues are
+  * stored consecutively, with the positive imaginary part first, in the rows of the 2x2 diagonal blocks of T.
+  *
+  * The matrices smaller than 75 are processed by ei_real_schur_double_shift(). The larger ones are processed
+  * by the small bulge multishift QR algorithm with aggressive early deflation of Braman, Byers and Mathias,
+  * as in LAPACK's xLAQR0: each iteration first looks for deflations in a window at the bottom of the active
+  * block, by ei_real_schur_deflation_window(), and then uses the remaining eigenvalues of the window as
+  * shifts for a multishift QR sweep. After \a maxIterations sweeps, 30 max(10,n) by default like in LAPACK,
+  * the remaining blocks are processed by the double shift iteration.
+  */
+template<typename HessenbergType, typename SchurVectorsType, typename EigenvalueType>
+void ei_real_schur(HessenbergType& matH, SchurVectorsType& matZ, EigenvalueType& eivalues, bool wantT, bool wantZ,
+                   int maxIterations = -1)
+{
+  typedef typename HessenbergType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,2> ShiftsType;
+  const int n = matH.rows();
+  const int minSize = 75;
+  if (n < minSize)
+  {
+    ei_real_schur_double_shift(matH, matZ, eivalues, 0, n-1, wantT, wantZ);
+    return;
+  }
+
+  const Scalar eps = std::numeric_limits<Scalar>::epsilon();
+  const Scalar smallNum = std::numeric_limits<Scalar>::min() * (Scalar(n) / eps);
+  if (maxIterations < 0)
+    maxIterations = 30 * std::max(10, n);
+  ShiftsType shifts;
+  int iter = 0, itersSinceDeflation = 0;
+  int kbot = n-1;
+  while (kbot >= 0)
+  {
+    // look for a negligible subdiagonal coefficient, which splits the active block
+    int ktop = kbot;
+    for (; ktop > 0; --ktop)
+    {
+      const Scalar sub = ei_abs(matH.coeff(ktop,ktop-1));
+      if (sub <= std::max(smallNum, eps * (ei_abs(matH.coeff(ktop-1,ktop-1)) + ei_abs(matH.coeff(ktop,ktop)))))
+      {
+        matH.coeffRef(ktop,ktop-1) = 0;
+        break;
+      }
+    }
+
+    const int size = kbot-ktop+1;
+    if (size < minSize || iter >= maxIterations)
+    {
+      ei_real_schur_double_shift(matH, matZ, eivalues, ktop, kbot, wantT, wantZ);
+      kbot = ktop-1;
+      itersSinceDeflation = 0;
+      continue;
+    }
+    ++iter;
+
+    // number of shifts and size of the deflation window, as recommended by LAPACK's xIPARMQ
+    int shiftCount = size < 150 ? 10
+                   : size < 590 ? std::max(10, int(Scalar(size) / ei_log(Scalar(size)) * ei_log(Scalar(2)) + Scalar(0.5)))
+                   : size < 3000 ? 64 : size < 6000 ? 128 : 256;
+    shiftCount -= shiftCount % 2;
+    const int windowSize = std::min(size, size <= 500 ? shiftCount : 3*shiftCount/2);
+
+    const int nd = ei_real_schur_deflation_window(matH, matZ, eivalues, ktop, kbot, windowSize, wantT, wantZ);
+    kbot -= nd;
+    itersSinceDeflation = nd > 0 ? 0 : itersSinceDeflation+1;
+
+    // a new sweep is only worth it if the deflation window did not deflate much
+    if (nd != 0 && (100*nd > 14*windowSize || kbot-ktop+1 < minSize))
+      continue;
+
+    int bulgeCount = 0;
+    shifts.resize(shiftCount/2, 2);
+    if (itersSinceDeflation > 0 && itersSinceDeflation % 6 == 0)
+    {
+      // exceptional shifts
+      for (int i = kbot; i >= std::max(kbot-shiftCount+2, ktop+2); i -= 2)
+      {
+        const Scalar ss = ei_abs(matH.coeff(i,i-1)) + ei_abs(matH.coeff(i-1,i-2));
+        const Scalar aa = Scalar(0.75) * ss + matH.coeff(i,i);
+        shifts.coeffRef(bulgeCount,0) = Scalar(2) * aa;
+        shifts.coeffRef(bulgeCount,1) = aa*aa + Scalar(0.4375)*ss*ss;
+        ++bulgeCount;
+      }
+    }
+    else
+    {
+      // the undeflated eigenvalues of the window, from the bottom, the real ones being paired
+      const int first = std::max(kbot-(windowSize-nd)+1, kbot-shiftCount+1);
+      int realCount = 0;
+      Scalar pendingReal = 0;
+      for (int i = kbot; i >= first; --i)
+      {
+        const Scalar re = ei_real(eivalues.coeff(i)), im = ei_imag(eivalues.coeff(i));
+        if (im != Scalar(0))
+        {
+          if (i == first)
+            break;
+          shifts.coeffRef(bulgeCount,0) = Scalar(2) * re;
+          shifts.coeffRef(bulgeCount,1) = re*re + im*im;
+          ++bulgeCount;
+          --i;
+        }
+        else if (realCount++ % 2 == 0)
+          pendingReal = re;
+        else
+        {
+          shifts.coeffRef(bulgeCount,0) = pendingReal + re;
+          shifts.coeffRef(bulgeCount,1) = pendingReal * re;
+          ++bulgeCount;
+        }
+      }
+      // with only two real shifts, the one closest to the bottom coefficient is used twice
+      if (bulgeCount == 1 && realCount == 2)
+      {
+        const Scalar r1 = ei_real(eivalues.coeff(kbot)), r2 = ei_real(eivalues.coeff(kbot-1));
+        const Scalar r = ei_abs(r1-matH.coeff(kbot,kbot)) <= ei_abs(r2-matH.coeff(kbot,kbot)) ? r1 : r2;
+        shifts.coeffRef(0,0) = Scalar(2) * r;
+        shifts.coeffRef(0,1) = r * r;
+      }
+    }
+    if (bulgeCount == 0)
+    {
+      // Francis double shift from the bottom 2x2 block
+      shifts.coeffRef(0,0) = matH.coeff(kbot-1,kbot-1) + matH.coeff(kbot,kbot);
+      shifts.coeffRef(0,1) = matH.coeff(kbot-1,kbot-1)*matH.coeff(kbot,kbot) - matH.coeff(kbot-1,kbot)*matH.coeff(kbot,kbot-1);
+      bulgeCount = 1;
+    }
+
+    ei_real_schur_multishift_sweep(matH, matZ, shifts.block(0, 0, bulgeCount, 2), ktop, kbot, wantT, wantZ);
+  }
+}
+
+/** Computes the eigenvalues of \a matrix, as well as its eigenvectors if \a computeEigenvectors is true.
+  *
+  * \sa EigenSolver(const MatrixType&,bool)
+  */
+template<typename MatrixType>
+void EigenSolver<MatrixType>::compute(const MatrixType& matrix, bool computeEigenvectors)
+{
+  #ifndef NDEBUG
+  m_eigenvectorsOk = computeEigenvectors;
+  #endif
+  assert(matrix.cols() == matrix.rows());
+  int n = matrix.cols();
+  m_eivalues.resize(n,1);
+
+  // the work matrix lives in the scratch memory, see class ScratchScope
+  ei_scratch_buffer<Scalar, MatrixType::SizeAtCompileTime> matHBuffer(n*n);
+  Map<MatrixType> matH(matHBuffer.data(), n, n);
+
+  // Reduce to Hessenberg form.
+  if (n > 2)
+  {
+    HessenbergDecomposition<MatrixType> hess(matrix);
+    matH = hess.matrixH();
+    if (computeEigenvectors)
+      m_eivec = hess.matrixQ();
+  }
+  else
+  {
+    matH = matrix;
+    if (computeEigenvectors)
+      m_eivec = MatrixType::Identity(n,n);
+  }
+
+  // Reduce Hessenberg to real Schur form.
+  ei_real_schur(matH, m_eivec, m_eivalues, computeEigenvectors, computeEigenvectors);
+
+  if (computeEigenvectors)
+    hqr2(matH);
+}
+
+// Back substitution of the eigenvectors of the real Schur form, and back transformation.
+template<typename MatrixType>
+void EigenSolver<MatrixType>::hqr2(Map<MatrixType>& matH)
+{
+  //  This is derived from the Algol procedure hqr2,
+  //  by Martin and Wilkinson, Handbook for Auto. Comp.,
+  //  Vol.ii-Linear Algebra, and the corresponding
+  //  Fortran subroutine in EISPACK.
+
+  int nn = m_eivec.cols();
+  Scalar eps = std::numeric_limits<Scalar>::epsilon();
+  Scalar p=0,q=0,r=0,s=0,z=0,t,w,x,y;
+
+  // FIXME to be efficient the following would requires a triangular reduxion code
+  Scalar norm = 0.0;
+  for (int j = 0; j < nn; ++j)
+    norm += matH.row(j).segment(std::max(j-1,0), nn-std::max(j-1,0)).cwise().abs().sum();
+
   // Backsubstitute to find vectors of upper triangular form
   if (norm == 0.0)
   {
       return;
   }
 
-  for (n = nn-1; n >= 0; n--)
+  for (int n = nn-1; n >= 0; n--)
   {
     p = m_eivalues.coeff(n).real();
     q = m_eivalues.coeff(n).imag();
@@ -563,7 +942,7 @@ void EigenSolver<MatrixType>::hqr2(MatrixType& matH)
       for (int i = n-1; i >= 0; i--)
       {
         w = matH.coeff(i,i) - p;
-        r = (matH.row(i).segment(l,n-l+1) * matH.col(n).segment(l, n-l+1))(0,0);
+        r = matH.row(i).segment(l,n-l+1).dot(matH.col(n).segment(l, n-l+1));
 
         if (m_eivalues.coeff(i).imag() < 0.0)
         {
@@ -622,8 +1001,8 @@ void EigenSolver<MatrixType>::hqr2(MatrixType& matH)
       for (int i = n-2; i >= 0; i--)
       {
         Scalar ra,sa,vr,vi;
-        ra = (matH.block(i,l, 1, n-l+1) * matH.block(l,n-1, n-l+1, 1)).lazy()(0,0);
-        sa = (matH.block(i,l, 1, n-l+1) * matH.block(l,n, n-l+1, 1)).lazy()(0,0);
+        ra = matH.row(i).segment(l, n-l+1).dot(matH.col(n-1).segment(l, n-l+1));
+        sa = matH.row(i).segment(l, n-l+1).dot(matH.col(n).segment(l, n-l+1));
         w = matH.coeff(i,i) - p;
 
         if (m_eivalues.coeff(i).imag() < 0.0)
@@ -677,24 +1056,10 @@ void EigenSolver<MatrixType>::hqr2(MatrixType& matH)
     }
   }
 
-  // Vectors of isolated roots
-  for (int i = 0; i < nn; ++i)
-  {
-    // FIXME again what's the purpose of this test ?
-    // in this algo low==0 and high==nn-1 !!
-    if (i < low || i > high)
-    {
-      m_eivec.row(i).end(nn-i) = matH.row(i).end(nn-i);
-    }
-  }
-
   // Back transformation to get eigenvectors of original matrix
-  int bRows = high-low+1;
-  for (int j = nn-1; j >= low; j--)
-  {
-    int bSize = std::min(j,high)-low+1;
-    m_eivec.col(j).segment(low, bRows) = (m_eivec.block(low, low, bRows, bSize) * matH.col(j).segment(low, bSize));
-  }
+  for (int j = 0; j < nn-1; ++j)
+    matH.col(j).end(nn-j-1).setZero();
+  m_eivec = m_eivec * matH;
 }
 
 #endif // EIGEN_EIGENSOLVER_H
@@ -113,12 +113,15 @@ template<typename _MatrixType> class HessenbergDecomposition
     const MatrixType& packedMatrix(void) const { return m_matrix; }
 
     MatrixType matrixQ(void) const;
+    template<typename Derived> void applyQOnTheLeft(MatrixBase<Derived>& mat) const;
     MatrixType matrixH(void) const;
 
   private:
 
     static void _compute(MatrixType& matA, CoeffVectorType& hCoeffs);
 
+    static int _computeBlocked(MatrixType& matA, CoeffVectorType& hCoeffs);
+
   protected:
     MatrixType m_matrix;
     CoeffVectorType m_hCoeffs;
@@ -134,7 +137,8 @@ template<typename _MatrixType> class HessenbergDecomposition
   *
   * The result is written in the lower triangular part of \a matA.
   *
-  * Implemented from Golub's "Matrix Computations", algorithm 8.3.1.
+  * Implemented from Golub's "Matrix Computations", algorithm 8.3.1. The first columns of large
+  * matrices are reduced per panel by _computeBlocked().
   *
   * \sa packedMatrix()
   */
@@ -143,7 +147,7 @@ void HessenbergDecomposition<MatrixType>::_compute(MatrixType& matA, CoeffVector
 {
   assert(matA.rows()==matA.cols());
   int n = matA.rows();
-  for (int i = 0; i<n-2; ++i)
+  for (int i = _computeBlocked(matA, hCoeffs); i<n-2; ++i)
   {
     // let's consider the vector v = i-th column starting at position i+1
 
@@ -151,7 +155,8 @@ void HessenbergDecomposition<MatrixType>::_compute(MatrixType& matA, CoeffVector
     // squared norm of the vector v skipping the first element
     RealScalar v1norm2 = matA.col(i).end(n-(i+2)).squaredNorm();
 
-    if (ei_isMuchSmallerThan(v1norm2,static_cast<Scalar>(1)))
+    // the matrix is not symmetric, and may be scaled arbitrarily: only an exactly zero column is skipped
+    if (v1norm2 == RealScalar(0))
     {
       hCoeffs.coeffRef(i) = 0.;
     }
@@ -206,6 +211,114 @@ void HessenbergDecomposition<MatrixType>::_compute(MatrixType& matA, CoeffVector
   }
 }
 
+/** \internal
+  * Reduces the first columns of \a matA per panel of EIGEN_DECOMPOSITION_BLOCK_SIZE columns, and returns
+  * the index of the first column which remains to be reduced by _compute(). Small matrices are left untouched.
+  *
+  * Within a panel, the Householder vectors v_i are computed one at a time as in _compute(), while the
+  * block reflector Q = I - V T V^* of the panel and the product Y = A V T are accumulated. Each column of
+  * the panel is corrected on the fly by Y and V before its reduction, and the trailing matrix then receives
+  * the whole similarity transformation Q^* (A - Y V^*) at once, by cache friendly products. This is the
+  * algorithm of LAPACK's xGEHRD and xLAHR2.
+  */
+template<typename MatrixType>
+int HessenbergDecomposition<MatrixType>::_computeBlocked(MatrixType& matA, CoeffVectorType& hCoeffs)
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrixType;
+  typedef Matrix<Scalar,Dynamic,1> DenseVectorType;
+  const int n = matA.rows();
+  const int blockSize = EIGEN_DECOMPOSITION_BLOCK_SIZE;
+  if (n < 2*blockSize)
+    return 0;
+
+  DenseMatrixType matV(n, blockSize);
+  DenseMatrixType matY(n, blockSize);
+  DenseMatrixType triFactor(blockSize, blockSize);
+  DenseMatrixType tmpBlock;
+  DenseVectorType tmp(blockSize);
+  int k = 0;
+  for (; n-k >= 2*blockSize; k += blockSize)
+  {
+    const int panelEnd = k + blockSize;
+    matV.setZero();
+    triFactor.setZero();
+    for (int i = k; i < panelEnd; ++i)
+    {
+      const int j = i - k;
+      const int remainingSize = n-i-1;
+
+      // apply the previous transformations of the panel to the column i: a = Q^* (A - Y V^*) e_i
+      if (j > 0)
+      {
+        matA.col(i) -= matY.block(0, 0, n, j) * matV.row(i).start(j).adjoint();
+        tmp.start(j) = matV.block(k+1, 0, n-k-1, j).adjoint() * matA.col(i).end(n-k-1);
+        tmp.start(j) = triFactor.block(0, 0, j, j).adjoint() * tmp.start(j);
+        matA.col(i).end(n-k-1) -= matV.block(k+1, 0, n-k-1, j) * tmp.start(j);
+      }
+
+      // householder transformation, see _compute()
+      Scalar h = 0;
+      RealScalar v1norm2 = matA.col(i).end(n-(i+2)).squaredNorm();
+      if (v1norm2 != RealScalar(0))
+      {
+        Scalar v0 = matA.col(i).coeff(i+1);
+        RealScalar beta = ei_sqrt(ei_abs2(v0)+v1norm2);
+        if (ei_real(v0)>=0.)
+          beta = -beta;
+        matA.col(i).end(n-(i+2)) *= (Scalar(1)/(v0-beta));
+        matA.col(i).coeffRef(i+1) = beta;
+        h = (beta - v0) / beta;
+      }
+      hCoeffs.coeffRef(i) = h;
+      matV.coeffRef(i+1,j) = 1;
+      matV.col(j).end(n-(i+2)) = matA.col(i).end(n-(i+2));
+
+      // y = h (A - Y V^*) v, where A is the matrix at the start of the panel, and t = -h T V^* v
+      Block<DenseMatrixType,Dynamic,1> y(matY, 0, j, n, 1);
+      y = (matA.block(0, i+1, n, remainingSize) * matV.col(j).end(remainingSize)).lazy();
+      if (j > 0)
+      {
+        tmp.start(j) = matV.block(i+1, 0, remainingSize, j).adjoint() * matV.col(j).end(remainingSize);
+        y -= matY.block(0, 0, n, j) * tmp.start(j);
+        triFactor.col(j).start(j) = -h * (triFactor.block(0, 0, j, j) * tmp.start(j));
+      }
+      y *= h;
+      triFactor.coeffRef(j,j) = h;
+    }
+
+    // A = Q^* (A - Y V^*) Q on the trailing columns, the columns of the panel being already reduced
+    const int trailingSize = n - panelEnd;
+    matA.block(0, panelEnd, n, trailingSize).noalias()
+      -= matY * matV.block(panelEnd, 0, trailingSize, blockSize).adjoint();
+    tmpBlock = matV.block(k+1, 0, n-k-1, blockSize).adjoint() * matA.block(k+1, panelEnd, n-k-1, trailingSize);
+    tmpBlock = triFactor.adjoint() * tmpBlock;
+    matA.block(k+1, panelEnd, n-k-1, trailingSize).noalias() -= matV.block(k+1, 0, n-k-1, blockSize) * tmpBlock;
+  }
+  return k;
+}
+
+/** Replaces \a mat by Q \a mat, without forming the matrix Q. Since the decomposed matrix equals Q H Q^*,
+  * this maps vectors expressed in the basis of the Hessenberg matrix H, such as its Schur vectors, back to
+  * the original basis.
+  *
+  * \a mat must have as many rows as the decomposed matrix. The Householder transformations of Q, stored
+  * below the subdiagonal of packedMatrix(), are applied by ei_apply_householder_sequence_on_the_left(),
+  * per block in their compact WY form for large matrices.
+  *
+  * \sa matrixQ(), packedMatrix()
+  */
+template<typename MatrixType>
+template<typename Derived>
+void HessenbergDecomposition<MatrixType>::applyQOnTheLeft(MatrixBase<Derived>& mat) const
+{
+  int n = m_matrix.rows();
+  ei_assert(mat.rows() == n);
+  if (n < 2)
+    return;
+  ei_apply_householder_sequence_on_the_left(mat.block(1, 0, n-1, mat.cols()),
+                                            m_matrix.block(1, 0, n-1, n-1), m_hCoeffs);
+}
+
 /** reconstructs and returns the matrix Q */
 template<typename MatrixType>
 typename HessenbergDecomposition<MatrixType>::MatrixType
@@ -213,6 +326,11 @@ HessenbergDecomposition<MatrixType>::matrixQ(void) const
 {
   int n = m_matrix.rows();
   MatrixType matQ = MatrixType::Identity(n,n);
+  if (n-1 >= 2*EIGEN_DECOMPOSITION_BLOCK_SIZE)
+  {
+    applyQOnTheLeft(matQ);
+    return matQ;
+  }
   for (int i = n-2; i>=0; i--)
   {
     Scalar tmp = m_matrix.coeff(i+1,i);
@@ -0,0 +1,150 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra. Eigen itself is part of the KDE project.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_HOUSEHOLDER_H
+#define EIGEN_HOUSEHOLDER_H
+
+/** \internal
+  * Builds the upper triangular factor \a triFactor of the block of Householder reflectors
+  * stored in \a vectors, such that H_0 H_1 ... H_{n-1} = I - V T V^*, where H_i = I - h_i v_i v_i^*
+  * and \c h_i \c = \c hCoeffs[i] (compact WY representation).
+  *
+  * As in QR, the vector v_i is stored below the diagonal of the i-th column of \a vectors, and its first
+  * coefficient, equal to 1, is implicit. The diagonal and the upper part of \a vectors are not used:
+  * \a v1 is the unit lower triangular top of V, as built by ei_apply_block_householder_on_the_left().
+  */
+template<typename TriangularFactorType, typename VectorsType, typename V1Type, typename CoeffsType>
+void ei_make_block_householder_triangular_factor(TriangularFactorType& triFactor, const VectorsType& vectors,
+                                                 const V1Type& v1, const CoeffsType& hCoeffs)
+{
+  typedef typename VectorsType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrixType;
+  const int nbVecs = vectors.cols();
+  const int rows = vectors.rows();
+  ei_assert(rows >= nbVecs && v1.rows() == nbVecs && v1.cols() == nbVecs);
+
+  // the Gram matrix V^* V, computed by a single cache friendly product for the dense part of V
+  DenseMatrixType gram = v1.adjoint() * v1;
+  if (rows > nbVecs)
+    gram.noalias() += vectors.block(nbVecs, 0, rows-nbVecs, nbVecs).adjoint() * vectors.block(nbVecs, 0, rows-nbVecs, nbVecs);
+
+  triFactor.resize(nbVecs, nbVecs);
+  triFactor.setZero();
+  for (int i = 0; i < nbVecs; ++i)
+  {
+    const Scalar h = hCoeffs.coeff(i);
+    triFactor.coeffRef(i,i) = h;
+    if (i > 0)
+      triFactor.col(i).start(i) = -h * (triFactor.block(0, 0, i, i) * gram.col(i).start(i));
+  }
+}
+
+/** \internal
+  * Applies the block of Householder reflectors H = H_0 H_1 ... H_{n-1} stored in \a vectors and \a hCoeffs
+  * (see ei_make_block_householder_triangular_factor()) from the left: \a mat is replaced by H^* mat if
+  * \a adjoint is true, and by H mat otherwise.
+  *
+  * Both passes over \a mat are cache friendly matrix products, instead of one rank-1 update per reflector.
+  */
+template<typename MatrixType, typename VectorsType, typename CoeffsType>
+void ei_apply_block_householder_on_the_left(MatrixType mat, const VectorsType& vectors, const CoeffsType& hCoeffs, bool adjoint)
+{
+  typedef typename VectorsType::Scalar Scalar;
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrixType;
+  const int nbVecs = vectors.cols();
+  const int rows = vectors.rows();
+  const int cols = mat.cols();
+  ei_assert(mat.rows() == rows && rows >= nbVecs);
+
+  // the top of V is unit lower triangular: it is the only part of V which has to be copied
+  DenseMatrixType v1 = DenseMatrixType::Zero(nbVecs, nbVecs);
+  v1.template part<StrictlyLowerTriangular>() = vectors.block(0, 0, nbVecs, nbVecs);
+  v1.diagonal().setOnes();
+
+  DenseMatrixType triFactor;
+  ei_make_block_householder_triangular_factor(triFactor, vectors, v1, hCoeffs);
+
+  // tmp = V^* mat
+  DenseMatrixType tmp = v1.adjoint() * mat.block(0, 0, nbVecs, cols);
+  if (rows > nbVecs)
+    tmp.noalias() += vectors.block(nbVecs, 0, rows-nbVecs, nbVecs).adjoint() * mat.block(nbVecs, 0, rows-nbVecs, cols);
+
+  // tmp = T tmp or T^* tmp
+  if (adjoint)
+    tmp = triFactor.adjoint() * tmp;
+  else
+    tmp = triFactor * tmp;
+
+  // mat -= V tmp
+  mat.block(0, 0, nbVecs, cols) -= v1 * tmp;
+  if (rows > nbVecs)
+    mat.block(nbVecs, 0, rows-nbVecs, cols).noalias() -= vectors.block(nbVecs, 0, rows-nbVecs, nbVecs) * tmp;
+}
+
+/** \internal
+  * Replaces \a mat by H_0 H_1 ... H_{n-1} \a mat, where the Householder reflectors H_i are stored in \a vectors
+  * and \a hCoeffs as in ei_apply_block_householder_on_the_left(), and n is the number of columns of \a vectors.
+  *
+  * Large sequences are applied per block of EIGEN_DECOMPOSITION_BLOCK_SIZE reflectors, from the last block to
+  * the first one. Short ones are applied one reflector at a time.
+  */
+template<typename MatrixType, typename VectorsType, typename CoeffsType>
+void ei_apply_householder_sequence_on_the_left(MatrixType mat, const VectorsType& vectors, const CoeffsType& hCoeffs)
+{
+  typedef typename VectorsType::Scalar Scalar;
+  typedef Matrix<Scalar,1,Dynamic> RowVectorType;
+  const int nbVecs = vectors.cols();
+  const int rows = vectors.rows();
+  const int cols = mat.cols();
+  ei_assert(mat.rows() == rows && rows >= nbVecs && hCoeffs.size() >= nbVecs);
+
+  if (nbVecs >= 2*EIGEN_DECOMPOSITION_BLOCK_SIZE)
+  {
+    const int blockSize = EIGEN_DECOMPOSITION_BLOCK_SIZE;
+    for (int k = ((nbVecs-1)/blockSize)*blockSize; k >= 0; k -= blockSize)
+    {
+      const int panelSize = std::min(blockSize, nbVecs-k);
+      ei_apply_block_householder_on_the_left(mat.block(k, 0, rows-k, cols),
+                                             vectors.block(k, k, rows-k, panelSize),
+                                             hCoeffs.segment(k, panelSize), false);
+    }
+    return;
+  }
+
+  for (int i = nbVecs-1; i >= 0; --i)
+  {
+    // mat -= h v (v^* mat), where the first coefficient of v is 1 and the others are stored below the diagonal
+    const Scalar h = hCoeffs.coeff(i);
+    const int tailSize = rows-i-1;
+    if (tailSize == 0)
+    {
+      mat.row(i) *= Scalar(1) - h;
+      continue;
+    }
+    RowVectorType tmp = mat.row(i);
+    tmp += (vectors.col(i).end(tailSize).adjoint() * mat.block(i+1, 0, tailSize, cols)).lazy();
+    mat.row(i) -= h * tmp;
+    mat.block(i+1, 0, tailSize, cols) -= ((h * vectors.col(i).end(tailSize)) * tmp).lazy();
+  }
+}
+
+#endif // EIGEN_HOUSEHOLDER_H
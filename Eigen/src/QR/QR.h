@@ -37,6 +37,9 @@
   * This class performs a QR decomposition using Householder transformations. The result is
   * stored in a compact way compatible with LAPACK.
   *
+  * Large matrices are factorized per panel of EIGEN_DECOMPOSITION_BLOCK_SIZE columns, whose reflectors are
+  * applied at once in the compact WY form, so that most of the work is done by the cache friendly matrix product.
+  *
   * \sa MatrixBase::qr()
   */
 template<typename MatrixType> class QR
@@ -49,13 +52,22 @@ template<typename MatrixType> class QR
     typedef Matrix<Scalar, MatrixType::ColsAtCompileTime, MatrixType::ColsAtCompileTime> MatrixTypeR;
     typedef Matrix<Scalar, MatrixType::ColsAtCompileTime, 1> VectorType;
 
+    /** Default Constructor.
+      *
+      * The default constructor is useful in cases in which the user intends to
+      * perform decompositions via QR::compute(const MatrixType&).
+      */
+    QR() : m_rank(0), m_rankIsUptodate(false) {}
+
     QR(const MatrixType& matrix)
       : m_qr(matrix.rows(), matrix.cols()),
         m_hCoeffs(matrix.cols())
     {
-      _compute(matrix);
+      compute(matrix);
     }
 
+    void compute(const MatrixType& matrix);
+
     /** \returns whether or not the matrix is of full rank */
     bool isFullRank() const { return rank() == std::min(m_qr.rows(),m_qr.cols()); }
     
@@ -73,7 +85,13 @@ template<typename MatrixType> class QR
 
   private:
 
-    void _compute(const MatrixType& matrix);
+    void computePanel(int start, int end);
+
+    /** \internal \returns the width of the panels of reflectors for a matrix of \a cols columns */
+    static int blockSizeFor(int cols)
+    {
+      return cols >= 2*EIGEN_DECOMPOSITION_BLOCK_SIZE ? EIGEN_DECOMPOSITION_BLOCK_SIZE : cols;
+    }
 
   protected:
     MatrixType m_qr;
@@ -101,15 +119,17 @@ int QR<MatrixType>::rank() const
 
 #ifndef EIGEN_HIDE_HEAVY_CODE
 
+/** \internal
+  * Computes the Householder reflectors of the columns \a start to \a end of m_qr, and applies each
+  * of them to the next columns of the same panel only.
+  */
 template<typename MatrixType>
-void QR<MatrixType>::_compute(const MatrixType& matrix)
+void QR<MatrixType>::computePanel(int start, int end)
 {
-  m_rankIsUptodate = false;
-  m_qr = matrix;
-  int rows = matrix.rows();
-  int cols = matrix.cols();
+  int rows = m_qr.rows();
+  ei_scratch_buffer<Scalar, MatrixType::ColsAtCompileTime> tmpBuffer(end-start);
 
-  for (int k = 0; k < cols; ++k)
+  for (int k = start; k < end; ++k)
   {
     int remainingSize = rows-k;
 
@@ -142,14 +162,16 @@ void QR<MatrixType>::_compute(const MatrixType& matrix)
       m_qr.coeffRef(k,k) = beta;
       Scalar h = m_hCoeffs.coeffRef(k) = (beta - v0) / beta;
 
-      // apply the Householder transformation (I - h v v') to remaining columns, i.e.,
+      // apply the Householder transformation (I - h v v') to remaining columns of the panel, i.e.,
       // R <- (I - h v v') * R   where v = [1,m_qr(k+1,k), m_qr(k+2,k), ...]
-      int remainingCols = cols - k -1;
+      int remainingCols = end - k -1;
       if (remainingCols>0)
       {
         m_qr.coeffRef(k,k) = Scalar(1);
-        m_qr.corner(BottomRight, remainingSize, remainingCols) -= ei_conj(h) * m_qr.col(k).end(remainingSize)
-            * (m_qr.col(k).end(remainingSize).adjoint() * m_qr.corner(BottomRight, remainingSize, remainingCols));
+        Map<Matrix<Scalar,1,Dynamic> > tmp(tmpBuffer.data(), remainingCols);
+        tmp = (m_qr.col(k).end(remainingSize).adjoint() * m_qr.block(k, k+1, remainingSize, remainingCols)).lazy();
+        tmp *= ei_conj(h);
+        m_qr.block(k, k+1, remainingSize, remainingCols) -= (m_qr.col(k).end(remainingSize) * tmp).lazy();
         m_qr.coeffRef(k,k) = beta;
       }
     }
@@ -160,6 +182,36 @@ void QR<MatrixType>::_compute(const MatrixType& matrix)
   }
 }
 
+/** Computes / recomputes the QR decomposition of \a matrix
+  *
+  * The storage of the decomposition is reused when \a matrix has the same size as the previous one.
+  *
+  * Large matrices are factorized per panel of EIGEN_DECOMPOSITION_BLOCK_SIZE columns: the reflectors of a panel
+  * are accumulated in the compact WY form I - V T V^*, which is applied to the remaining columns by cache
+  * friendly matrix products.
+  */
+template<typename MatrixType>
+void QR<MatrixType>::compute(const MatrixType& matrix)
+{
+  m_rankIsUptodate = false;
+  m_qr = matrix;
+  m_hCoeffs.resize(matrix.cols());
+  int rows = matrix.rows();
+  int cols = matrix.cols();
+
+  const int blockSize = blockSizeFor(cols);
+  for (int k = 0; k < cols; k += blockSize)
+  {
+    const int panelEnd = std::min(k+blockSize, cols);
+    computePanel(k, panelEnd);
+
+    if (panelEnd < cols)
+      ei_apply_block_householder_on_the_left(m_qr.block(k, panelEnd, rows-k, cols-panelEnd),
+                                             m_qr.block(k, k, rows-k, panelEnd-k),
+                                             m_hCoeffs.segment(k, panelEnd-k), true);
+  }
+}
+
 /** \returns the matrix Q */
 template<typename MatrixType>
 MatrixType QR<MatrixType>::matrixQ(void) const
@@ -170,6 +222,21 @@ MatrixType QR<MatrixType>::matrixQ(void) const
   int rows = m_qr.rows();
   int cols = m_qr.cols();
   MatrixType res = MatrixType::Identity(rows, cols);
+
+  const int blockSize = blockSizeFor(cols);
+  if (blockSize < cols)
+  {
+    // apply the blocks of reflectors from the last one, each one in the compact WY form
+    for (int k = ((cols-1)/blockSize)*blockSize; k >= 0; k -= blockSize)
+    {
+      const int panelSize = std::min(blockSize, cols-k);
+      ei_apply_block_householder_on_the_left(res.block(k, k, rows-k, cols-k),
+                                             m_qr.block(k, k, rows-k, panelSize),
+                                             m_hCoeffs.segment(k, panelSize), false);
+    }
+    return res;
+  }
+
   for (int k = cols-1; k >= 0; k--)
   {
     // to make easier the computation of the transformation, let's temporarily
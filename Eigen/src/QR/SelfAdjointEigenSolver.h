@@ -34,8 +34,18 @@
   *
   * \param MatrixType the type of the matrix of which we are computing the eigen decomposition
   *
+  * The matrix is first reduced to a real tridiagonal matrix (see class Tridiagonalization), whose
+  * eigenvalues are computed by implicit symmetric QR steps. The eigenvectors of large matrices are
+  * computed by the divide and conquer method instead, and computeSmallest() and computeLargest()
+  * compute only a few eigenpairs, by bisection and inverse iteration. Fixed size 2x2 and 3x3 real matrices
+  * are solved in closed form from their characteristic polynomial instead, and computeBatch() solves
+  * arrays of such small matrices at once.
+  *
   * \note MatrixType must be an actual Matrix type, it can't be an expression type.
   *
+  * \note computeSmallest() and computeLargest() resize the eigenvectors and eigenvalues to the number
+  * of requested eigenpairs, so that they require a dynamic size MatrixType unless all of them are requested.
+  *
   * \sa MatrixBase::eigenvalues(), class EigenSolver
   */
 template<typename _MatrixType> class SelfAdjointEigenSolver
@@ -93,6 +103,28 @@ template<typename _MatrixType> class SelfAdjointEigenSolver
 
     void compute(const MatrixType& matA, const MatrixType& matB, bool computeEigenvectors = true);
 
+    /** Computes the \a count smallest eigenvalues of the selfadjoint matrix \a matrix, in increasing order,
+      * as well as the corresponding eigenvectors if \a computeEigenvectors is true.
+      *
+      * \sa computeLargest(), compute(MatrixType,bool)
+      */
+    void computeSmallest(const MatrixType& matrix, int count, bool computeEigenvectors = true)
+    {
+      computeRange(matrix, 0, count, computeEigenvectors);
+    }
+
+    /** Computes the \a count largest eigenvalues of the selfadjoint matrix \a matrix, in increasing order,
+      * as well as the corresponding eigenvectors if \a computeEigenvectors is true.
+      *
+      * \sa computeSmallest(), compute(MatrixType,bool)
+      */
+    void computeLargest(const MatrixType& matrix, int count, bool computeEigenvectors = true)
+    {
+      computeRange(matrix, matrix.cols()-count, count, computeEigenvectors);
+    }
+
+    static void computeBatch(const MatrixType* matrices, int count, RealVectorType* eivalues, MatrixType* eivecs = 0);
+
     /** \returns the computed eigen vectors as a matrix of column vectors */
     MatrixType eigenvectors(void) const
     {
@@ -125,6 +157,8 @@ template<typename _MatrixType> class SelfAdjointEigenSolver
 
 
   protected:
+    void computeRange(const MatrixType& matrix, int first, int count, bool computeEigenvectors);
+
     MatrixType m_eivec;
     RealVectorType m_eivalues;
     #ifndef NDEBUG
@@ -175,9 +209,211 @@ static void ei_givens_rotation(Scalar a, Scalar b, Scalar& c, Scalar& s)
 template<typename RealScalar, typename Scalar>
 static void ei_tridiagonal_qr_step(RealScalar* diag, RealScalar* subdiag, int start, int end, Scalar* matrixQ, int n);
 
+template<typename RealScalar, typename Scalar>
+static void ei_tridiagonal_qr(RealScalar* diag, RealScalar* subdiag, int n, Scalar* matrixQ);
+
+template<typename RealScalar>
+static void ei_tridiagonal_divide_and_conquer(RealScalar* diag, RealScalar* subdiag,
+                                              Matrix<RealScalar,Dynamic,Dynamic>& eivecs, int start, int size);
+
+template<typename RealScalar>
+static void ei_tridiagonal_bisection(const RealScalar* diag, const RealScalar* subdiag, int n,
+                                     int first, int count, RealScalar* eivals);
+
+template<typename RealScalar>
+static void ei_tridiagonal_inverse_iteration(const RealScalar* diag, const RealScalar* subdiag, int n,
+                                             const RealScalar* eivals, Matrix<RealScalar,Dynamic,Dynamic>& eivecs);
+
+/** \internal
+  *
+  * Closed form eigen decomposition of fixed size selfadjoint matrices. The generic version does nothing
+  * and returns false, so that the iterative path is used.
+  */
+template<typename MatrixType,
+         int Size = MatrixType::RowsAtCompileTime,
+         bool IsComplex = NumTraits<typename MatrixType::Scalar>::IsComplex>
+struct ei_selfadjoint_eigensolver_direct
+{
+  template<typename VectorType>
+  static bool run(const MatrixType&, VectorType&, MatrixType&, bool) { return false; }
+};
+
+/** \internal
+  * 2x2 real matrices: the eigenvalues are the roots of a quadratic, and the eigenvector of the largest one
+  * is read from the singular matrix A - lambda I.
+  */
+template<typename MatrixType>
+struct ei_selfadjoint_eigensolver_direct<MatrixType,2,false>
+{
+  typedef typename MatrixType::Scalar Scalar;
+
+  template<typename VectorType>
+  static bool run(const MatrixType& matrix, VectorType& eivals, MatrixType& eivecs, bool computeEigenvectors)
+  {
+    // shift and scale the matrix to avoid over/underflow, only its lower triangular part is read
+    Scalar shift = Scalar(0.5) * (matrix.coeff(0,0) + matrix.coeff(1,1));
+    Scalar m00 = matrix.coeff(0,0) - shift, m10 = matrix.coeff(1,0), m11 = matrix.coeff(1,1) - shift;
+    Scalar scale = std::max(std::max(ei_abs(m00), ei_abs(m10)), ei_abs(m11));
+    if (scale > Scalar(0))
+    {
+      m00 /= scale; m10 /= scale; m11 /= scale;
+    }
+
+    Scalar t0 = Scalar(0.5) * ei_sqrt(ei_abs2(m00-m11) + Scalar(4)*ei_abs2(m10));
+    Scalar t1 = Scalar(0.5) * (m00+m11);
+    eivals.coeffRef(0) = t1 - t0;
+    eivals.coeffRef(1) = t1 + t0;
+
+    if (computeEigenvectors)
+    {
+      if (t0 <= std::numeric_limits<Scalar>::epsilon())
+        eivecs.setIdentity();
+      else
+      {
+        // (-b, a) and (-c, b) are both in the kernel of [a b; b c], keep the one of largest norm
+        m00 -= eivals.coeff(1);
+        m11 -= eivals.coeff(1);
+        Scalar a2 = ei_abs2(m00), b2 = ei_abs2(m10), c2 = ei_abs2(m11);
+        if (a2 > c2)
+        {
+          Scalar n = ei_sqrt(a2+b2);
+          eivecs.coeffRef(0,1) = -m10/n;
+          eivecs.coeffRef(1,1) = m00/n;
+        }
+        else
+        {
+          Scalar n = ei_sqrt(b2+c2);
+          eivecs.coeffRef(0,1) = -m11/n;
+          eivecs.coeffRef(1,1) = m10/n;
+        }
+        eivecs.coeffRef(0,0) = -eivecs.coeff(1,1);
+        eivecs.coeffRef(1,0) = eivecs.coeff(0,1);
+      }
+    }
+
+    eivals = eivals * scale + VectorType::Constant(shift);
+    return true;
+  }
+};
+
+/** \internal
+  * 3x3 real matrices: the eigenvalues are the roots of the characteristic polynomial, obtained by the
+  * trigonometric solution of the cubic. The eigenvector of the most isolated eigenvalue is computed as the
+  * largest cross product of two columns of A - lambda I, the second one likewise or, if the two other
+  * eigenvalues are equal, by orthogonalizing a column of A - lambda I, and the last one by a cross product.
+  */
+template<typename MatrixType>
+struct ei_selfadjoint_eigensolver_direct<MatrixType,3,false>
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar,3,1> VectorType;
+
+  static inline VectorType cross(const VectorType& a, const VectorType& b)
+  {
+    return VectorType(a.y()*b.z() - a.z()*b.y(), a.z()*b.x() - a.x()*b.z(), a.x()*b.y() - a.y()*b.x());
+  }
+
+  // the unit vector spanning the kernel of the singular matrix mat, whose rank is 2;
+  // representative is set to one of its non zero columns
+  static void extractKernel(const MatrixType& mat, VectorType& res, VectorType& representative)
+  {
+    // by construction, mat is semi-definite and non zero, so that its largest diagonal coefficient is non zero
+    int i0;
+    mat.diagonal().cwise().abs().maxCoeff(&i0);
+    representative = mat.col(i0);
+    VectorType c0 = cross(representative, mat.col((i0+1)%3));
+    VectorType c1 = cross(representative, mat.col((i0+2)%3));
+    Scalar n0 = c0.squaredNorm(), n1 = c1.squaredNorm();
+    if (n0 > n1)
+      res = c0 / ei_sqrt(n0);
+    else
+      res = c1 / ei_sqrt(n1);
+  }
+
+  template<typename RealVectorType>
+  static bool run(const MatrixType& matrix, RealVectorType& eivals, MatrixType& eivecs, bool computeEigenvectors)
+  {
+    const Scalar eps = std::numeric_limits<Scalar>::epsilon();
+
+    // shift and scale the matrix to avoid over/underflow, only its lower triangular part is read
+    Scalar shift = matrix.diagonal().sum() / Scalar(3);
+    MatrixType scaledMat;
+    for (int j = 0; j < 3; ++j)
+      for (int i = j; i < 3; ++i)
+        scaledMat.coeffRef(j,i) = scaledMat.coeffRef(i,j) = matrix.coeff(i,j);
+    scaledMat.diagonal().cwise() -= shift;
+    Scalar scale = scaledMat.cwise().abs().maxCoeff();
+    if (scale > Scalar(0))
+      scaledMat /= scale;
+
+    // coefficients of the characteristic polynomial x^3 - c2 x^2 + c1 x - c0
+    Scalar m00 = scaledMat.coeff(0,0), m10 = scaledMat.coeff(1,0), m11 = scaledMat.coeff(1,1);
+    Scalar m20 = scaledMat.coeff(2,0), m21 = scaledMat.coeff(2,1), m22 = scaledMat.coeff(2,2);
+    Scalar c0 = m00*m11*m22 + Scalar(2)*m10*m20*m21 - m00*m21*m21 - m11*m20*m20 - m22*m10*m10;
+    Scalar c1 = m00*m11 - m10*m10 + m00*m22 - m20*m20 + m11*m22 - m21*m21;
+    Scalar c2 = m00 + m11 + m22;
+
+    // the roots are real, so that the depressed cubic has a non positive discriminant
+    Scalar c2_over_3 = c2 / Scalar(3);
+    Scalar a_over_3 = std::max((c2*c2_over_3 - c1) / Scalar(3), Scalar(0));
+    Scalar half_b = Scalar(0.5) * (c0 + c2_over_3 * (Scalar(2)*c2_over_3*c2_over_3 - c1));
+    Scalar q = std::max(a_over_3*a_over_3*a_over_3 - half_b*half_b, Scalar(0));
+
+    // theta lies in [0,pi/3], so that the roots come out in increasing order
+    Scalar rho = ei_sqrt(a_over_3);
+    Scalar theta = std::atan2(ei_sqrt(q), half_b) / Scalar(3);
+    Scalar cos_theta = ei_cos(theta), sin_theta = ei_sin(theta);
+    Scalar sqrt3 = ei_sqrt(Scalar(3));
+    eivals.coeffRef(0) = c2_over_3 - rho*(cos_theta + sqrt3*sin_theta);
+    eivals.coeffRef(1) = c2_over_3 - rho*(cos_theta - sqrt3*sin_theta);
+    eivals.coeffRef(2) = c2_over_3 + Scalar(2)*rho*cos_theta;
+
+    if (computeEigenvectors)
+    {
+      if (eivals.coeff(2) - eivals.coeff(0) <= eps)
+        eivecs.setIdentity();
+      else
+      {
+        Scalar d0 = eivals.coeff(2) - eivals.coeff(1);
+        Scalar d1 = eivals.coeff(1) - eivals.coeff(0);
+        int k = d0 > d1 ? 2 : 0, l = 2-k;
+
+        MatrixType tmp = scaledMat;
+        tmp.diagonal().cwise() -= eivals.coeff(k);
+        VectorType vk, representative;
+        extractKernel(tmp, vk, representative);
+        eivecs.col(k) = vk;
+
+        VectorType vl;
+        if (std::min(d0,d1) <= Scalar(2)*eps*std::max(d0,d1))
+        {
+          // the two other eigenvalues are equal, and any vector orthogonal to vk is an eigenvector
+          vl = representative - vk.dot(representative) * vk;
+          vl.normalize();
+        }
+        else
+        {
+          tmp = scaledMat;
+          tmp.diagonal().cwise() -= eivals.coeff(l);
+          extractKernel(tmp, vl, representative);
+        }
+        eivecs.col(l) = vl;
+        eivecs.col(1) = cross(eivecs.col(2), eivecs.col(0)).normalized();
+      }
+    }
+
+    eivals = eivals * scale + RealVectorType::Constant(shift);
+    return true;
+  }
+};
+
 /** Computes the eigenvalues of the selfadjoint matrix \a matrix,
   * as well as the eigenvectors if \a computeEigenvectors is true.
   *
+  * The eigenvalues are sorted in increasing order. Fixed size 2x2 and 3x3 real matrices are solved
+  * in closed form, which is faster but slightly less accurate for the eigenvalues much smaller than
+  * the largest one.
+  *
   * \sa SelfAdjointEigenSolver(MatrixType,bool), compute(MatrixType,MatrixType,bool)
   */
 template<typename MatrixType>
@@ -189,6 +425,25 @@ void SelfAdjointEigenSolver<MatrixType>::compute(const MatrixType& matrix, bool
   assert(matrix.cols() == matrix.rows());
   int n = matrix.cols();
   m_eivalues.resize(n,1);
+
+  if (ei_selfadjoint_eigensolver_direct<MatrixType>::run(matrix, m_eivalues, m_eivec, computeEigenvectors))
+    return;
+
+  if (computeEigenvectors && n >= 2*EIGEN_DECOMPOSITION_BLOCK_SIZE)
+  {
+    // the eigenvectors of the tridiagonal matrix are computed by divide and conquer, and
+    // the Householder transformations of the tridiagonalization are then applied to them
+    TridiagonalizationType tridiag(matrix);
+    RealVectorTypeX diag = tridiag.diagonal();
+    RealVectorTypeX subdiag = tridiag.subDiagonal();
+    Matrix<RealScalar,Dynamic,Dynamic> eivecs = Matrix<RealScalar,Dynamic,Dynamic>::Zero(n, n);
+    ei_tridiagonal_divide_and_conquer(diag.data(), subdiag.data(), eivecs, 0, n);
+    m_eivalues = diag;
+    m_eivec = eivecs.template cast<Scalar>();
+    tridiag.applyQOnTheLeft(m_eivec);
+    return;
+  }
+
   m_eivec = matrix;
 
   // FIXME, should tridiag be a local variable of this function or an attribute of SelfAdjointEigenSolver ?
@@ -198,25 +453,7 @@ void SelfAdjointEigenSolver<MatrixType>::compute(const MatrixType& matrix, bool
   typename TridiagonalizationType::SubDiagonalType subdiag(n-1);
   TridiagonalizationType::decomposeInPlace(m_eivec, diag, subdiag, computeEigenvectors);
 
-  int end = n-1;
-  int start = 0;
-  while (end>0)
-  {
-    for (int i = start; i<end; ++i)
-      if (ei_isMuchSmallerThan(ei_abs(subdiag[i]),(ei_abs(diag[i])+ei_abs(diag[i+1]))))
-        subdiag[i] = 0;
-
-    // find the largest unreduced block
-    while (end>0 && subdiag[end-1]==0)
-      end--;
-    if (end<=0)
-      break;
-    start = end - 1;
-    while (start>0 && subdiag[start-1]!=0)
-      start--;
-
-    ei_tridiagonal_qr_step(diag.data(), subdiag.data(), start, end, computeEigenvectors ? m_eivec.data() : (Scalar*)0, n);
-  }
+  ei_tridiagonal_qr(diag.data(), subdiag.data(), n, computeEigenvectors ? m_eivec.data() : (Scalar*)0);
 
   // Sort eigenvalues and corresponding vectors.
   // TODO make the sort optional ?
@@ -233,6 +470,83 @@ void SelfAdjointEigenSolver<MatrixType>::compute(const MatrixType& matrix, bool
   }
 }
 
+template<typename MatrixType>
+struct ei_selfadjoint_eigensolver_batch_kernel
+{
+  typedef typename NumTraits<typename MatrixType::Scalar>::Real RealScalar;
+  typedef Matrix<RealScalar, MatrixType::ColsAtCompileTime, 1> RealVectorType;
+
+  ei_selfadjoint_eigensolver_batch_kernel(const MatrixType* matrices, RealVectorType* eivalues, MatrixType* eivecs)
+    : m_matrices(matrices), m_eivalues(eivalues), m_eivecs(eivecs) {}
+
+  void operator()(int start, int end) const
+  {
+    MatrixType dummy;
+    for (int i = start; i < end; ++i)
+    {
+      MatrixType& eivecs = m_eivecs ? m_eivecs[i] : dummy;
+      if (!ei_selfadjoint_eigensolver_direct<MatrixType>::run(m_matrices[i], m_eivalues[i], eivecs, m_eivecs!=0))
+      {
+        SelfAdjointEigenSolver<MatrixType> solver(m_matrices[i], m_eivecs!=0);
+        m_eivalues[i] = solver.eigenvalues();
+        if (m_eivecs)
+          eivecs = solver.eigenvectors();
+      }
+    }
+  }
+
+  const MatrixType* m_matrices;
+  RealVectorType* m_eivalues;
+  MatrixType* m_eivecs;
+};
+
+/** Computes the eigenvalues of the \a count selfadjoint matrices \a matrices into \a eivalues, as well as
+  * their eigenvectors into \a eivecs unless it is null. Both output arrays must hold \a count elements.
+  *
+  * This is meant for large sets of small fixed size matrices, typically 3x3 covariance matrices, which are
+  * solved in closed form without any temporary solver object, and split across several threads if OpenMP
+  * is enabled.
+  *
+  * \sa compute(MatrixType,bool)
+  */
+template<typename MatrixType>
+void SelfAdjointEigenSolver<MatrixType>::computeBatch(const MatrixType* matrices, int count,
+                                                      RealVectorType* eivalues, MatrixType* eivecs)
+{
+  ei_parallelize(ei_selfadjoint_eigensolver_batch_kernel<MatrixType>(matrices, eivalues, eivecs), count, 1024);
+}
+
+/** \internal
+  * Computes the eigenvalues of index \a first to \a first + \a count - 1 of the selfadjoint matrix \a matrix,
+  * in increasing order, as well as the corresponding eigenvectors if \a computeEigenvectors is true.
+  *
+  * The eigenvalues of the tridiagonal matrix are isolated by bisection and the eigenvectors are computed
+  * by inverse iteration, so that the cost of this step is proportional to the number of requested eigenpairs.
+  */
+template<typename MatrixType>
+void SelfAdjointEigenSolver<MatrixType>::computeRange(const MatrixType& matrix, int first, int count, bool computeEigenvectors)
+{
+  #ifndef NDEBUG
+  m_eigenvectorsOk = computeEigenvectors;
+  #endif
+  int n = matrix.cols();
+  ei_assert(matrix.rows() == n && first >= 0 && count >= 0 && first+count <= n);
+
+  TridiagonalizationType tridiag(matrix);
+  RealVectorTypeX diag = tridiag.diagonal();
+  RealVectorTypeX subdiag = tridiag.subDiagonal();
+  m_eivalues.resize(count);
+  ei_tridiagonal_bisection(diag.data(), subdiag.data(), n, first, count, m_eivalues.data());
+
+  if (computeEigenvectors)
+  {
+    Matrix<RealScalar,Dynamic,Dynamic> eivecs(n, count);
+    ei_tridiagonal_inverse_iteration(diag.data(), subdiag.data(), n, m_eivalues.data(), eivecs);
+    m_eivec = eivecs.template cast<Scalar>();
+    tridiag.applyQOnTheLeft(m_eivec);
+  }
+}
+
 /** Computes the eigenvalues of the generalized eigen problem
   * \f$ Ax = lambda B x \f$ with \a matA the selfadjoint matrix \f$ A \f$
   * and \a matB the positive definite matrix \f$ B \f$ . The eigenvectors
@@ -389,6 +703,568 @@ static void ei_tridiagonal_qr_step(RealScalar* diag, RealScalar* subdiag, int st
     }
   }
 }
+
+/** \internal
+  * Diagonalizes the symmetric tridiagonal matrix of size \a n represented by \a diag and \a subdiag
+  * by implicit symmetric QR steps, and applies the rotations to the columns of the \a n x \a n matrix
+  * \a matrixQ if it is not null. The eigenvalues are written in \a diag, in no particular order.
+  */
+template<typename RealScalar, typename Scalar>
+static void ei_tridiagonal_qr(RealScalar* diag, RealScalar* subdiag, int n, Scalar* matrixQ)
+{
+  int end = n-1;
+  int start = 0;
+  while (end>0)
+  {
+    for (int i = start; i<end; ++i)
+      if (ei_isMuchSmallerThan(ei_abs(subdiag[i]),(ei_abs(diag[i])+ei_abs(diag[i+1]))))
+        subdiag[i] = 0;
+
+    // find the largest unreduced block
+    while (end>0 && subdiag[end-1]==0)
+      end--;
+    if (end<=0)
+      break;
+    start = end - 1;
+    while (start>0 && subdiag[start-1]!=0)
+      start--;
+
+    ei_tridiagonal_qr_step(diag, subdiag, start, end, matrixQ, n);
+  }
+}
+
+/** \internal
+  * Solves the secular equations 1 + rho sum_j z_j^2 / (d_j - lambda) = 0 giving the eigenvalues of
+  * D + rho z z^T, where the d_j are increasing and rho is positive. The i-th root lies between d_i and
+  * d_{i+1}, and is represented as d_{origin_i} + tau_i, where d_{origin_i} is the closest pole, such that
+  * the differences d_j - lambda_i are accurate.
+  *
+  * Each root is found by the rational interpolation of the two closest poles (the "middle way" of
+  * LAPACK's xLAED4), safeguarded by bisection. The roots are independent and computed concurrently.
+  */
+template<typename RealScalar>
+struct ei_secular_equation_kernel
+{
+  typedef Matrix<RealScalar,Dynamic,1> VectorType;
+  typedef Matrix<int,Dynamic,1> IntVectorType;
+
+  ei_secular_equation_kernel(const VectorType& d, const VectorType& z, RealScalar rho,
+                             IntVectorType& origins, VectorType& taus)
+    : m_d(d), m_z(z), m_rho(rho), m_origins(origins), m_taus(taus) {}
+
+  void operator()(int start, int end) const
+  {
+    const int size = m_d.size();
+    const RealScalar eps = std::numeric_limits<RealScalar>::epsilon();
+    for (int i = start; i < end; ++i)
+    {
+      // bracket the root relatively to its closest pole
+      int origin = i;
+      RealScalar lo = 0, hi;
+      if (i < size-1)
+      {
+        const RealScalar gap = m_d.coeff(i+1) - m_d.coeff(i);
+        hi = gap / 2;
+        RealScalar f = 1;
+        for (int j = 0; j < size; ++j)
+          f += m_rho * m_z.coeff(j) * m_z.coeff(j) / ((m_d.coeff(j) - m_d.coeff(i)) - hi);
+        if (f < 0)
+        {
+          origin = i+1;
+          lo = -hi;
+          hi = 0;
+        }
+      }
+      else
+        hi = m_rho * m_z.squaredNorm();
+
+      RealScalar tau = (lo + hi) / 2;
+      for (int iter = 0; iter < 100; ++iter)
+      {
+        // f and the derivatives of its parts psi and phi, with the poles up to d_i and after d_i respectively
+        RealScalar f = 1, absSum = 1, dpsi = 0, dphi = 0;
+        for (int j = 0; j < size; ++j)
+        {
+          const RealScalar t = m_z.coeff(j) / ((m_d.coeff(j) - m_d.coeff(origin)) - tau);
+          const RealScalar term = m_rho * m_z.coeff(j) * t;
+          f += term;
+          absSum += ei_abs(term);
+          if (j <= i)
+            dpsi += m_rho * t * t;
+          else
+            dphi += m_rho * t * t;
+        }
+        if (ei_abs(f) <= RealScalar(8) * eps * absSum)
+          break;
+        if (f > 0)
+          hi = tau;
+        else
+          lo = tau;
+
+        // root of c + s/(d_i-lambda) + S/(d_{i+1}-lambda), having the same value and derivatives as f at tau
+        const RealScalar deltaI = (m_d.coeff(i) - m_d.coeff(origin)) - tau;
+        RealScalar eta;
+        if (i < size-1)
+        {
+          const RealScalar deltaN = (m_d.coeff(i+1) - m_d.coeff(origin)) - tau;
+          const RealScalar c = f - dpsi*deltaI - dphi*deltaN;
+          const RealScalar b = c*(deltaI+deltaN) + dpsi*deltaI*deltaI + dphi*deltaN*deltaN;
+          const RealScalar a = deltaI * deltaN * f;
+          const RealScalar disc = ei_sqrt(ei_abs(b*b - RealScalar(4)*a*c));
+          eta = b > 0 ? RealScalar(2)*a / (b + disc) : (b - disc) / (RealScalar(2)*c);
+        }
+        else
+        {
+          const RealScalar c = f - dpsi*deltaI;
+          eta = deltaI + dpsi*deltaI*deltaI / c;
+        }
+
+        RealScalar newTau = tau + eta;
+        if (!(newTau > lo && newTau < hi))
+          newTau = (lo + hi) / 2;
+        const bool converged = ei_abs(newTau - tau) <= RealScalar(2) * eps * ei_abs(newTau);
+        tau = newTau;
+        if (converged)
+          break;
+      }
+      m_origins.coeffRef(i) = origin;
+      m_taus.coeffRef(i) = tau;
+    }
+  }
+
+  const VectorType& m_d;
+  const VectorType& m_z;
+  const RealScalar m_rho;
+  IntVectorType& m_origins;
+  VectorType& m_taus;
+
+  private:
+    ei_secular_equation_kernel& operator=(const ei_secular_equation_kernel&);
+};
+
+/** \internal orders indices by increasing values of the array they refer to */
+template<typename RealScalar>
+struct ei_index_less
+{
+  ei_index_less(const RealScalar* values) : m_values(values) {}
+  bool operator()(int i, int j) const { return m_values[i] < m_values[j]; }
+  const RealScalar* m_values;
+};
+
+/** \internal
+  * Computes the eigenvalues and eigenvectors of the symmetric tridiagonal matrix of size \a size starting
+  * at the index \a start of \a diag and \a subdiag, by Cuppen's divide and conquer method. The eigenvalues
+  * are written in \a diag, in increasing order, and the eigenvectors in the corresponding diagonal block of
+  * \a eivecs, which must be zero outside of this block.
+  *
+  * The matrix is split into two halves modified by a rank one correction, which are solved recursively.
+  * The eigenvalues of the merged problem D + rho z z^T are the roots of the secular equation, and its
+  * eigenvectors are computed from a vector z recomputed from these roots (Gu and Eisenstat), such that
+  * they are numerically orthogonal. The bulk of the work is the product of the eigenvectors of the two
+  * halves by these eigenvectors, which is a cache friendly matrix product. Small blocks are solved by
+  * implicit symmetric QR steps.
+  */
+template<typename RealScalar>
+static void ei_tridiagonal_divide_and_conquer(RealScalar* diag, RealScalar* subdiag,
+                                              Matrix<RealScalar,Dynamic,Dynamic>& eivecs, int start, int size)
+{
+  typedef Matrix<RealScalar,Dynamic,Dynamic> MatrixType;
+  typedef Matrix<RealScalar,Dynamic,1> VectorType;
+  typedef Matrix<int,Dynamic,1> IntVectorType;
+  const RealScalar eps = std::numeric_limits<RealScalar>::epsilon();
+
+  if (size <= 32)
+  {
+    MatrixType q = MatrixType::Identity(size, size);
+    ei_tridiagonal_qr(diag+start, subdiag+start, size, q.data());
+    Map<VectorType> eivals(diag+start, size);
+    for (int i = 0; i < size-1; ++i)
+    {
+      int k;
+      eivals.segment(i,size-i).minCoeff(&k);
+      if (k > 0)
+      {
+        std::swap(eivals[i], eivals[k+i]);
+        q.col(i).swap(q.col(k+i));
+      }
+    }
+    eivecs.block(start, start, size, size) = q;
+    return;
+  }
+
+  // T = diag(T1,T2) + beta u u^T, where u has two unit coefficients at the split
+  const int size1 = size/2;
+  const int size2 = size - size1;
+  const int mid = start + size1;
+  const RealScalar beta = subdiag[mid-1];
+  diag[mid-1] -= ei_abs(beta);
+  diag[mid] -= ei_abs(beta);
+  ei_tridiagonal_divide_and_conquer(diag, subdiag, eivecs, start, size1);
+  ei_tridiagonal_divide_and_conquer(diag, subdiag, eivecs, mid, size2);
+
+  // in the basis of the eigenvectors of T1 and T2: T = D + rho z z^T, with a unit z
+  const RealScalar rho = RealScalar(2) * ei_abs(beta);
+  VectorType z(size);
+  z.start(size1) = eivecs.row(mid-1).segment(start, size1).transpose();
+  z.end(size2) = eivecs.row(mid).segment(mid, size2).transpose();
+  if (beta < 0)
+    z.end(size2) = -z.end(size2);
+  z /= ei_sqrt(RealScalar(2));
+
+  // merge the sorted eigenvalues of the two halves; the column perm[j] of the block goes with d[j]
+  IntVectorType perm(size);
+  for (int j = 0, j1 = 0, j2 = size1; j < size; ++j)
+    perm[j] = (j2 == size || (j1 < size1 && diag[start+j1] <= diag[start+j2])) ? j1++ : j2++;
+  VectorType d(size), zs(size);
+  IntVectorType types(size); // 1: the column is zero below the split, 3: above it, 2: neither
+  for (int j = 0; j < size; ++j)
+  {
+    d[j] = diag[start+perm[j]];
+    zs[j] = z[perm[j]];
+    types[j] = perm[j] < size1 ? 1 : 3;
+  }
+
+  // deflation: the entries of negligible z are eigenvalues, and close pairs of entries of d are rotated
+  // such that one of them gets a negligible z
+  const RealScalar tol = RealScalar(8) * eps * std::max(d.cwise().abs().maxCoeff(), rho);
+  IntVectorType kept(size), deflated(size);
+  int nbKept = 0, nbDeflated = 0, prev = -1;
+  for (int j = 0; j < size; ++j)
+  {
+    if (rho * ei_abs(zs[j]) <= tol)
+    {
+      deflated[nbDeflated++] = j;
+      continue;
+    }
+    if (prev >= 0)
+    {
+      const RealScalar tau = ei_sqrt(zs[prev]*zs[prev] + zs[j]*zs[j]);
+      const RealScalar c = zs[j] / tau;
+      const RealScalar s = -zs[prev] / tau;
+      if (ei_abs((d[j] - d[prev]) * c * s) <= tol)
+      {
+        zs[j] = tau;
+        zs[prev] = 0;
+        for (int i = start; i < start+size; ++i)
+        {
+          const RealScalar x = eivecs.coeff(i, start+perm[prev]);
+          const RealScalar y = eivecs.coeff(i, start+perm[j]);
+          eivecs.coeffRef(i, start+perm[prev]) = c*x + s*y;
+          eivecs.coeffRef(i, start+perm[j]) = c*y - s*x;
+        }
+        if (types[prev] != types[j])
+          types[prev] = types[j] = 2;
+        const RealScalar dprev = d[prev]*c*c + d[j]*s*s;
+        d[j] = d[prev]*s*s + d[j]*c*c;
+        d[prev] = dprev;
+        deflated[nbDeflated++] = prev;
+        prev = j;
+        continue;
+      }
+      kept[nbKept++] = prev;
+    }
+    prev = j;
+  }
+  if (prev >= 0)
+    kept[nbKept++] = prev;
+
+  // the deflated eigenpairs are kept as is, after the non deflated ones
+  const int K = nbKept;
+  Map<VectorType> eivals(diag+start, size);
+  MatrixType q(size, size);
+  for (int p = 0; p < nbDeflated; ++p)
+  {
+    q.col(K+p) = eivecs.col(start+perm[deflated[p]]).segment(start, size);
+    eivals[K+p] = d[deflated[p]];
+  }
+
+  if (K > 0)
+  {
+    VectorType dk(K), zk(K), taus(K);
+    IntVectorType origins(K);
+    for (int p = 0; p < K; ++p)
+    {
+      dk[p] = d[kept[p]];
+      zk[p] = zs[kept[p]];
+    }
+    ei_parallelize(ei_secular_equation_kernel<RealScalar>(dk, zk, rho, origins, taus), K, 32);
+
+    // u(j,i) = d_j - lambda_i, then z is recomputed from the roots (Lowner's formula):
+    // zhat_j^2 = prod_i (lambda_i - d_j) / (rho prod_{i!=j} (d_i - d_j))
+    MatrixType u(K, K);
+    for (int i = 0; i < K; ++i)
+      for (int j = 0; j < K; ++j)
+        u.coeffRef(j,i) = (dk[j] - dk[origins[i]]) - taus[i];
+    for (int j = 0; j < K; ++j)
+    {
+      RealScalar prod = -u.coeff(j,j) / rho;
+      for (int i = 0; i < K; ++i)
+        if (i != j)
+          prod *= u.coeff(j,i) / (dk[j] - dk[i]);
+      zk[j] = (zk[j] < 0 ? -1 : 1) * ei_sqrt(ei_abs(prod));
+    }
+    for (int i = 0; i < K; ++i)
+    {
+      u.col(i) = zk.cwise() / u.col(i);
+      u.col(i).normalize();
+      eivals[i] = dk[origins[i]] + taus[i];
+    }
+
+    // order the columns by type, such that the products by u skip the zero blocks of diag(Q1,Q2)
+    MatrixType uPerm(K, K);
+    int pos = 0, nbType1 = 0, nbType3 = 0;
+    for (int type = 1; type <= 3; ++type)
+      for (int p = 0; p < K; ++p)
+        if (types[kept[p]] == type)
+        {
+          q.col(pos) = eivecs.col(start+perm[kept[p]]).segment(start, size);
+          uPerm.row(pos++) = u.row(p);
+          if (type == 1) ++nbType1;
+          if (type == 3) ++nbType3;
+        }
+
+    const int nbTop = K - nbType3, nbBottom = K - nbType1;
+    if (nbTop > 0)
+      eivecs.block(start, start, size1, K) = (q.block(0, 0, size1, nbTop) * uPerm.block(0, 0, nbTop, K)).lazy();
+    else
+      eivecs.block(start, start, size1, K).setZero();
+    if (nbBottom > 0)
+      eivecs.block(mid, start, size2, K) = (q.block(size1, nbType1, size2, nbBottom) * uPerm.block(nbType1, 0, nbBottom, K)).lazy();
+    else
+      eivecs.block(mid, start, size2, K).setZero();
+  }
+  if (nbDeflated > 0)
+    eivecs.block(start, start+K, size, nbDeflated) = q.block(0, K, size, nbDeflated);
+
+  // the roots are increasing, sort the deflated eigenvalues among them and gather the columns once
+  if (nbDeflated > 0)
+  {
+    IntVectorType order(size);
+    for (int j = 0; j < size; ++j)
+      order[j] = j;
+    std::stable_sort(order.data(), order.data()+size, ei_index_less<RealScalar>(eivals.data()));
+    for (int j = 0; j < size; ++j)
+    {
+      q.col(j) = eivecs.col(start+order[j]).segment(start, size);
+      d[j] = eivals[order[j]];
+    }
+    eivecs.block(start, start, size, size) = q;
+    eivals = d;
+  }
+}
+
+/** \internal \returns the number of eigenvalues of the symmetric tridiagonal matrix of size \a n smaller than \a x,
+  * given by the signs of its Sturm sequence. The pivots smaller than \a pivmin are replaced by -pivmin.
+  */
+template<typename RealScalar>
+static int ei_tridiagonal_sturm_count(const RealScalar* diag, const RealScalar* subdiag, int n, RealScalar x, RealScalar pivmin)
+{
+  int count = 0;
+  RealScalar q = diag[0] - x;
+  for (int i = 0; ; )
+  {
+    if (ei_abs(q) < pivmin)
+      q = -pivmin;
+    if (q < 0)
+      ++count;
+    if (++i == n)
+      break;
+    q = diag[i] - x - subdiag[i-1] * subdiag[i-1] / q;
+  }
+  return count;
+}
+
+/** \internal
+  * Isolates by bisection the eigenvalues of index \a start + first to \a end + first - 1, in increasing order,
+  * of the symmetric tridiagonal matrix \a diag, \a subdiag, starting from the interval [\a lower, \a upper].
+  */
+template<typename RealScalar>
+struct ei_tridiagonal_bisection_kernel
+{
+  ei_tridiagonal_bisection_kernel(const RealScalar* diag, const RealScalar* subdiag, int n, int first,
+                                  RealScalar lower, RealScalar upper, RealScalar pivmin, RealScalar absTol,
+                                  RealScalar* eivals)
+    : m_diag(diag), m_subdiag(subdiag), m_n(n), m_first(first), m_lower(lower), m_upper(upper),
+      m_pivmin(pivmin), m_absTol(absTol), m_eivals(eivals) {}
+
+  void operator()(int start, int end) const
+  {
+    const RealScalar eps = std::numeric_limits<RealScalar>::epsilon();
+    for (int k = start; k < end; ++k)
+    {
+      RealScalar lo = m_lower, hi = m_upper;
+      for (;;)
+      {
+        const RealScalar mid = (lo + hi) / 2;
+        if (hi - lo <= RealScalar(2)*eps*std::max(ei_abs(lo),ei_abs(hi)) + m_absTol || mid <= lo || mid >= hi)
+          break;
+        if (ei_tridiagonal_sturm_count(m_diag, m_subdiag, m_n, mid, m_pivmin) > m_first+k)
+          hi = mid;
+        else
+          lo = mid;
+      }
+      m_eivals[k] = (lo + hi) / 2;
+    }
+  }
+
+  const RealScalar* m_diag;
+  const RealScalar* m_subdiag;
+  const int m_n;
+  const int m_first;
+  const RealScalar m_lower;
+  const RealScalar m_upper;
+  const RealScalar m_pivmin;
+  const RealScalar m_absTol;
+  RealScalar* m_eivals;
+
+  private:
+    ei_tridiagonal_bisection_kernel& operator=(const ei_tridiagonal_bisection_kernel&);
+};
+
+/** \internal
+  * Computes the eigenvalues of index \a first to \a first + \a count - 1, in increasing order, of the symmetric
+  * tridiagonal matrix of size \a n represented by \a diag and \a subdiag, by bisection (LAPACK's xSTEBZ).
+  */
+template<typename RealScalar>
+static void ei_tridiagonal_bisection(const RealScalar* diag, const RealScalar* subdiag, int n,
+                                     int first, int count, RealScalar* eivals)
+{
+  const RealScalar eps = std::numeric_limits<RealScalar>::epsilon();
+
+  // Gershgorin interval
+  RealScalar lower = diag[0], upper = diag[0], maxSubdiag2 = 1;
+  for (int i = 0; i < n; ++i)
+  {
+    const RealScalar radius = (i > 0 ? ei_abs(subdiag[i-1]) : RealScalar(0)) + (i < n-1 ? ei_abs(subdiag[i]) : RealScalar(0));
+    lower = std::min(lower, diag[i] - radius);
+    upper = std::max(upper, diag[i] + radius);
+    if (i < n-1)
+      maxSubdiag2 = std::max(maxSubdiag2, subdiag[i]*subdiag[i]);
+  }
+  const RealScalar pivmin = std::numeric_limits<RealScalar>::min() * maxSubdiag2;
+  const RealScalar tnorm = std::max(ei_abs(lower), ei_abs(upper));
+  lower -= RealScalar(2)*eps*tnorm*n + RealScalar(2)*pivmin;
+  upper += RealScalar(2)*eps*tnorm*n + RealScalar(2)*pivmin;
+
+  ei_parallelize(ei_tridiagonal_bisection_kernel<RealScalar>(diag, subdiag, n, first, lower, upper, pivmin, eps*tnorm, eivals),
+                 count, 16);
+}
+
+/** \internal
+  * Computes by inverse iteration the eigenvectors of the symmetric tridiagonal matrix of size \a n represented
+  * by \a diag and \a subdiag, for the increasing eigenvalues \a eivals, one per column of \a eivecs. The vectors
+  * of close eigenvalues are orthogonalized against each other (LAPACK's xSTEIN).
+  */
+template<typename RealScalar>
+static void ei_tridiagonal_inverse_iteration(const RealScalar* diag, const RealScalar* subdiag, int n,
+                                             const RealScalar* eivals, Matrix<RealScalar,Dynamic,Dynamic>& eivecs)
+{
+  typedef Matrix<RealScalar,Dynamic,1> VectorType;
+  const RealScalar eps = std::numeric_limits<RealScalar>::epsilon();
+  const int count = eivecs.cols();
+
+  RealScalar tnorm = 0; // 1-norm of the tridiagonal matrix
+  for (int i = 0; i < n; ++i)
+    tnorm = std::max(tnorm, ei_abs(diag[i]) + (i > 0 ? ei_abs(subdiag[i-1]) : RealScalar(0))
+                                            + (i < n-1 ? ei_abs(subdiag[i]) : RealScalar(0)));
+  const RealScalar orthoTol = RealScalar(1e-3) * tnorm;
+  const RealScalar minPivot = std::max(eps * tnorm, std::numeric_limits<RealScalar>::min());
+  const RealScalar minGrowth = ei_sqrt(RealScalar(0.1) / n);
+
+  // the LU factorization with partial pivoting of T - lambda I: U has two super diagonals
+  VectorType u0(n), u1(n), u2(n), l(n), x(n);
+  Matrix<int,Dynamic,1> pivots(n);
+  unsigned int seed = 1;
+  int clusterStart = 0;
+  RealScalar lambda = 0;
+  for (int k = 0; k < count; ++k)
+  {
+    // equal eigenvalues are slightly separated, and the vectors of a cluster are orthogonalized
+    const RealScalar prevLambda = lambda;
+    lambda = eivals[k];
+    if (k > 0)
+    {
+      const RealScalar perturbation = RealScalar(10) * eps * ei_abs(lambda);
+      if (lambda - prevLambda < perturbation)
+        lambda = prevLambda + perturbation;
+      if (lambda - prevLambda > orthoTol)
+        clusterStart = k;
+    }
+
+    for (int i = 0; i < n; ++i)
+    {
+      u0[i] = diag[i] - lambda;
+      u1[i] = i < n-1 ? subdiag[i] : RealScalar(0);
+      u2[i] = 0;
+    }
+    for (int i = 0; i < n-1; ++i)
+    {
+      if (ei_abs(u0[i]) >= ei_abs(subdiag[i]))
+      {
+        pivots[i] = 0;
+        l[i] = u0[i] == RealScalar(0) ? RealScalar(0) : subdiag[i] / u0[i];
+        u0[i+1] -= l[i] * u1[i];
+      }
+      else
+      {
+        // swap the rows i and i+1
+        pivots[i] = 1;
+        l[i] = u0[i] / subdiag[i];
+        u0[i] = subdiag[i];
+        const RealScalar tmp = u0[i+1];
+        u0[i+1] = u1[i] - l[i] * tmp;
+        u1[i] = tmp;
+        if (i < n-2)
+        {
+          u2[i] = u1[i+1];
+          u1[i+1] = -l[i] * u2[i];
+        }
+      }
+    }
+    for (int i = 0; i < n; ++i)
+      if (ei_abs(u0[i]) < minPivot)
+        u0[i] = u0[i] < 0 ? -minPivot : minPivot;
+
+    // pseudo random starting vector
+    for (int i = 0; i < n; ++i)
+    {
+      seed = seed * 1103515245u + 12345u;
+      x[i] = RealScalar((seed >> 16) & 0x7fff) / RealScalar(16384) - RealScalar(1);
+    }
+
+    for (int iter = 0, nbConverged = 0; iter < 5 && nbConverged < 3; ++iter)
+    {
+      // the scaling makes a large growth of x meaningful
+      x *= std::max(n * tnorm * std::max(eps, ei_abs(u0[n-1])), std::numeric_limits<RealScalar>::min())
+         / x.cwise().abs().sum();
+
+      for (int i = 0; i < n-1; ++i)
+      {
+        if (pivots[i])
+          std::swap(x[i], x[i+1]);
+        x[i+1] -= l[i] * x[i];
+      }
+      x[n-1] /= u0[n-1];
+      if (n > 1)
+        x[n-2] = (x[n-2] - u1[n-2] * x[n-1]) / u0[n-2];
+      for (int i = n-3; i >= 0; --i)
+        x[i] = (x[i] - u1[i] * x[i+1] - u2[i] * x[i+2]) / u0[i];
+
+      for (int j = clusterStart; j < k; ++j)
+        x -= eivecs.col(j).dot(x) * eivecs.col(j);
+
+      if (x.cwise().abs().maxCoeff() >= minGrowth)
+        ++nbConverged;
+    }
+
+    x.normalize();
+    int maxIndex;
+    x.cwise().abs().maxCoeff(&maxIndex);
+    if (x[maxIndex] < 0)
+      x = -x;
+    eivecs.col(k) = x;
+  }
+}
 #endif
 
 #endif // EIGEN_SELFADJOINTEIGENSOLVER_H
@@ -116,6 +116,7 @@ template<typename _MatrixType> class Tridiagonalization
     inline const MatrixType& packedMatrix(void) const { return m_matrix; }
 
     MatrixType matrixQ(void) const;
+    template<typename Derived> void applyQOnTheLeft(MatrixBase<Derived>& mat) const;
     MatrixType matrixT(void) const;
     const DiagonalReturnType diagonal(void) const;
     const SubDiagonalReturnType subDiagonal(void) const;
@@ -126,6 +127,8 @@ template<typename _MatrixType> class Tridiagonalization
 
     static void _compute(MatrixType& matA, CoeffVectorType& hCoeffs);
 
+    static int _computeBlocked(MatrixType& matA, CoeffVectorType& hCoeffs);
+
     static void _decomposeInPlace3x3(MatrixType& mat, DiagonalType& diag, SubDiagonalType& subdiag, bool extractQ = true);
 
   protected:
@@ -183,7 +186,8 @@ Tridiagonalization<MatrixType>::matrixT(void) const
   *
   * The result is written in the lower triangular part of \a matA.
   *
-  * Implemented from Golub's "Matrix Computations", algorithm 8.3.1.
+  * Implemented from Golub's "Matrix Computations", algorithm 8.3.1. The first columns of large
+  * matrices are reduced per panel by _computeBlocked().
   *
   * \sa packedMatrix()
   */
@@ -193,7 +197,7 @@ void Tridiagonalization<MatrixType>::_compute(MatrixType& matA, CoeffVectorType&
   assert(matA.rows()==matA.cols());
   int n = matA.rows();
 //   std::cerr << matA << "\n\n";
-  for (int i = 0; i<n-2; ++i)
+  for (int i = _computeBlocked(matA, hCoeffs); i<n-2; ++i)
   {
     // let's consider the vector v = i-th column starting at position i+1
 
@@ -301,8 +305,8 @@ void Tridiagonalization<MatrixType>::_compute(MatrixType& matA, CoeffVectorType&
             matA.coeffRef(i1,j1) -= matA.coeff(i1,i)*ei_conj(hCoeffs.coeff(j1-1))
                                   + hCoeffs.coeff(i1-1)*ei_conj(matA.coeff(j1,i));
 
-          Packet tmp0 = ei_pset1(hCoeffs.coeff(j1-1));
-          Packet tmp1 = ei_pset1(matA.coeff(j1,i));
+          Packet tmp0 = ei_pset1(ei_conj(hCoeffs.coeff(j1-1)));
+          Packet tmp1 = ei_pset1(ei_conj(matA.coeff(j1,i)));
           Scalar* pc = &matA.coeffRef(0,j1);
           for (int i1=alignedStart ; i1<alignedEnd; i1+=PacketSize)
             ei_pstore(pc+i1,ei_psub(ei_pload(pc+i1),
@@ -339,6 +343,116 @@ void Tridiagonalization<MatrixType>::_compute(MatrixType& matA, CoeffVectorType&
   }
 }
 
+/** \internal
+  * Reduces the first columns of \a matA per panel of EIGEN_DECOMPOSITION_BLOCK_SIZE columns, and returns
+  * the index of the first column which remains to be reduced by _compute(). Small matrices are left untouched.
+  *
+  * Within a panel, the Householder vectors v_i are computed one at a time as in _compute(), but the trailing
+  * matrix is not updated: the columns of the panel and the products of the trailing matrix by v_i are
+  * corrected on the fly by the previous vectors of the panel and their updates w_i. The trailing matrix
+  * then receives the whole rank-2k update A -= V W^* + W V^* at once, by two cache friendly products.
+  * This is the algorithm of LAPACK's xSYTRD and xLATRD, updating the full trailing matrix since the
+  * matrix-vector products of the reduction use both of its halves.
+  */
+template<typename MatrixType>
+int Tridiagonalization<MatrixType>::_computeBlocked(MatrixType& matA, CoeffVectorType& hCoeffs)
+{
+  typedef Matrix<Scalar,Dynamic,Dynamic> DenseMatrixType;
+  typedef Matrix<Scalar,Dynamic,1> DenseVectorType;
+  const int n = matA.rows();
+  const int blockSize = EIGEN_DECOMPOSITION_BLOCK_SIZE;
+  if (n < 2*blockSize)
+    return 0;
+
+  DenseMatrixType matW(n, blockSize);
+  DenseVectorType tmp(blockSize);
+  DenseVectorType subdiag(blockSize);
+  int k = 0;
+  for (; n-k >= 2*blockSize; k += blockSize)
+  {
+    const int panelEnd = k + blockSize;
+    for (int i = k; i < panelEnd; ++i)
+    {
+      const int j = i - k;
+      const int remainingSize = n-i-1;
+
+      // apply the previous transformations of the panel to the column i
+      if (j > 0)
+      {
+        matA.col(i).end(n-i) -= matA.block(i, k, n-i, j) * matW.row(i).start(j).adjoint();
+        matA.col(i).end(n-i) -= matW.block(i, 0, n-i, j) * matA.row(i).segment(k, j).adjoint();
+      }
+
+      // householder transformation, see _compute()
+      Scalar h = 0;
+      RealScalar v1norm2 = matA.col(i).end(n-(i+2)).squaredNorm();
+      if (ei_isMuchSmallerThan(v1norm2,static_cast<Scalar>(1)))
+      {
+        subdiag.coeffRef(j) = matA.coeff(i+1,i);
+      }
+      else
+      {
+        Scalar v0 = matA.col(i).coeff(i+1);
+        RealScalar beta = ei_sqrt(ei_abs2(v0)+v1norm2);
+        if (ei_real(v0)>=0.)
+          beta = -beta;
+        matA.col(i).end(n-(i+2)) *= (Scalar(1)/(v0-beta));
+        subdiag.coeffRef(j) = beta;
+        h = (beta - v0) / beta;
+      }
+      hCoeffs.coeffRef(i) = h;
+
+      // the first coefficient of v is kept to 1 until the trailing matrix is updated
+      matA.col(i).coeffRef(i+1) = 1;
+
+      // w = h (A - V W^* - W V^*) v - (h/2 (w^* v)) v, where A is the trailing matrix at the start of the panel
+      Block<DenseMatrixType,Dynamic,1> w(matW, i+1, j, remainingSize, 1);
+      w = (matA.corner(BottomRight, remainingSize, remainingSize) * matA.col(i).end(remainingSize)).lazy();
+      if (j > 0)
+      {
+        tmp.start(j) = matW.block(i+1, 0, remainingSize, j).adjoint() * matA.col(i).end(remainingSize);
+        w -= matA.block(i+1, k, remainingSize, j) * tmp.start(j);
+        tmp.start(j) = matA.block(i+1, k, remainingSize, j).adjoint() * matA.col(i).end(remainingSize);
+        w -= matW.block(i+1, 0, remainingSize, j) * tmp.start(j);
+      }
+      w *= h;
+      w += (h * Scalar(-0.5) * matA.col(i).end(remainingSize).dot(w)) * matA.col(i).end(remainingSize);
+    }
+
+    // rank-2k update of the trailing matrix
+    const int trailingSize = n - panelEnd;
+    matA.corner(BottomRight, trailingSize, trailingSize).noalias()
+      -= matA.block(panelEnd, k, trailingSize, blockSize) * matW.block(panelEnd, 0, trailingSize, blockSize).adjoint();
+    matA.corner(BottomRight, trailingSize, trailingSize).noalias()
+      -= matW.block(panelEnd, 0, trailingSize, blockSize) * matA.block(panelEnd, k, trailingSize, blockSize).adjoint();
+
+    for (int i = k; i < panelEnd; ++i)
+      matA.coeffRef(i+1,i) = subdiag.coeff(i-k);
+  }
+  return k;
+}
+
+/** Replaces \a mat by Q \a mat, without forming the matrix Q. This is how eigenvectors of the tridiagonal
+  * matrix T are turned into eigenvectors of the original selfadjoint matrix, since the latter equals Q T Q^*.
+  *
+  * \a mat must have as many rows as the decomposed matrix. The Householder transformations of Q, stored
+  * below the subdiagonal of packedMatrix(), are applied by ei_apply_householder_sequence_on_the_left(),
+  * per block in their compact WY form for large matrices.
+  *
+  * \sa matrixQ(), packedMatrix()
+  */
+template<typename MatrixType>
+template<typename Derived>
+void Tridiagonalization<MatrixType>::applyQOnTheLeft(MatrixBase<Derived>& mat) const
+{
+  int n = m_matrix.rows();
+  ei_assert(mat.rows() == n);
+  if (n < 2)
+    return;
+  ei_apply_householder_sequence_on_the_left(mat.block(1, 0, n-1, mat.cols()),
+                                            m_matrix.block(1, 0, n-1, n-1), m_hCoeffs);
+}
+
 /** reconstructs and returns the matrix Q */
 template<typename MatrixType>
 typename Tridiagonalization<MatrixType>::MatrixType
@@ -346,6 +460,11 @@ Tridiagonalization<MatrixType>::matrixQ(void) const
 {
   int n = m_matrix.rows();
   MatrixType matQ = MatrixType::Identity(n,n);
+  if (n-1 >= 2*EIGEN_DECOMPOSITION_BLOCK_SIZE)
+  {
+    applyQOnTheLeft(matQ);
+    return matQ;
+  }
   for (int i = n-2; i>=0; i--)
   {
     Scalar tmp = m_matrix.coeff(i+1,i);
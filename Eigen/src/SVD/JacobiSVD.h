@@ -0,0 +1,439 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra. Eigen itself is part of the KDE project.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef EIGEN_JACOBISVD_H
+#define EIGEN_JACOBISVD_H
+
+/** \internal
+  * Performs one round of the one-sided Jacobi SVD: each pair of columns (p,q) of \a m_work listed
+  * in \a m_pairs is rotated such that the two columns become orthogonal, and the same rotation is
+  * applied to the columns of \a m_rotations if it is not null. The pairs of a round are disjoint,
+  * so that they can be processed concurrently.
+  *
+  * \a m_squaredNorms holds the squared norms of the columns, which are updated without reading the
+  * columns again.
+  */
+template<typename WorkMatrixType, typename RotationMatrixType>
+struct ei_jacobi_svd_round_kernel
+{
+  typedef typename WorkMatrixType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  ei_jacobi_svd_round_kernel(WorkMatrixType& work, RotationMatrixType* rotations, RealScalar* squaredNorms,
+                             const int* pairs, int* rotated, RealScalar threshold)
+    : m_work(work), m_rotations(rotations), m_squaredNorms(squaredNorms),
+      m_pairs(pairs), m_rotated(rotated), m_threshold(threshold) {}
+
+  /** \internal replaces the columns \a p and \a q of \a mat by c*col(p) - s*col(q) and s*col(p) + c*col(q).
+    * The columns are contiguous, so the rotation is vectorized, with aligned accesses to the column \a p. */
+  template<typename Derived>
+  static void rotate(Derived& mat, int p, int q, RealScalar c, RealScalar s)
+  {
+    typedef typename ei_packet_traits<Scalar>::type Packet;
+    const int PacketSize = ei_packet_traits<Scalar>::size;
+    const int size = mat.rows();
+    Scalar* x = &mat.coeffRef(0,p);
+    Scalar* y = &mat.coeffRef(0,q);
+    int alignedStart = 0;
+    int alignedEnd = 0;
+    if (PacketSize>1)
+    {
+      alignedStart = ei_alignmentOffset(x, size);
+      alignedEnd = alignedStart + ((size-alignedStart)/PacketSize)*PacketSize;
+      const bool yAligned = ei_alignmentOffset(y, size) == alignedStart;
+
+      for (int i = 0; i < alignedStart; ++i)
+      {
+        const Scalar xi = x[i];
+        x[i] = c*xi - s*y[i];
+        y[i] = s*xi + c*y[i];
+      }
+
+      const Packet pc = ei_pset1(Scalar(c)), ps = ei_pset1(Scalar(s));
+      for (int i = alignedStart; i < alignedEnd; i += PacketSize)
+      {
+        const Packet px = ei_pload(x+i);
+        const Packet py = yAligned ? ei_pload(y+i) : ei_ploadu(y+i);
+        ei_pstore(x+i, ei_psub(ei_pmul(pc, px), ei_pmul(ps, py)));
+        if (yAligned)
+          ei_pstore(y+i, ei_padd(ei_pmul(ps, px), ei_pmul(pc, py)));
+        else
+          ei_pstoreu(y+i, ei_padd(ei_pmul(ps, px), ei_pmul(pc, py)));
+      }
+    }
+    for (int i = alignedEnd; i < size; ++i)
+    {
+      const Scalar xi = x[i];
+      x[i] = c*xi - s*y[i];
+      y[i] = s*xi + c*y[i];
+    }
+  }
+
+  void operator()(int start, int end) const
+  {
+    for (int k = start; k < end; ++k)
+    {
+      const int p = m_pairs[2*k];
+      const int q = m_pairs[2*k+1];
+      m_rotated[k] = 0;
+
+      const RealScalar alpha = m_squaredNorms[p];
+      const RealScalar beta = m_squaredNorms[q];
+      Scalar gamma = m_work.col(q).dot(m_work.col(p)); // col(p)^* col(q)
+      const RealScalar absGamma = ei_abs(gamma);
+      if (absGamma <= m_threshold * ei_sqrt(alpha*beta))
+        continue;
+      m_rotated[k] = 1;
+
+      // a unit factor on the column q makes gamma real
+      if (NumTraits<Scalar>::IsComplex)
+      {
+        const Scalar z = ei_conj(gamma) / absGamma;
+        m_work.col(q) *= z;
+        if (m_rotations)
+          m_rotations->col(q) *= z;
+      }
+      const RealScalar g = NumTraits<Scalar>::IsComplex ? absGamma : ei_real(gamma);
+
+      // the rotation which cancels the new gamma, with the smallest angle
+      const RealScalar zeta = (beta - alpha) / (RealScalar(2) * g);
+      const RealScalar t = (zeta >= RealScalar(0) ? RealScalar(1) : RealScalar(-1))
+                         / (ei_abs(zeta) + ei_sqrt(RealScalar(1) + zeta*zeta));
+      const RealScalar c = RealScalar(1) / ei_sqrt(RealScalar(1) + t*t);
+      const RealScalar s = c * t;
+
+      rotate(m_work, p, q, c, s);
+      if (m_rotations)
+        rotate(*m_rotations, p, q, c, s);
+      m_squaredNorms[p] = alpha - t*g;
+      m_squaredNorms[q] = beta + t*g;
+    }
+  }
+
+  WorkMatrixType& m_work;
+  RotationMatrixType* m_rotations;
+  RealScalar* m_squaredNorms;
+  const int* m_pairs;
+  int* m_rotated;
+  const RealScalar m_threshold;
+
+  private:
+    ei_jacobi_svd_round_kernel& operator=(const ei_jacobi_svd_round_kernel&);
+};
+
+/** \ingroup SVD_Module
+  * \nonstableyet
+  *
+  * \class JacobiSVD
+  *
+  * \brief One-sided Jacobi SVD decomposition of a matrix
+  *
+  * \param MatrixType the type of the matrix of which we are computing the SVD decomposition
+  *
+  * This class computes the thin SVD decomposition A = U S V^* of a real or complex matrix A of size
+  * \c M x \c N, where S is the diagonal matrix of the \c P = min(M,N) singular values sorted in
+  * decreasing order, and U and V are \c M x \c P and \c N x \c P matrices with orthonormal columns.
+  * Unlike class SVD, there is no restriction on the shape of A.
+  *
+  * The columns of A (or of A^* if \c M \< \c N) are orthogonalized by plane rotations, until they all are
+  * numerically orthogonal: their norms are then the singular values. This is very accurate, even for the
+  * small singular values, and the rotations of the \c P/2 disjoint pairs of columns of each round are
+  * split across several threads if OpenMP is enabled.
+  *
+  * The left (if \c M \>= \c N) or right singular vectors corresponding to zero singular values are not
+  * determined by A: they are chosen to complete the others to an orthonormal basis.
+  *
+  * The computation of the singular vectors can be skipped by passing a combination of ComputeU and
+  * ComputeV other than the default one, in which case only the singular values are accurate.
+  *
+  * JacobiSVD is the option for accuracy and for complex or wide matrices, not for speed: on large real
+  * matrices it is about three times slower than class SVD, which remains the faster choice when its
+  * restrictions are met. Eigen does not provide a divide and conquer SVD.
+  *
+  * \sa class SVD
+  */
+template<typename MatrixType> class JacobiSVD
+{
+  public:
+
+    typedef typename MatrixType::Scalar Scalar;
+    typedef typename NumTraits<typename MatrixType::Scalar>::Real RealScalar;
+
+    enum {
+      RowsAtCompileTime = MatrixType::RowsAtCompileTime,
+      ColsAtCompileTime = MatrixType::ColsAtCompileTime,
+      DiagSizeAtCompileTime = EIGEN_ENUM_MIN(RowsAtCompileTime, ColsAtCompileTime),
+      MaxRowsAtCompileTime = MatrixType::MaxRowsAtCompileTime,
+      MaxColsAtCompileTime = MatrixType::MaxColsAtCompileTime,
+      MaxDiagSizeAtCompileTime = EIGEN_ENUM_MIN(MaxRowsAtCompileTime, MaxColsAtCompileTime),
+      MaxSizeAtCompileTime = EIGEN_ENUM_MAX(MaxRowsAtCompileTime, MaxColsAtCompileTime)
+    };
+
+    typedef Matrix<Scalar, RowsAtCompileTime, DiagSizeAtCompileTime, MatrixType::Options,
+                   MaxRowsAtCompileTime, MaxDiagSizeAtCompileTime> MatrixUType;
+    typedef Matrix<Scalar, ColsAtCompileTime, DiagSizeAtCompileTime, MatrixType::Options,
+                   MaxColsAtCompileTime, MaxDiagSizeAtCompileTime> MatrixVType;
+    typedef Matrix<RealScalar, DiagSizeAtCompileTime, 1> SingularValuesType;
+
+  private:
+
+    typedef Matrix<Scalar, Dynamic, Dynamic, ColMajor, MaxSizeAtCompileTime, MaxDiagSizeAtCompileTime> WorkMatrixType;
+    typedef Matrix<Scalar, Dynamic, Dynamic, ColMajor, MaxDiagSizeAtCompileTime, MaxDiagSizeAtCompileTime> RotationMatrixType;
+
+  public:
+
+    /** Default Constructor.
+      *
+      * The default constructor is useful in cases in which the user intends to
+      * perform decompositions via JacobiSVD::compute(const MatrixType&, int).
+      */
+    JacobiSVD() : m_computationOptions(0), m_isInitialized(false) {}
+
+    /** Constructor.
+      *
+      * \param matrix the matrix to decompose
+      * \param computationOptions a combination of ComputeU and ComputeV, telling which singular vectors
+      *        are computed. With 0, only the singular values are computed.
+      */
+    JacobiSVD(const MatrixType& matrix, int computationOptions = ComputeU|ComputeV)
+      : m_computationOptions(0), m_isInitialized(false)
+    {
+      compute(matrix, computationOptions);
+    }
+
+    void compute(const MatrixType& matrix, int computationOptions = ComputeU|ComputeV);
+
+    /** \returns the \c M x \c P matrix U, whose columns are the left singular vectors */
+    const MatrixUType& matrixU() const
+    {
+      ei_assert(m_isInitialized && "JacobiSVD is not initialized.");
+      ei_assert((m_computationOptions & ComputeU) && "The matrix U has not been computed");
+      return m_matU;
+    }
+
+    /** \returns the \c N x \c P matrix V, whose columns are the right singular vectors */
+    const MatrixVType& matrixV() const
+    {
+      ei_assert(m_isInitialized && "JacobiSVD is not initialized.");
+      ei_assert((m_computationOptions & ComputeV) && "The matrix V has not been computed");
+      return m_matV;
+    }
+
+    /** \returns the vector of the singular values, sorted in decreasing order */
+    const SingularValuesType& singularValues() const
+    {
+      ei_assert(m_isInitialized && "JacobiSVD is not initialized.");
+      return m_sigma;
+    }
+
+    template<typename OtherDerived, typename ResultType>
+    bool solve(const MatrixBase<OtherDerived> &b, ResultType* result) const;
+
+  protected:
+    MatrixUType m_matU;
+    MatrixVType m_matV;
+    SingularValuesType m_sigma;
+    int m_computationOptions;
+    bool m_isInitialized;
+};
+
+/** Computes / recomputes the SVD decomposition A = U S V^* of \a matrix
+  *
+  * \param computationOptions a combination of ComputeU and ComputeV (see JacobiSVD::JacobiSVD())
+  */
+template<typename MatrixType>
+void JacobiSVD<MatrixType>::compute(const MatrixType& matrix, int computationOptions)
+{
+  const int rows = matrix.rows();
+  const int cols = matrix.cols();
+  const int diagSize = std::min(rows, cols);
+  const bool transposed = rows < cols;
+  m_computationOptions = computationOptions;
+
+  // The columns of work are orthogonalized, and the rotations are accumulated in the columns of
+  // rotations: work = A rotations (or A^* rotations). Only what is needed for U and V is computed.
+  WorkMatrixType work;
+  if (transposed)
+    work = matrix.adjoint();
+  else
+    work = matrix;
+  const bool wantWork = (computationOptions & (transposed ? ComputeV : ComputeU)) != 0;
+  const bool wantRotations = (computationOptions & (transposed ? ComputeU : ComputeV)) != 0;
+  RotationMatrixType rotations;
+  if (wantRotations)
+    rotations = RotationMatrixType::Identity(diagSize, diagSize);
+
+  // round robin ordering: in each round, the columns are paired such that every pair is met once per sweep
+  const int players = diagSize + (diagSize%2);
+  const int maxPairs = players/2;
+  ei_scratch_buffer<int, Dynamic> orderBuffer(players);
+  ei_scratch_buffer<int, Dynamic> pairsBuffer(2*maxPairs);
+  ei_scratch_buffer<int, Dynamic> rotatedBuffer(maxPairs);
+  ei_scratch_buffer<RealScalar, Dynamic> squaredNormsBuffer(diagSize);
+  int* order = orderBuffer.data();
+  int* pairs = pairsBuffer.data();
+  int* rotated = rotatedBuffer.data();
+  RealScalar* squaredNorms = squaredNormsBuffer.data();
+  for (int i = 0; i < players; ++i)
+    order[i] = i;
+
+  typedef ei_jacobi_svd_round_kernel<WorkMatrixType, RotationMatrixType> Kernel;
+  const RealScalar threshold = RealScalar(2) * std::numeric_limits<RealScalar>::epsilon();
+  const Kernel kernel(work, wantRotations ? &rotations : 0, squaredNorms, pairs, rotated, threshold);
+  const int pairsPerThread = std::max(1, EIGEN_PARALLEL_ASSIGN_THRESHOLD / (4*(work.rows()+diagSize)));
+
+  const int maxSweeps = 50;
+  bool finished = diagSize < 2;
+  for (int sweep = 0; sweep < maxSweeps && !finished; ++sweep)
+  {
+    // the updated norms accumulate rounding errors, so they are recomputed at each sweep
+    for (int j = 0; j < diagSize; ++j)
+      squaredNorms[j] = work.col(j).squaredNorm();
+
+    finished = true;
+    for (int round = 0; round < players-1; ++round)
+    {
+      // the pairs involving the dummy column of an odd size are skipped
+      int nbPairs = 0;
+      for (int i = 0; i < maxPairs; ++i)
+      {
+        const int p = order[i], q = order[players-1-i];
+        if (p < diagSize && q < diagSize)
+        {
+          pairs[2*nbPairs] = std::min(p,q);
+          pairs[2*nbPairs+1] = std::max(p,q);
+          ++nbPairs;
+        }
+      }
+
+      ei_parallelize(kernel, nbPairs, pairsPerThread);
+      for (int k = 0; k < nbPairs; ++k)
+        if (rotated[k])
+          finished = false;
+
+      // the first column stays in place, the others move by one position
+      const int last = order[players-1];
+      for (int i = players-1; i > 1; --i)
+        order[i] = order[i-1];
+      order[1] = last;
+    }
+  }
+
+  // the singular values are the norms of the columns, sorted in decreasing order
+  m_sigma.resize(diagSize);
+  for (int j = 0; j < diagSize; ++j)
+    m_sigma.coeffRef(j) = work.col(j).norm();
+  for (int i = 0; i < diagSize; ++i)
+  {
+    int k;
+    m_sigma.end(diagSize-i).maxCoeff(&k);
+    k += i;
+    if (k != i)
+    {
+      std::swap(m_sigma.coeffRef(i), m_sigma.coeffRef(k));
+      if (wantWork)
+        work.col(i).swap(work.col(k));
+      if (wantRotations)
+        rotations.col(i).swap(rotations.col(k));
+    }
+  }
+
+  if (wantWork)
+  {
+    const int size = work.rows();
+    for (int j = 0; j < diagSize; ++j)
+    {
+      if (m_sigma.coeff(j) != RealScalar(0))
+      {
+        work.col(j) /= m_sigma.coeff(j);
+        continue;
+      }
+      // the zero singular values come last: their columns complete the previous ones to an orthonormal
+      // basis, starting from the canonical vector e_k whose projection on the previous columns is the smallest
+      int k = 0;
+      RealScalar minNorm = RealScalar(2);
+      for (int i = 0; i < size && j > 0; ++i)
+      {
+        const RealScalar n = work.row(i).start(j).squaredNorm();
+        if (n < minNorm)
+        {
+          minNorm = n;
+          k = i;
+        }
+      }
+      work.col(j).setZero();
+      work.coeffRef(k,j) = Scalar(1);
+      for (int pass = 0; pass < 2 && j > 0; ++pass)
+        work.col(j) -= work.block(0, 0, size, j) * (work.block(0, 0, size, j).adjoint() * work.col(j));
+      work.col(j).normalize();
+    }
+    if (transposed)
+      m_matV = work;
+    else
+      m_matU = work;
+  }
+  if (wantRotations)
+  {
+    if (transposed)
+      m_matU = rotations;
+    else
+      m_matV = rotations;
+  }
+  m_isInitialized = true;
+}
+
+/** Computes the solution of \f$ A x = b \f$ using the current SVD decomposition of A, in the least
+  * squares sense if the system is overdetermined. The parts of the solution corresponding to zero
+  * singular values are ignored.
+  *
+  * \returns false if A is rank deficient, in which case \a result is still the least squares
+  * solution of minimal norm.
+  *
+  * \note This requires both U and V to be computed.
+  *
+  * \sa class SVD
+  */
+template<typename MatrixType>
+template<typename OtherDerived, typename ResultType>
+bool JacobiSVD<MatrixType>::solve(const MatrixBase<OtherDerived> &b, ResultType* result) const
+{
+  ei_assert(b.rows() == matrixU().rows());
+
+  const RealScalar maxVal = m_sigma.size() ? m_sigma.coeff(0) : RealScalar(0);
+  Matrix<Scalar, Dynamic, Dynamic> aux = matrixU().adjoint() * b;
+  bool fullRank = true;
+  for (int i = 0; i < m_sigma.size(); ++i)
+  {
+    const RealScalar si = m_sigma.coeff(i);
+    if (ei_isMuchSmallerThan(si, maxVal))
+    {
+      aux.row(i).setZero();
+      fullRank = false;
+    }
+    else
+      aux.row(i) /= si;
+  }
+  *result = matrixV() * aux;
+  return fullRank;
+}
+
+#endif // EIGEN_JACOBISVD_H
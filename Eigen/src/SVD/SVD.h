@@ -37,8 +37,11 @@
   * This class performs a standard SVD decomposition of a real matrix A of size \c M x \c N
   * with \c M \>= \c N.
   *
+  * The computation of the singular vectors can be skipped by passing a combination of ComputeU and ComputeV
+  * other than the default one. This is the faster SVD for large real matrices. Class JacobiSVD is slower,
+  * but also handles complex matrices of any shape, and computes the small singular values more accurately.
   *
-  * \sa MatrixBase::SVD()
+  * \sa MatrixBase::SVD(), class JacobiSVD
   */
 template<typename MatrixType> class SVD
 {
@@ -61,22 +64,35 @@ template<typename MatrixType> class SVD
 
   public:
 
-    SVD(const MatrixType& matrix)
-      : m_matU(matrix.rows(), std::min(matrix.rows(), matrix.cols())),
-        m_matV(matrix.cols(),matrix.cols()),
-        m_sigma(std::min(matrix.rows(),matrix.cols()))
+    /** Constructor.
+      *
+      * \param matrix the matrix to decompose
+      * \param computationOptions a combination of ComputeU and ComputeV, telling which singular vectors
+      *        are computed. With 0, only the singular values are computed, and neither matrixU() nor
+      *        matrixV() nor the methods relying on them, solve() and the polar decompositions, can be used.
+      */
+    SVD(const MatrixType& matrix, int computationOptions = ComputeU|ComputeV)
+      : m_sigma(std::min(matrix.rows(),matrix.cols()))
     {
-      compute(matrix);
+      compute(matrix, computationOptions);
     }
 
     template<typename OtherDerived, typename ResultType>
     bool solve(const MatrixBase<OtherDerived> &b, ResultType* result) const;
 
-    const MatrixUType& matrixU() const { return m_matU; }
+    const MatrixUType& matrixU() const
+    {
+      ei_assert((m_computationOptions & ComputeU) && "The matrix U has not been computed");
+      return m_matU;
+    }
     const SingularValuesType& singularValues() const { return m_sigma; }
-    const MatrixVType& matrixV() const { return m_matV; }
+    const MatrixVType& matrixV() const
+    {
+      ei_assert((m_computationOptions & ComputeV) && "The matrix V has not been computed");
+      return m_matV;
+    }
 
-    void compute(const MatrixType& matrix);
+    void compute(const MatrixType& matrix, int computationOptions = ComputeU|ComputeV);
     SVD& sort();
 
     template<typename UnitaryType, typename PositiveType>
@@ -95,29 +111,45 @@ template<typename MatrixType> class SVD
     MatrixVType m_matV;
     /** \internal */
     SingularValuesType m_sigma;
+    /** \internal */
+    int m_computationOptions;
 };
 
 /** Computes / recomputes the SVD decomposition A = U S V^* of \a matrix
+  *
+  * \param computationOptions a combination of ComputeU and ComputeV (see SVD::SVD())
   *
   * \note this code has been adapted from JAMA (public domain)
   */
 template<typename MatrixType>
-void SVD<MatrixType>::compute(const MatrixType& matrix)
+void SVD<MatrixType>::compute(const MatrixType& matrix, int computationOptions)
 {
   const int m = matrix.rows();
   const int n = matrix.cols();
   const int nu = std::min(m,n);
 
-  m_matU.resize(m, nu);
-  m_matU.setZero();
-  m_sigma.resize(std::min(m,n));
-  m_matV.resize(n,n);
+  m_computationOptions = computationOptions;
+  const bool wantu = (computationOptions & ComputeU) != 0;
+  const bool wantv = (computationOptions & ComputeV) != 0;
 
-  RowVector e(n);
-  ColVector work(m);
-  MatrixType matA(matrix);
-  const bool wantu = true;
-  const bool wantv = true;
+  // U and V are not allocated when they are not requested
+  if (wantu)
+  {
+    m_matU.resize(m, nu);
+    m_matU.setZero();
+  }
+  m_sigma.resize(std::min(m,n));
+  if (wantv)
+    m_matV.resize(n,n);
+
+  // the work vectors live in the scratch memory, see class ScratchScope
+  ei_scratch_buffer<Scalar, RowVector::SizeAtCompileTime> eBuffer(n);
+  ei_scratch_buffer<Scalar, ColVector::SizeAtCompileTime> workBuffer(m);
+  ei_scratch_buffer<Scalar, MatrixType::SizeAtCompileTime> matABuffer(m*n);
+  Map<RowVector> e(eBuffer.data(), n);
+  Map<ColVector> work(workBuffer.data(), m);
+  Map<MatrixType> matA(matABuffer.data(), m, n);
+  matA = matrix;
   int i=0, j=0, k=0;
 
   // Reduce A to bidiagonal form, storing the diagonal elements
@@ -176,7 +208,7 @@ void SVD<MatrixType>::compute(const MatrixType& matrix)
       if ((k+1 < m) & (e[k] != 0.0))
       {
         // Apply the transformation.
-        work.end(m-k-1) = matA.corner(BottomRight,m-k-1,n-k-1) * e.end(n-k-1);
+        work.end(m-k-1) = (matA.corner(BottomRight,m-k-1,n-k-1) * e.end(n-k-1)).lazy();
         for (j = k+1; j < n; ++j)
           matA.col(j).end(m-k-1) += (-e[j]/e[k+1]) * work.end(m-k-1);
       }
@@ -478,9 +510,9 @@ void SVD<MatrixType>::compute(const MatrixType& matrix)
 template<typename MatrixType>
 SVD<MatrixType>& SVD<MatrixType>::sort()
 {
-  int mu = m_matU.rows();
-  int mv = m_matV.rows();
-  int n  = m_matU.cols();
+  int mu = (m_computationOptions & ComputeU) ? m_matU.rows() : 0;
+  int mv = (m_computationOptions & ComputeV) ? m_matV.rows() : 0;
+  int n  = m_sigma.size();
 
   for (int i=0; i<n; ++i)
   {
@@ -512,19 +544,30 @@ SVD<MatrixType>& SVD<MatrixType>::sort()
   return *this;
 }
 
-/** \returns the solution of \f$ A x = b \f$ using the current SVD decomposition of A.
+/** Computes the solution of \f$ A x = b \f$ using the current SVD decomposition of A.
   * The parts of the solution corresponding to zero singular values are ignored.
   *
+  * \returns false if A is rank deficient, in which case \a result is still the least squares
+  * solution of minimal norm.
+  *
+  * \note This requires both U and V to be computed.
+  *
   * \sa MatrixBase::svd(), LU::solve(), LLT::solve()
   */
 template<typename MatrixType>
 template<typename OtherDerived, typename ResultType>
 bool SVD<MatrixType>::solve(const MatrixBase<OtherDerived> &b, ResultType* result) const
 {
+  ei_assert((m_computationOptions & (ComputeU|ComputeV)) == (ComputeU|ComputeV)
+            && "This method requires both U and V to be computed");
   const int rows = m_matU.rows();
   ei_assert(b.rows() == rows);
 
   Scalar maxVal = m_sigma.cwise().abs().maxCoeff();
+  bool fullRank = true;
+  for (int i = 0; i < m_sigma.size(); ++i)
+    if (ei_isMuchSmallerThan(ei_abs(m_sigma.coeff(i)),maxVal))
+      fullRank = false;
   for (int j=0; j<b.cols(); ++j)
   {
     Matrix<Scalar,MatrixUType::RowsAtCompileTime,1> aux = m_matU.transpose() * b.col(j);
@@ -540,7 +583,7 @@ bool SVD<MatrixType>::solve(const MatrixBase<OtherDerived> &b, ResultType* resul
 
     result->col(j) = m_matV * aux;
   }
-  return true;
+  return fullRank;
 }
 
 /** Computes the polar decomposition of the matrix, as a product unitary x positive.
@@ -556,6 +599,8 @@ template<typename UnitaryType, typename PositiveType>
 void SVD<MatrixType>::computeUnitaryPositive(UnitaryType *unitary,
                                              PositiveType *positive) const
 {
+  ei_assert((m_computationOptions & (ComputeU|ComputeV)) == (ComputeU|ComputeV)
+            && "This method requires both U and V to be computed");
   ei_assert(m_matU.cols() == m_matV.cols() && "Polar decomposition is only for square matrices");
   if(unitary) *unitary = m_matU * m_matV.adjoint();
   if(positive) *positive = m_matV * m_sigma.asDiagonal() * m_matV.adjoint();
@@ -574,6 +619,8 @@ template<typename UnitaryType, typename PositiveType>
 void SVD<MatrixType>::computePositiveUnitary(UnitaryType *positive,
                                              PositiveType *unitary) const
 {
+  ei_assert((m_computationOptions & (ComputeU|ComputeV)) == (ComputeU|ComputeV)
+            && "This method requires both U and V to be computed");
   ei_assert(m_matU.rows() == m_matV.rows() && "Polar decomposition is only for square matrices");
   if(unitary) *unitary = m_matU * m_matV.adjoint();
   if(positive) *positive = m_matU * m_sigma.asDiagonal() * m_matU.adjoint();
@@ -592,6 +639,8 @@ template<typename MatrixType>
 template<typename RotationType, typename ScalingType>
 void SVD<MatrixType>::computeRotationScaling(RotationType *rotation, ScalingType *scaling) const
 {
+  ei_assert((m_computationOptions & (ComputeU|ComputeV)) == (ComputeU|ComputeV)
+            && "This method requires both U and V to be computed");
   ei_assert(m_matU.rows() == m_matV.rows() && "Polar decomposition is only for square matrices");
   Scalar x = (m_matU * m_matV.adjoint()).determinant(); // so x has absolute value 1
   Matrix<Scalar, MatrixType::RowsAtCompileTime, 1> sv(m_sigma);
@@ -618,6 +667,8 @@ template<typename MatrixType>
 template<typename ScalingType, typename RotationType>
 void SVD<MatrixType>::computeScalingRotation(ScalingType *scaling, RotationType *rotation) const
 {
+  ei_assert((m_computationOptions & (ComputeU|ComputeV)) == (ComputeU|ComputeV)
+            && "This method requires both U and V to be computed");
   ei_assert(m_matU.rows() == m_matV.rows() && "Polar decomposition is only for square matrices");
   Scalar x = (m_matU * m_matV.adjoint()).determinant(); // so x has absolute value 1
   Matrix<Scalar, MatrixType::RowsAtCompileTime, 1> sv(m_sigma);
@@ -57,7 +57,7 @@ template<typename _Scalar> class AmbiVector
 
     class Iterator;
 
-    ~AmbiVector() { delete[] m_buffer; }
+    ~AmbiVector() { ei_storage_delete(m_buffer, m_allocatedSize); }
 
     void resize(int size)
     {
@@ -74,17 +74,19 @@ template<typename _Scalar> class AmbiVector
     {
       // if the size of the matrix is not too large, let's allocate a bit more than needed such
       // that we can handle dense vector even in sparse mode.
-      delete[] m_buffer;
+      ei_storage_delete(m_buffer, m_allocatedSize);
       if (size<1000)
       {
         int allocSize = (size * sizeof(ListEl))/sizeof(Scalar);
         m_allocatedElements = (allocSize*sizeof(Scalar))/sizeof(ListEl);
-        m_buffer = new Scalar[allocSize];
+        m_buffer = ei_storage_new<Scalar>(allocSize);
+        m_allocatedSize = allocSize;
       }
       else
       {
         m_allocatedElements = (size*sizeof(Scalar))/sizeof(ListEl);
-        m_buffer = new Scalar[size];
+        m_buffer = ei_storage_new<Scalar>(size);
+        m_allocatedSize = size;
       }
       m_size = size;
       m_start = 0;
@@ -97,8 +99,11 @@ template<typename _Scalar> class AmbiVector
       m_allocatedElements = std::min(int(m_allocatedElements*1.5),m_size);
       int allocSize = m_allocatedElements * sizeof(ListEl);
       allocSize = allocSize/sizeof(Scalar) + (allocSize%sizeof(Scalar)>0?1:0);
-      Scalar* newBuffer = new Scalar[allocSize];
+      Scalar* newBuffer = ei_storage_new<Scalar>(allocSize);
       memcpy(newBuffer,  m_buffer,  copyElements * sizeof(ListEl));
+      ei_storage_delete(m_buffer, m_allocatedSize);
+      m_buffer = newBuffer;
+      m_allocatedSize = allocSize;
     }
 
   protected:
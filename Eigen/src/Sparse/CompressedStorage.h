@@ -57,6 +57,20 @@ class CompressedStorage
       return *this;
     }
 
+#ifdef EIGEN_HAVE_RVALUE_REFERENCES
+    CompressedStorage(CompressedStorage&& other) EIGEN_NOEXCEPT
+      : m_values(0), m_indices(0), m_size(0), m_allocatedSize(0)
+    {
+      swap(other);
+    }
+
+    CompressedStorage& operator=(CompressedStorage&& other) EIGEN_NOEXCEPT
+    {
+      swap(other);
+      return *this;
+    }
+#endif
+
     void swap(CompressedStorage& other)
     {
       std::swap(m_values, other.m_values);
@@ -67,8 +81,8 @@ class CompressedStorage
 
     ~CompressedStorage()
     {
-      delete[] m_values;
-      delete[] m_indices;
+      ei_storage_delete(m_values, m_allocatedSize);
+      ei_storage_delete(m_indices, m_allocatedSize);
     }
 
     void reserve(size_t size)
@@ -205,15 +219,15 @@ class CompressedStorage
 
     inline void reallocate(size_t size)
     {
-      Scalar* newValues  = new Scalar[size];
-      int* newIndices = new int[size];
+      Scalar* newValues  = ei_storage_new<Scalar>(size);
+      int* newIndices = ei_storage_new<int>(size);
       size_t copySize = std::min(size, m_size);
       // copy
       memcpy(newValues,  m_values,  copySize * sizeof(Scalar));
       memcpy(newIndices, m_indices, copySize * sizeof(int));
       // delete old stuff
-      delete[] m_values;
-      delete[] m_indices;
+      ei_storage_delete(m_values, m_allocatedSize);
+      ei_storage_delete(m_indices, m_allocatedSize);
       m_values = newValues;
       m_indices = newIndices;
       m_allocatedSize = size;
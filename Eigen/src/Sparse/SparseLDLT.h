@@ -315,9 +315,9 @@ bool SparseLDLT<MatrixType,Backend>::_numeric(const MatrixType& a)
     }
   }
 
-  ei_aligned_stack_delete(Scalar, y, size);
-  ei_aligned_stack_delete(int, pattern, size);
   ei_aligned_stack_delete(int, tags, size);
+  ei_aligned_stack_delete(int, pattern, size);
+  ei_aligned_stack_delete(Scalar, y, size);
 
   return ok;  /* success, diagonal of D is all nonzero */
 }
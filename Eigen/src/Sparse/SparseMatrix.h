@@ -300,6 +300,23 @@ class SparseMatrix
       *this = other.derived();
     }
 
+#ifdef EIGEN_HAVE_RVALUE_REFERENCES
+    /** Move constructor: the data of \a other are taken without any copy nor allocation, and \a other
+      * is left in a state where it can only be resized, assigned or destroyed */
+    inline SparseMatrix(SparseMatrix&& other) EIGEN_NOEXCEPT
+      : Base(), m_outerSize(-1), m_innerSize(0), m_outerIndex(0)
+    {
+      swap(other);
+    }
+
+    /** Move assignment: the data of \a other are taken without any copy */
+    inline SparseMatrix& operator=(SparseMatrix&& other) EIGEN_NOEXCEPT
+    {
+      swap(other);
+      return *this;
+    }
+#endif
+
     inline void swap(SparseMatrix& other)
     {
       //EIGEN_DBG_SPARSE(std::cout << "SparseMatrix:: swap\n");
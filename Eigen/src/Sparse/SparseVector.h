@@ -205,6 +205,22 @@ class SparseVector
       *this = other.derived();
     }
 
+#ifdef EIGEN_HAVE_RVALUE_REFERENCES
+    /** Move constructor: the data of \a other are taken without any copy */
+    inline SparseVector(SparseVector&& other) EIGEN_NOEXCEPT
+      : m_size(0)
+    {
+      swap(other);
+    }
+
+    /** Move assignment: the data of \a other are taken without any copy */
+    inline SparseVector& operator=(SparseVector&& other) EIGEN_NOEXCEPT
+    {
+      swap(other);
+      return *this;
+    }
+#endif
+
     inline void swap(SparseVector& other)
     {
       std::swap(m_size, other.m_size);
@@ -100,6 +100,42 @@ template<typename MatrixType> void cholesky(const MatrixType& m)
     VERIFY_IS_APPROX(symm * matX, matB);
   }
 
+  // rank one and rank k updates and downdates of an existing decomposition
+  {
+    VectorType vecW = VectorType::Random(rows);
+    Matrix<Scalar, MatrixType::RowsAtCompileTime, Dynamic> matW
+      = Matrix<Scalar, MatrixType::RowsAtCompileTime, Dynamic>::Random(rows, ei_random<int>(1,3));
+    SquareMatrixType symmW = symm + vecW * vecW.adjoint();
+    SquareMatrixType symmWk = symm + RealScalar(0.5) * matW * matW.adjoint();
+
+    LLT<SquareMatrixType> chol(symm);
+    VERIFY(chol.rankUpdate(vecW));
+    VERIFY_IS_APPROX(symmW, chol.matrixL() * chol.matrixL().adjoint());
+    VERIFY(chol.rankUpdate(vecW, -1));
+    VERIFY_IS_APPROX(symm, chol.matrixL() * chol.matrixL().adjoint());
+    VERIFY(chol.rankUpdate(matW, RealScalar(0.5)));
+    VERIFY_IS_APPROX(symmWk, chol.matrixL() * chol.matrixL().adjoint());
+    chol.solve(vecB, &vecX);
+    VERIFY_IS_APPROX(symmWk * vecX, vecB);
+
+    LDLT<SquareMatrixType> ldlt(symm);
+    VERIFY(ldlt.rankUpdate(vecW));
+    VERIFY_IS_APPROX(symmW, ldlt.matrixL() * ldlt.vectorD().asDiagonal() * ldlt.matrixL().adjoint());
+    VERIFY(ldlt.rankUpdate(vecW, -1));
+    VERIFY_IS_APPROX(symm, ldlt.matrixL() * ldlt.vectorD().asDiagonal() * ldlt.matrixL().adjoint());
+    VERIFY(ldlt.rankUpdate(matW, RealScalar(0.5)));
+    VERIFY_IS_APPROX(symmWk, ldlt.matrixL() * ldlt.vectorD().asDiagonal() * ldlt.matrixL().adjoint());
+    ldlt.solve(vecB, &vecX);
+    VERIFY_IS_APPROX(symmWk * vecX, vecB);
+
+    // a downdate which makes the matrix indefinite is detected
+    vecW *= Scalar(100);
+    VERIFY(!chol.rankUpdate(vecW, -1));
+    VERIFY(!chol.isPositiveDefinite());
+    VERIFY(!ldlt.rankUpdate(vecW, -1));
+    VERIFY(!ldlt.isPositiveDefinite());
+  }
+
   // test isPositiveDefinite on non definite matrix
   if (rows>4)
   {
@@ -111,6 +147,39 @@ template<typename MatrixType> void cholesky(const MatrixType& m)
   }
 }
 
+template<typename MatrixType> void cholesky_blocked(const MatrixType& m)
+{
+  // several panels, the last one being incomplete: with OpenMP, the updates of the trailing matrix
+  // are handed out per panel to the threads (see ei_cholesky_update_lower)
+  typedef typename MatrixType::Scalar Scalar;
+  const int size = m.rows();
+  const int blockSize = EIGEN_DECOMPOSITION_BLOCK_SIZE;
+
+  MatrixType a = MatrixType::Random(size,size);
+  MatrixType symm = a * a.adjoint();
+  symm.diagonal().cwise() += Scalar(size);
+
+  LLT<MatrixType> chol(symm);
+  VERIFY(chol.isPositiveDefinite());
+  VERIFY_IS_APPROX(symm, chol.matrixL() * chol.matrixL().adjoint());
+
+  LDLT<MatrixType> ldlt(symm);
+  VERIFY(ldlt.isPositiveDefinite());
+  VERIFY_IS_APPROX(symm, ldlt.matrixL() * ldlt.vectorD().asDiagonal() * ldlt.matrixL().adjoint());
+
+  // only the lower triangular part of the trailing matrix is updated, whatever the thread of each panel
+  MatrixType lhs = MatrixType::Random(size,blockSize), rhs = MatrixType::Random(size,blockSize);
+  MatrixType updated = symm;
+  ei_cholesky_update_lower(Block<MatrixType>(updated, 0, 0, size, size), lhs, rhs, blockSize);
+  MatrixType ref = symm - lhs * rhs.adjoint();
+  for (int j = 0; j < size; ++j)
+  {
+    VERIFY_IS_APPROX(updated.col(j).end(size-j), ref.col(j).end(size-j));
+    for (int i = 0; i < j - j%blockSize; ++i)
+      VERIFY(updated.coeff(i,j) == symm.coeff(i,j));
+  }
+}
+
 void test_cholesky()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -121,5 +190,12 @@ void test_cholesky()
     CALL_SUBTEST( cholesky(MatrixXcd(7,7)) );
     CALL_SUBTEST( cholesky(MatrixXf(17,17)) );
     CALL_SUBTEST( cholesky(MatrixXd(33,33)) );
+    CALL_SUBTEST( cholesky(Matrix<double,Dynamic,Dynamic,RowMajor>(9,9)) );
+    // large enough to be factorized per panel
+    int n = ei_random<int>(2*EIGEN_DECOMPOSITION_BLOCK_SIZE, 4*EIGEN_DECOMPOSITION_BLOCK_SIZE);
+    CALL_SUBTEST( cholesky(MatrixXd(n,n)) );
+    CALL_SUBTEST( cholesky(MatrixXcf(2*EIGEN_DECOMPOSITION_BLOCK_SIZE+5,2*EIGEN_DECOMPOSITION_BLOCK_SIZE+5)) );
+    CALL_SUBTEST( cholesky_blocked(MatrixXd(6*EIGEN_DECOMPOSITION_BLOCK_SIZE+13,6*EIGEN_DECOMPOSITION_BLOCK_SIZE+13)) );
+    CALL_SUBTEST( cholesky_blocked(MatrixXcd(4*EIGEN_DECOMPOSITION_BLOCK_SIZE+3,4*EIGEN_DECOMPOSITION_BLOCK_SIZE+3)) );
   }
 }
@@ -75,6 +75,10 @@ template<typename MatrixType> void cwiseops(const MatrixType& m)
   VERIFY_IS_APPROX(m4.setOnes(), mones);
   m4.fill(s1);
   VERIFY_IS_APPROX(m4, m3);
+  m4.streamingAssign(m1 + m3);
+  VERIFY_IS_APPROX(m4, m1 + m3);
+  m4.streamingAssign(MatrixType::Zero(rows, cols));
+  VERIFY_IS_APPROX(m4, mzero);
   
 
   m2 = m2.template binaryExpr<AddIfNull<Scalar> >(mones);
@@ -148,6 +152,18 @@ template<typename MatrixType> void cwiseops(const MatrixType& m)
   VERIFY( !(m1.cwise()>m1.unaryExpr(bind2nd(plus<Scalar>(), Scalar(1)))).any() );
 }
 
+void cwiseops_random()
+{
+  // the coefficients of a large Random() are drawn in order, even when the assignments are parallelized
+  const unsigned int seed = ei_random<int>(0, 1000);
+  std::srand(seed);
+  MatrixXd m = MatrixXd::Random(500, 503);
+  std::srand(seed);
+  for(int j = 0; j < m.cols(); ++j)
+    for(int i = 0; i < m.rows(); ++i)
+      VERIFY(m(i,j) == ei_random<double>());
+}
+
 void test_cwiseop()
 {
   for(int i = 0; i < g_repeat ; i++) {
@@ -158,4 +174,7 @@ void test_cwiseop()
     CALL_SUBTEST( cwiseops(MatrixXi(8, 12)) );
     CALL_SUBTEST( cwiseops(MatrixXd(20, 20)) );
   }
+  // test a large matrix only once
+  CALL_SUBTEST( cwiseops(MatrixXd(500, 503)) );
+  CALL_SUBTEST( cwiseops_random() );
 }
@@ -22,7 +22,12 @@
 // License and a copy of the GNU General Public License along with
 // Eigen. If not, see <http://www.gnu.org/licenses/>.
 
+// record the allocations to check the accounting (see check_allocation_hooks())
+#define EIGEN_ALLOCATION_HOOKS
+
 #include "main.h"
+#include <Eigen/LU>
+#include <Eigen/QR>
 
 void check_handmade_aligned_malloc()
 {
@@ -72,6 +77,194 @@ void check_aligned_stack_alloc()
   }
 }
 
+int g_hooked_allocations = 0;
+size_t g_hooked_bytes = 0;
+const char* g_hooked_tag = 0;
+
+void on_allocate(const void*, size_t size, const char* tag)
+{
+  ++g_hooked_allocations;
+  g_hooked_bytes += size;
+  g_hooked_tag = tag;
+}
+
+void on_free(const void*, size_t size, const char*)
+{
+  --g_hooked_allocations;
+  g_hooked_bytes -= size;
+}
+
+void check_allocation_hooks()
+{
+  AllocationTracker::resetStats();
+  AllocationTracker::setHooks(on_allocate, on_free);
+  {
+    AllocationTag tag("check_allocation_hooks");
+    MatrixXf m(10,20);
+    VERIFY(size_t(m.data())%16==0);
+    VERIFY(AllocationTracker::stats().allocations == 1);
+    VERIFY(AllocationTracker::stats().currentBytes == 200*sizeof(float));
+    VERIFY(g_hooked_allocations == 1 && g_hooked_bytes == 200*sizeof(float));
+    VERIFY(std::string(g_hooked_tag) == "check_allocation_hooks");
+    m.resize(5,5);
+    VERIFY(AllocationTracker::stats().allocatedBytes == 225*sizeof(float));
+  }
+  VERIFY(AllocationTracker::stats().allocations == 2);
+  VERIFY(AllocationTracker::stats().deallocations == 2);
+  VERIFY(AllocationTracker::stats().currentBytes == 0);
+  VERIFY(AllocationTracker::stats().peakBytes == 200*sizeof(float));
+  VERIFY(g_hooked_allocations == 0 && g_hooked_bytes == 0);
+
+  Vector4f* v = new Vector4f;
+  VERIFY(size_t(v)%16==0);
+  VERIFY(AllocationTracker::stats().currentBytes == sizeof(Vector4f));
+  VERIFY(g_hooked_tag == 0);
+  delete v;
+  VERIFY(AllocationTracker::stats().currentBytes == 0);
+
+#ifdef EIGEN_THREAD_LOCAL
+  {
+    // the scratch memory is a heap block like the others
+    AllocationTag tag("scratch");
+    ScratchScope scope(1<<16);
+    VERIFY(AllocationTracker::stats().currentBytes == (1<<16));
+    VERIFY(g_hooked_allocations == 1 && g_hooked_bytes == (1<<16));
+    VERIFY(std::string(g_hooked_tag) == "scratch");
+  }
+  VERIFY(AllocationTracker::stats().currentBytes == 0);
+  VERIFY(g_hooked_allocations == 0 && g_hooked_bytes == 0);
+#endif
+
+  AllocationTracker::setHooks(0, 0);
+  AllocationTracker::resetStats();
+}
+
+#ifdef EIGEN_THREAD_LOCAL
+void check_decomposition_reuse()
+{
+  // once they have been computed for a given size, LU and QR keep their storage, and take their work
+  // vectors from the scratch memory
+  MatrixXf a = MatrixXf::Random(50,50), b = MatrixXf::Random(50,50);
+  LU<MatrixXf> lu;
+  QR<MatrixXf> qr;
+  ScratchScope scope(1<<16);
+  lu.compute(a);
+  qr.compute(a);
+  AllocationTracker::resetStats();
+  lu.compute(b);
+  qr.compute(b);
+  VERIFY(AllocationTracker::stats().allocations == 0);
+  VERIFY_IS_APPROX(lu.determinant(), LU<MatrixXf>(b).determinant());
+  VERIFY_IS_APPROX(b, qr.matrixQ() * qr.matrixR());
+  AllocationTracker::resetStats();
+}
+#endif
+
+int g_storage_blocks = 0;
+size_t g_storage_bytes = 0;
+
+void* storage_allocate(size_t size)
+{
+  ++g_storage_blocks;
+  g_storage_bytes += size;
+  return ei_handmade_aligned_malloc(size);
+}
+
+void storage_deallocate(void* ptr, size_t size)
+{
+  --g_storage_blocks;
+  g_storage_bytes -= size;
+  ei_handmade_aligned_free(ptr);
+}
+
+void* storage_allocate_or_null(size_t size)
+{
+  return size ? storage_allocate(size) : 0;
+}
+
+void check_storage_allocator()
+{
+  StorageAllocator::set(storage_allocate, storage_deallocate);
+  VERIFY(StorageAllocator::isSet());
+  {
+    MatrixXf m1 = MatrixXf::Random(17,13);
+    Matrix<double,Dynamic,3> m2(5,3);
+    VectorXd v(33);
+    VERIFY(g_storage_blocks == 3);
+    VERIFY(g_storage_bytes == 17*13*sizeof(float) + 15*sizeof(double) + 33*sizeof(double));
+    VERIFY(size_t(m1.data())%16==0 && size_t(m2.data())%16==0 && size_t(v.data())%16==0);
+    MatrixXf m3 = m1 * m1.transpose();
+    VERIFY_IS_APPROX(m3, m1.lazy() * m1.transpose());
+    m1.resize(4,4);
+    VERIFY(g_storage_bytes == 4*4*sizeof(float) + 15*sizeof(double) + 33*sizeof(double) + 17*17*sizeof(float));
+  }
+  VERIFY(g_storage_blocks == 0 && g_storage_bytes == 0);
+
+  // an allocator returning a null pointer for empty blocks
+  StorageAllocator::set(storage_allocate_or_null, storage_deallocate);
+  {
+    float* empty = ei_storage_new<float>(0);
+    VERIFY(empty == 0 && g_storage_blocks == 0);
+    ei_storage_delete(empty, 0);
+    MatrixXf m(3,4);
+    VERIFY(g_storage_blocks == 1);
+  }
+  VERIFY(g_storage_blocks == 0 && g_storage_bytes == 0);
+  StorageAllocator::set(0, 0);
+  VERIFY(!StorageAllocator::isSet());
+}
+
+void check_large_allocation_policy()
+{
+  const int all = LargeAllocationPolicy::HugePages | LargeAllocationPolicy::NumaInterleave
+                | LargeAllocationPolicy::ParallelFirstTouch;
+  LargeAllocationPolicy::set(all, 1024*1024);
+  VERIFY(LargeAllocationPolicy::policy() == all && LargeAllocationPolicy::threshold() == 1024*1024);
+  {
+    MatrixXf m1 = MatrixXf::Random(1000,300), m2 = MatrixXf::Random(300,1000);
+    // the policy may be refused by the system, but nothing else than what was requested is applied
+    VERIFY((LargeAllocationPolicy::lastApplied() & ~all) == 0);
+    #if EIGEN_HAS_LARGE_ALLOCATION_POLICY && (defined EIGEN_PARALLELIZE)
+    // the first touch by several threads cannot be refused
+    if(ei_max_threads()>1)
+      VERIFY(LargeAllocationPolicy::lastApplied() & LargeAllocationPolicy::ParallelFirstTouch);
+    #endif
+    VERIFY(size_t(m1.data())%16==0 && size_t(m2.data())%16==0);
+    MatrixXf m3 = m1 * m2;
+    VERIFY_IS_APPROX(m3.col(7), m1 * m2.col(7));
+  }
+  // the large blocks remain aligned on a huge page despite the header of the allocation hooks,
+  // which still find their size
+  LargeAllocationPolicy::set(LargeAllocationPolicy::HugePages, 1024*1024);
+  AllocationTracker::resetStats();
+  {
+    MatrixXf m(1000,300);
+    #if EIGEN_HAS_LARGE_ALLOCATION_POLICY
+    VERIFY(size_t(m.data()) % ei_huge_page_size() == 0);
+    #endif
+    VERIFY(AllocationTracker::stats().allocations == 1);
+    VERIFY(AllocationTracker::stats().currentBytes == 1000*300*sizeof(float));
+  }
+  VERIFY(AllocationTracker::stats().deallocations == 1 && AllocationTracker::stats().currentBytes == 0);
+  // nothing is applied to a block smaller than a page
+  LargeAllocationPolicy::set(all, 16);
+  {
+    MatrixXf m(10,10);
+    VERIFY(LargeAllocationPolicy::lastApplied() == LargeAllocationPolicy::None);
+  }
+  #ifdef EIGEN_EXCEPTIONS
+  // nothing is applied to a block which could not be allocated
+  {
+    MatrixXf m(1000,300);
+    bool failed = false;
+    try { ei_aligned_malloc(std::numeric_limits<size_t>::max()/4); }
+    catch(std::bad_alloc&) { failed = true; }
+    VERIFY(failed && LargeAllocationPolicy::lastApplied() == LargeAllocationPolicy::None);
+  }
+  #endif
+  LargeAllocationPolicy::set(LargeAllocationPolicy::None);
+  VERIFY(LargeAllocationPolicy::threshold() == EIGEN_LARGE_ALLOCATION_THRESHOLD);
+}
 
 // test compilation with both a struct and a class...
 struct MyStruct
@@ -103,6 +296,12 @@ void test_dynalloc()
   CALL_SUBTEST(check_aligned_malloc());
   CALL_SUBTEST(check_aligned_new());
   CALL_SUBTEST(check_aligned_stack_alloc());
+  CALL_SUBTEST(check_allocation_hooks());
+#ifdef EIGEN_THREAD_LOCAL
+  CALL_SUBTEST(check_decomposition_reuse());
+#endif
+  CALL_SUBTEST(check_storage_allocator());
+  CALL_SUBTEST(check_large_allocation_policy());
 
   for (int i=0; i<g_repeat*100; ++i)
   {
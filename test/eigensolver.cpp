@@ -113,6 +113,101 @@ template<typename MatrixType> void selfadjointeigensolver(const MatrixType& m)
   VERIFY_IS_APPROX(sqrtSymmA, symmA*eiSymm.operatorInverseSqrt());
 }
 
+template<typename MatrixType> void selfadjointeigensolver_range(const MatrixType& m)
+{
+  /* this test covers the computation of a few eigenpairs by bisection and inverse iteration
+  */
+  int size = m.rows();
+  int count = ei_random<int>(1,size);
+
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+
+  RealScalar largerEps = 10*test_precision<RealScalar>();
+
+  MatrixType a = MatrixType::Random(size,size);
+  MatrixType symmA = a.adjoint() * a;
+  SelfAdjointEigenSolver<MatrixType> eiSymm(symmA, false);
+
+  SelfAdjointEigenSolver<MatrixType> eiRange(size);
+  eiRange.computeSmallest(symmA, count);
+  VERIFY_IS_MUCH_SMALLER_THAN(eiRange.eigenvalues() - eiSymm.eigenvalues().start(count), symmA.norm());
+  VERIFY((symmA * eiRange.eigenvectors()).isApprox(
+          eiRange.eigenvectors() * eiRange.eigenvalues().asDiagonal().eval(), largerEps));
+  VERIFY((eiRange.eigenvectors().adjoint() * eiRange.eigenvectors()).isIdentity(largerEps));
+
+  eiRange.computeLargest(symmA, count, false);
+  VERIFY_IS_MUCH_SMALLER_THAN(eiRange.eigenvalues() - eiSymm.eigenvalues().end(count), symmA.norm());
+
+  // a multiple eigenvalue, whose eigenvectors must be orthogonalized
+  MatrixType q = SelfAdjointEigenSolver<MatrixType>(symmA).eigenvectors();
+  typename SelfAdjointEigenSolver<MatrixType>::RealVectorType eivals = eiSymm.eigenvalues();
+  eivals.end(count).setConstant(eivals.maxCoeff());
+  symmA = q * eivals.template cast<Scalar>().asDiagonal() * q.adjoint();
+  eiRange.computeLargest(symmA, count);
+  VERIFY((symmA * eiRange.eigenvectors()).isApprox(
+          eiRange.eigenvectors() * eiRange.eigenvalues().asDiagonal().eval(), largerEps));
+  VERIFY((eiRange.eigenvectors().adjoint() * eiRange.eigenvectors()).isIdentity(largerEps));
+}
+
+template<typename MatrixType> void selfadjointeigensolver_direct(const MatrixType& m)
+{
+  /* this test covers the closed form solver of the fixed size 2x2 and 3x3 real matrices,
+     including the multiple eigenvalues, and the batched solver
+  */
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar, MatrixType::RowsAtCompileTime, 1> VectorType;
+  typedef Matrix<Scalar, Dynamic, Dynamic> DynamicMatrixType;
+  int size = m.rows();
+
+  MatrixType a = MatrixType::Random();
+  MatrixType symmA = a.transpose() * a;
+  SelfAdjointEigenSolver<MatrixType> eiSymm(symmA);
+  DynamicMatrixType symmAX = symmA;
+  SelfAdjointEigenSolver<DynamicMatrixType> eiSymmX(symmAX);
+  VERIFY_IS_APPROX(eiSymm.eigenvalues(), VectorType(eiSymmX.eigenvalues()));
+  VERIFY_IS_APPROX(symmA * eiSymm.eigenvectors(), eiSymm.eigenvectors() * eiSymm.eigenvalues().asDiagonal());
+  VERIFY((eiSymm.eigenvectors().transpose() * eiSymm.eigenvectors()).isIdentity(test_precision<Scalar>()));
+
+  // an orthogonal matrix built from the eigenvectors of a random matrix
+  MatrixType q = eiSymm.eigenvectors();
+  VectorType d = VectorType::Random();
+  for (int k = 0; k < 4; ++k)
+  {
+    if (k==1) d.setConstant(ei_random<Scalar>());
+    if (k==2) d.start(size-1).setConstant(ei_random<Scalar>());
+    if (k==3) d.end(size-1).setConstant(ei_random<Scalar>());
+    symmA = q * d.asDiagonal() * q.transpose();
+    eiSymm.compute(symmA);
+    VERIFY_IS_APPROX(symmA * eiSymm.eigenvectors(), eiSymm.eigenvectors() * eiSymm.eigenvalues().asDiagonal());
+    VERIFY((eiSymm.eigenvectors().transpose() * eiSymm.eigenvectors()).isIdentity(test_precision<Scalar>()));
+  }
+
+  symmA.setZero();
+  eiSymm.compute(symmA);
+  VERIFY_IS_MUCH_SMALLER_THAN(eiSymm.eigenvalues().norm(), Scalar(1));
+  VERIFY(eiSymm.eigenvectors().isIdentity());
+
+  // the batched version
+  const int count = ei_random<int>(1,100);
+  MatrixType matrices[100], eivecs[100];
+  VectorType eivals[100], eivals2[100];
+  for (int i = 0; i < count; ++i)
+  {
+    a = MatrixType::Random();
+    matrices[i] = a.transpose() * a;
+  }
+  SelfAdjointEigenSolver<MatrixType>::computeBatch(matrices, count, eivals, eivecs);
+  SelfAdjointEigenSolver<MatrixType>::computeBatch(matrices, count, eivals2);
+  for (int i = 0; i < count; ++i)
+  {
+    eiSymm.compute(matrices[i]);
+    VERIFY_IS_APPROX(eivals[i], eiSymm.eigenvalues());
+    VERIFY_IS_APPROX(eivals2[i], eiSymm.eigenvalues());
+    VERIFY_IS_APPROX(eivecs[i], eiSymm.eigenvectors());
+  }
+}
+
 template<typename MatrixType> void eigensolver(const MatrixType& m)
 {
   /* this test covers the following files:
@@ -143,6 +238,74 @@ template<typename MatrixType> void eigensolver(const MatrixType& m)
   VERIFY_IS_APPROX(a.template cast<Complex>() * ei1.eigenvectors(),
                    ei1.eigenvectors() * ei1.eigenvalues().asDiagonal().eval());
 
+  // the eigenvalues do not depend on the eigenvectors being computed
+  EigenSolver<MatrixType> ei2(a, false);
+  VERIFY_IS_APPROX(ei2.eigenvalues(), ei1.eigenvalues());
+}
+
+template<typename MatrixType> void eigensolver_verify(const MatrixType& a)
+{
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename std::complex<Scalar> Complex;
+  EigenSolver<MatrixType> ei(a);
+  VERIFY_IS_APPROX(a * ei.pseudoEigenvectors(), ei.pseudoEigenvectors() * ei.pseudoEigenvalueMatrix());
+  VERIFY_IS_APPROX(a.template cast<Complex>() * ei.eigenvectors(),
+                   ei.eigenvectors() * ei.eigenvalues().asDiagonal().eval());
+}
+
+template<typename MatrixType> void eigensolver_special(const MatrixType& m)
+{
+  /* this test covers the matrices which are already split, or on which the QR iteration stalls
+  */
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<std::complex<Scalar>, MatrixType::RowsAtCompileTime, 1> EigenvalueType;
+  int size = m.rows();
+  int half = size/2;
+
+  // a reducible, block triangular matrix, whose Hessenberg form has a zero subdiagonal coefficient
+  MatrixType a = MatrixType::Random(size,size);
+  a.block(half, 0, size-half, half).setZero();
+  eigensolver_verify(a);
+
+  // a Hessenberg matrix which is already split, with several consecutive 1x1 blocks
+  MatrixType h = MatrixType::Random(size,size).template part<UpperTriangular>();
+  for (int i = 1; i < size; ++i)
+    h.coeffRef(i,i-1) = ei_random<Scalar>();
+  h.coeffRef(1,0) = h.coeffRef(half,half-1) = h.coeffRef(half+1,half) = h.coeffRef(size-1,size-2) = 0;
+  eigensolver_verify(h);
+
+  // the cyclic shift, i.e. the companion matrix of x^n-1, and the companion matrix of x^n+1: the Francis
+  // shifts are zero and the iteration makes no progress until it uses exceptional shifts
+  for (int sign = -1; sign <= 1; sign += 2)
+  {
+    MatrixType c = MatrixType::Zero(size,size);
+    for (int i = 1; i < size; ++i)
+      c.coeffRef(i,i-1) = Scalar(1);
+    c.coeffRef(0,size-1) = Scalar(sign);
+    EigenSolver<MatrixType> ei(c);
+    eigensolver_verify(c);
+    for (int i = 0; i < size; ++i)
+      VERIFY_IS_APPROX(ei_abs(ei.eigenvalues().coeff(i)), Scalar(1));
+  }
+
+  // the multishift iteration falls back to the double shift one after maxIterations sweeps
+  for (int maxIterations = 0; maxIterations <= 2; ++maxIterations)
+  {
+    MatrixType t = HessenbergDecomposition<MatrixType>(a).matrixH();
+    MatrixType z = HessenbergDecomposition<MatrixType>(a).matrixQ();
+    EigenvalueType eivalues(size);
+    ei_real_schur(t, z, eivalues, true, true, maxIterations);
+    VERIFY_IS_APPROX(z * t * z.transpose(), a);
+    VERIFY((z.transpose() * z).isIdentity(test_precision<Scalar>()));
+    for (int i = 0; i < size; ++i)
+    {
+      if (i < size-2)
+        VERIFY_IS_MUCH_SMALLER_THAN(t.col(i).end(size-i-2).norm(), a.norm());
+      // the real eigenvalues are the 1x1 diagonal blocks
+      if ((i == 0 || t.coeff(i,i-1) == Scalar(0)) && (i == size-1 || t.coeff(i+1,i) == Scalar(0)))
+        VERIFY_IS_MUCH_SMALLER_THAN(ei_abs(ei_real(eivalues.coeff(i)) - t.coeff(i,i)), a.norm());
+    }
+  }
 }
 
 void test_eigensolver()
@@ -150,13 +313,38 @@ void test_eigensolver()
   for(int i = 0; i < g_repeat; i++) {
     // very important to test a 3x3 matrix since we provide a special path for it
     CALL_SUBTEST( selfadjointeigensolver(Matrix3f()) );
+    CALL_SUBTEST( selfadjointeigensolver(Matrix2d()) );
+    CALL_SUBTEST( selfadjointeigensolver(Matrix3d()) );
     CALL_SUBTEST( selfadjointeigensolver(Matrix4d()) );
     CALL_SUBTEST( selfadjointeigensolver(MatrixXf(7,7)) );
     CALL_SUBTEST( selfadjointeigensolver(MatrixXcd(5,5)) );
     CALL_SUBTEST( selfadjointeigensolver(MatrixXd(19,19)) );
+    // large matrices are tridiagonalized per block, and their eigenvectors computed by divide and conquer
+    int size = 2*EIGEN_DECOMPOSITION_BLOCK_SIZE + ei_random<int>(0,100);
+    CALL_SUBTEST( selfadjointeigensolver(MatrixXd(size,size)) );
+    size = 2*EIGEN_DECOMPOSITION_BLOCK_SIZE + ei_random<int>(0,50);
+    CALL_SUBTEST( selfadjointeigensolver(MatrixXcd(size,size)) );
+
+    CALL_SUBTEST( selfadjointeigensolver_range(MatrixXf(ei_random<int>(2,40),1)) );
+    CALL_SUBTEST( selfadjointeigensolver_range(MatrixXcd(ei_random<int>(2,2*EIGEN_DECOMPOSITION_BLOCK_SIZE+40),1)) );
+
+    CALL_SUBTEST( selfadjointeigensolver_direct(Matrix2f()) );
+    CALL_SUBTEST( selfadjointeigensolver_direct(Matrix3f()) );
+    CALL_SUBTEST( selfadjointeigensolver_direct(Matrix2d()) );
+    CALL_SUBTEST( selfadjointeigensolver_direct(Matrix3d()) );
 
     CALL_SUBTEST( eigensolver(Matrix4f()) );
     CALL_SUBTEST( eigensolver(MatrixXd(17,17)) );
+    // large matrices are reduced to the Schur form by the multishift QR algorithm
+    size = 2*EIGEN_DECOMPOSITION_BLOCK_SIZE + ei_random<int>(0,100);
+    CALL_SUBTEST( eigensolver(MatrixXd(size,size)) );
+    size = ei_random<int>(75,2*EIGEN_DECOMPOSITION_BLOCK_SIZE);
+    CALL_SUBTEST( eigensolver(MatrixXf(size,size)) );
+
+    CALL_SUBTEST( eigensolver_special(MatrixXd(17,17)) );
+    CALL_SUBTEST( eigensolver_special(MatrixXd(4,4)) );
+    size = 2*EIGEN_DECOMPOSITION_BLOCK_SIZE + ei_random<int>(0,50);
+    CALL_SUBTEST( eigensolver_special(MatrixXd(size,size)) );
   }
 }
 
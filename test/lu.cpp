@@ -120,6 +120,43 @@ template<typename MatrixType> void lu_invertible()
   VERIFY(lu.solve(m3, &m2));
 }
 
+template<typename MatrixType> void lu_partial_piv()
+{
+  /* this test covers the following files:
+     PartialPivLU.h
+  */
+  typedef typename NumTraits<typename MatrixType::Scalar>::Real RealScalar;
+  // the second size is large enough to be factorized per panel
+  int size = ei_random<int>(10,200);
+  if(ei_random<int>(0,1)) size = ei_random<int>(2*EIGEN_DECOMPOSITION_BLOCK_SIZE, 4*EIGEN_DECOMPOSITION_BLOCK_SIZE);
+
+  MatrixType m1(size, size), m2(size, size), m3(size, size);
+  m1 = MatrixType::Random(size,size);
+
+  if (ei_is_same_type<RealScalar,float>::ret)
+  {
+    // let's build a matrix more stable to inverse
+    MatrixType a = MatrixType::Random(size,size*2);
+    m1 += a * a.adjoint();
+  }
+
+  PartialPivLU<MatrixType> plu(m1);
+  MatrixType l = MatrixType::Identity(size,size), u(size,size), pm1(size,size);
+  l.template part<StrictlyLowerTriangular>() = plu.matrixLU();
+  u = plu.matrixLU().template part<UpperTriangular>();
+  for(int i = 0; i < size; ++i) pm1.row(i) = m1.row(plu.permutationP().coeff(i));
+  VERIFY_IS_APPROX(pm1, l * u);
+
+  m3 = MatrixType::Random(size,size);
+  plu.solve(m3, &m2);
+  VERIFY_IS_APPROX(m3, m1*m2);
+  VERIFY_IS_APPROX(m2, plu.inverse()*m3);
+  // the determinant of the whole matrix could overflow
+  MatrixType m4 = m1.corner(TopLeft, 8, 8);
+  VERIFY_IS_APPROX(m4.partialPivLu().determinant(), m4.lu().determinant());
+  VERIFY_IS_APPROX(m1.partialPivLu().inverse(), m1.lu().inverse());
+}
+
 void test_lu()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -131,5 +168,9 @@ void test_lu()
     CALL_SUBTEST( lu_invertible<MatrixXd>() );
     CALL_SUBTEST( lu_invertible<MatrixXcf>() );
     CALL_SUBTEST( lu_invertible<MatrixXcd>() );
+    CALL_SUBTEST( lu_partial_piv<MatrixXf>() );
+    CALL_SUBTEST( lu_partial_piv<MatrixXd>() );
+    CALL_SUBTEST( lu_partial_piv<MatrixXcf>() );
+    CALL_SUBTEST( lu_partial_piv<MatrixXcd>() );
   }
 }
@@ -0,0 +1,118 @@
+// This file is part of Eigen, a lightweight C++ template library
+// for linear algebra. Eigen itself is part of the KDE project.
+//
+// Eigen is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3 of the License, or (at your option) any later version.
+//
+// Alternatively, you can redistribute it and/or
+// modify it under the terms of the GNU General Public License as
+// published by the Free Software Foundation; either version 2 of
+// the License, or (at your option) any later version.
+//
+// Eigen is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License or the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License and a copy of the GNU General Public License along with
+// Eigen. If not, see <http://www.gnu.org/licenses/>.
+
+// record the allocations to check that the moves do not allocate
+#define EIGEN_ALLOCATION_HOOKS
+
+#include "main.h"
+#include <Eigen/Sparse>
+#include <vector>
+
+// this test is compiled as C++11 (see CMakeLists.txt), the rest of the test suite being C++98
+#ifdef EIGEN_HAVE_RVALUE_REFERENCES
+#include <type_traits>
+
+MatrixXf make_matrix(int rows, int cols, const float** data)
+{
+  MatrixXf m = MatrixXf::Constant(rows, cols, 1.f);
+  *data = m.data();
+  return m;
+}
+
+void check_move()
+{
+  // a moved matrix keeps its buffer and does not allocate
+  const float* data;
+  MatrixXf m1 = make_matrix(30, 20, &data);
+  VERIFY(m1.data() == data);
+  AllocationTracker::resetStats();
+  MatrixXf m2(std::move(m1));
+  VERIFY(m2.data() == data && m2.rows() == 30 && m2.cols() == 20);
+  VERIFY(m1.data() == 0 && m1.rows() == 0);
+  m1 = std::move(m2);
+  VERIFY(m1.data() == data);
+  VERIFY(AllocationTracker::stats().allocations == 0);
+  VERIFY_IS_APPROX(m1, MatrixXf::Constant(30, 20, 1.f));
+
+  // fixed-size matrices are copied
+  Matrix4f f1 = Matrix4f::Random(), f2(std::move(f1));
+  VERIFY_IS_APPROX(f1, f2);
+}
+
+void check_nothrow_move()
+{
+  VERIFY(std::is_nothrow_move_constructible<MatrixXd>::value);
+  VERIFY(std::is_nothrow_move_assignable<MatrixXd>::value);
+  VERIFY(std::is_nothrow_move_constructible<VectorXf>::value);
+  VERIFY(std::is_nothrow_move_constructible<RowVectorXcd>::value);
+  VERIFY(std::is_nothrow_move_constructible<SparseMatrix<double> >::value);
+  VERIFY(std::is_nothrow_move_assignable<SparseMatrix<double> >::value);
+  VERIFY(std::is_nothrow_move_constructible<SparseVector<double> >::value);
+
+  // so the elements of a std::vector are moved, not copied, when it reallocates
+  std::vector<MatrixXd> matrices;
+  matrices.reserve(1);
+  matrices.push_back(MatrixXd::Ones(50, 50));
+  const double* data = matrices[0].data();
+  MatrixXd m = MatrixXd::Ones(50, 50);
+  AllocationTracker::resetStats();
+  matrices.push_back(std::move(m));
+  VERIFY(matrices.capacity() > 1);
+  VERIFY(matrices[0].data() == data);
+  VERIFY(AllocationTracker::stats().allocations == 0);
+  VERIFY_IS_APPROX(matrices[0], matrices[1]);
+}
+
+void check_sparse_move()
+{
+  SparseMatrix<double> s1(10, 10);
+  s1.startFill();
+  s1.fill(1, 2) = 3;
+  s1.fill(4, 5) = 6;
+  s1.endFill();
+  SparseMatrix<double> s2(std::move(s1));
+  VERIFY(s2.rows() == 10 && s2.nonZeros() == 2);
+  VERIFY(s2.coeff(4, 5) == 6);
+
+  // the moved from matrix can be reused
+  s1.resize(3, 3);
+  VERIFY(s1.rows() == 3 && s1.nonZeros() == 0);
+  s1 = std::move(s2);
+  VERIFY(s1.coeff(1, 2) == 3);
+
+  SparseVector<double> v1(10);
+  v1.startFill(1);
+  v1.fill(3) = 1;
+  v1.endFill();
+  SparseVector<double> v2(std::move(v1));
+  VERIFY(v2.size() == 10 && v2.nonZeros() == 1);
+}
+#endif
+
+void test_move()
+{
+#ifdef EIGEN_HAVE_RVALUE_REFERENCES
+  CALL_SUBTEST(check_move());
+  CALL_SUBTEST(check_nothrow_move());
+  CALL_SUBTEST(check_sparse_move());
+#endif
+}
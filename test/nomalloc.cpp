@@ -31,6 +31,8 @@
 #define EIGEN_STACK_ALLOCATION_LIMIT 0
 // any heap allocation will raise an assert
 #define EIGEN_NO_MALLOC
+// count the heap allocations too
+#define EIGEN_ALLOCATION_HOOKS
 
 #include "main.h"
 
@@ -68,6 +70,45 @@ template<typename MatrixType> void nomalloc(const MatrixType& m)
   VERIFY_IS_APPROX((m1*m1.transpose())*m2,  m1*(m1.transpose()*m2));
 }
 
+void nomalloc_scratch()
+{
+  // the temporaries of the large matrix product, which are above the stack allocation limit of this test,
+  // are taken from the reserved scratch memory
+  const int size = 256;
+  static EIGEN_ALIGN_128 float data1[size*size], data2[size*size], data3[size*size];
+  Map<MatrixXf> m1(data1, size, size), m2(data2, size, size), m3(data3, size, size);
+  m1.setRandom();
+  m2.setRandom();
+  ScratchScope scope(4<<20);
+  VERIFY(ScratchScope::capacity() >= (4<<20));
+  const size_t allocations = AllocationTracker::stats().allocations;
+  m3 = (m1 * m2).lazy();
+  VERIFY(AllocationTracker::stats().allocations == allocations);
+  VERIFY(ScratchScope::capacity() >= (4<<20));
+  VERIFY_IS_APPROX(m3(1,2), m1.row(1).dot(m2.col(2)));
+}
+
+void nomalloc_scratch_order()
+{
+  // the scratch memory is released in reverse order: a wrong-order free is reported, and does not release
+  // the allocations above it
+  ScratchScope scope(1<<16);
+  char* p1 = static_cast<char*>(ei_scratch_alloc(1000));
+  char* p2 = static_cast<char*>(ei_scratch_alloc(1000));
+  VERIFY_RAISES_ASSERT(ei_scratch_free(p1));
+  char* p3 = static_cast<char*>(ei_scratch_alloc(1000));
+  VERIFY(p3 >= p2+1000);
+  ei_scratch_free(p3);
+  // this releases p1 too
+  ei_scratch_free(p2);
+  VERIFY(static_cast<char*>(ei_scratch_alloc(1000)) == p1);
+  ei_scratch_free(p1);
+  // a second free is reported, and is a no-op
+  VERIFY_RAISES_ASSERT(ei_scratch_free(p1));
+  VERIFY(static_cast<char*>(ei_scratch_alloc(1000)) == p1);
+  ei_scratch_free(p1);
+}
+
 void test_nomalloc()
 {
   // check that our operator new is indeed called:
@@ -75,4 +116,8 @@ void test_nomalloc()
   CALL_SUBTEST( nomalloc(Matrix<float, 1, 1>()) );
   CALL_SUBTEST( nomalloc(Matrix4d()) );
   CALL_SUBTEST( nomalloc(Matrix<float,32,32>()) );
+#ifdef EIGEN_THREAD_LOCAL
+  CALL_SUBTEST( nomalloc_scratch() );
+  CALL_SUBTEST( nomalloc_scratch_order() );
+#endif
 }
@@ -136,6 +136,80 @@ template<typename Scalar> void packetmath()
   VERIFY(areApprox(ref, data2, PacketSize) && "ei_preduxp");
 }
 
+template<typename Scalar> void packetmath_complex()
+{
+  typedef typename ei_packet_traits<Scalar>::type Packet;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  const int PacketSize = ei_packet_traits<Scalar>::size;
+
+  const int size = PacketSize*4;
+  EIGEN_ALIGN_128 Scalar data1[ei_packet_traits<Scalar>::size*4];
+  EIGEN_ALIGN_128 Scalar data2[ei_packet_traits<Scalar>::size*4];
+  EIGEN_ALIGN_128 Packet packets[PacketSize*2];
+  EIGEN_ALIGN_128 Scalar ref[ei_packet_traits<Scalar>::size*4];
+  // both parts are non zero and of any sign, so that no term of the complex operations vanishes
+  for (int i=0; i<size; ++i)
+  {
+    data1[i] = Scalar(ei_random<RealScalar>(RealScalar(0.5),RealScalar(2)) * (i%2 ? RealScalar(1) : RealScalar(-1)),
+                      ei_random<RealScalar>(RealScalar(0.5),RealScalar(2)) * (i%3 ? RealScalar(1) : RealScalar(-1)));
+    data2[i] = Scalar(0);
+  }
+
+  for (int offset=0; offset<PacketSize; ++offset)
+  {
+    ei_pstoreu(data2+offset, ei_ploadu(data1+offset+1));
+    VERIFY(areApprox(data1+offset+1, data2+offset, PacketSize) && "ei_ploadu/ei_pstoreu");
+  }
+
+  CHECK_CWISE(REF_ADD,  ei_padd);
+  CHECK_CWISE(REF_SUB,  ei_psub);
+  CHECK_CWISE(REF_MUL,  ei_pmul);
+  CHECK_CWISE(REF_DIV,  ei_pdiv);
+
+  // complex numbers are not ordered, so min and max must never be vectorized
+  VERIFY(!ei_functor_traits<ei_scalar_min_op<Scalar> >::PacketAccess);
+  VERIFY(!ei_functor_traits<ei_scalar_max_op<Scalar> >::PacketAccess);
+
+  for (int i=0; i<PacketSize; ++i)
+    ref[i] = ei_conj(data1[i]);
+  ei_pstore(data2, ei_pconj(ei_pload(data1)));
+  VERIFY(areApprox(ref, data2, PacketSize) && "ei_pconj");
+
+  // conj(a)*b, as in the dot products
+  for (int i=0; i<PacketSize; ++i)
+    ref[i] = ei_conj(data1[i]) * data1[i+PacketSize];
+  ei_pstore(data2, ei_pmul(ei_pconj(ei_pload(data1)), ei_pload(data1+PacketSize)));
+  VERIFY(areApprox(ref, data2, PacketSize) && "ei_pmul(ei_pconj)");
+
+  ref[0] = 0;
+  for (int i=0; i<PacketSize; ++i)
+    ref[0] += data1[i+1];
+  VERIFY(ei_isApprox(ref[0], ei_predux(ei_ploadu(data1+1))) && "ei_predux");
+
+  for (int j=0; j<PacketSize; ++j)
+  {
+    ref[j] = 0;
+    for (int i=0; i<PacketSize; ++i)
+      ref[j] += data1[i+j*PacketSize];
+    packets[j] = ei_pload(data1+j*PacketSize);
+  }
+  ei_pstore(data2, ei_preduxp(packets));
+  VERIFY(areApprox(ref, data2, PacketSize) && "ei_preduxp");
+
+  for (int offset=0; offset<PacketSize; ++offset)
+  {
+    packets[0] = ei_pload(data1);
+    packets[1] = ei_pload(data1+PacketSize);
+         if (offset==0) ei_palign<0>(packets[0], packets[1]);
+    else if (offset==1) ei_palign<1>(packets[0], packets[1]);
+    ei_pstore(data2, packets[0]);
+
+    for (int i=0; i<PacketSize; ++i)
+      ref[i] = data1[i+offset];
+    VERIFY(areApprox(ref, data2, PacketSize) && "ei_palign");
+  }
+}
+
 void test_packetmath()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -143,5 +217,6 @@ void test_packetmath()
     CALL_SUBTEST( packetmath<double>() );
     CALL_SUBTEST( packetmath<int>() );
     CALL_SUBTEST( packetmath<std::complex<float> >() );
+    CALL_SUBTEST( packetmath_complex<std::complex<float> >() );
   }
 }
@@ -133,6 +133,56 @@ template<typename MatrixType> void product(const MatrixType& m)
   for (int i=0; i<rows; ++i)
     res.col(i) = m1 * m2.transpose().col(i);
   VERIFY_IS_APPROX(res, m1 * m2.transpose());
+  // same with the strided rows/columns directly used by the matrix/vector kernels
+  for (int i=0; i<rows; ++i)
+    res.row(i) = (m1.row(i) * m2.transpose()).lazy();
+  VERIFY_IS_APPROX(res, m1 * m2.transpose());
+  for (int i=0; i<rows; ++i)
+    res.col(i) = (tm1 * m2.row(i).transpose()).lazy();
+  VERIFY_IS_APPROX(res, m1 * m2.transpose());
+
+  // test noalias() assignments, the scalar factors of the operands are folded into the kernels
+  res.noalias() = m1 * m2.transpose();
+  VERIFY_IS_APPROX(res, m1 * m2.transpose());
+  res = square;
+  res.noalias() += (s1*m1) * m2.transpose();
+  VERIFY_IS_APPROX(res, square + s1 * (m1 * m2.transpose()));
+  res = square;
+  res.noalias() -= m1 * (m2.transpose()*s1);
+  VERIFY_IS_APPROX(res, square - s1 * (m1 * m2.transpose()));
+  res.noalias() = -m1 * m2.transpose();
+  VERIFY_IS_APPROX(res, -(m1 * m2.transpose()));
+  vcres = vc2;
+  vcres.noalias() -= (s1*m1.transpose()) * v1;
+  VERIFY_IS_APPROX(vcres, vc2 - s1 * (m1.transpose() * v1));
+  vcres = vc2;
+  vcres.transpose().noalias() += v1.transpose() * (m1*s1);
+  VERIFY_IS_APPROX(vcres, vc2 + s1 * (m1.transpose() * v1));
+
+  // same with transposed and conjugated operands, and a destination of the other storage order
+  res.noalias() = (s1*m1).conjugate() * m2.adjoint();
+  VERIFY_IS_APPROX(res, (s1*m1).conjugate().eval() * m2.adjoint().eval());
+  res2 = square2;
+  res2.noalias() -= (m1*s1).adjoint() * tm1;
+  VERIFY_IS_APPROX(res2, square2 - (s1*m1).adjoint().eval() * m1);
+  res.noalias() = tm1 * (-m2).transpose();
+  VERIFY_IS_APPROX(res, -(m1 * m2.transpose()));
+  tm1.noalias() = square * m1;
+  VERIFY_IS_APPROX(tm1, square * m1);
+  tm1 = m1;
+
+  // test the products by a pre-packed lhs
+  PackedMatrix<RowSquareMatrixType> packed(square);
+  VERIFY_IS_APPROX(packed * m1, square * m1);
+  m3 = m2;
+  packed.addProductTo(m1, m3, s1);
+  VERIFY_IS_APPROX(m3, m2 + s1 * (square * m1));
+  packed.compute((s1*square).adjoint());
+  VERIFY_IS_APPROX(packed * v1, (s1*square).adjoint().eval() * v1);
+  tm1 = m2;
+  packed.addProductTo(-m1.conjugate(), tm1);
+  VERIFY_IS_APPROX(tm1, m2 - (s1*square).adjoint().eval() * m1.conjugate());
+  tm1 = m1;
 
   res2 = square2;
   res2 += (m1.transpose() * m2).lazy();
@@ -42,4 +42,13 @@ void test_product_large()
     m = (v+v).asDiagonal() * m;
     VERIFY_IS_APPROX(m, MatrixXf::Constant(N,3,2));
   }
+
+  {
+    // the lhs of a product with a long inner dimension is packed per slice of the depth, so that the packed
+    // block, which is allocated on the stack, does not overflow the stack of a thread
+    // (see EIGEN_PRODUCT_MAX_PACKED_LHS_SIZE)
+    MatrixXd a = MatrixXd::Ones(64, 20000), b = MatrixXd::Ones(20000, 4);
+    MatrixXd res = a * b;
+    VERIFY_IS_APPROX(res, MatrixXd::Constant(64, 4, 20000));
+  }
 }
@@ -65,6 +65,9 @@ void test_qr()
     CALL_SUBTEST( qr(MatrixXf(12,8)) );
     CALL_SUBTEST( qr(MatrixXcd(5,5)) );
     CALL_SUBTEST( qr(MatrixXcd(7,3)) );
+    // large enough to be factorized per panel
+    CALL_SUBTEST( qr(MatrixXd(2*EIGEN_DECOMPOSITION_BLOCK_SIZE+30,2*EIGEN_DECOMPOSITION_BLOCK_SIZE+7)) );
+    CALL_SUBTEST( qr(MatrixXcf(3*EIGEN_DECOMPOSITION_BLOCK_SIZE,2*EIGEN_DECOMPOSITION_BLOCK_SIZE)) );
   }
 
   // small isFullRank test
@@ -77,10 +77,105 @@ void check_fitHyperplane(int numPoints,
   VERIFY(ei_abs(error) < ei_abs(tolerance));
 }
 
+template<typename VectorType,
+         typename HyperplaneType>
+void check_linearRegression(int numPoints,
+                            VectorType **points,
+                            const HyperplaneType& original,
+                            typename VectorType::Scalar tolerance)
+{
+  typedef typename VectorType::Scalar Scalar;
+  int size = points[0]->size();
+  int funcOfOthers = ei_random<int>(0, size-1);
+  VectorType result(size);
+  VERIFY(linearRegression(numPoints, points, &result, funcOfOthers));
+
+  // convert x_f = r.x_others + c to the coefficients of the original hyperplane
+  typename HyperplaneType::Coefficients coeffs(size+1);
+  for(int j = 0, k = 0; j < size; ++j)
+    coeffs.coeffRef(j) = j==funcOfOthers ? Scalar(-1) : result.coeff(k++);
+  coeffs.coeffRef(size) = result.coeff(size-1);
+  coeffs *= original.coeffs().coeff(size)/coeffs.coeff(size);
+  typename VectorType::Scalar error = (coeffs - original.coeffs()).norm() / original.coeffs().norm();
+  VERIFY(ei_abs(error) < ei_abs(tolerance));
+}
+
+template<typename VectorType>
+void check_accumulator(int numPoints, VectorType **points)
+{
+  typedef typename VectorType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  int size = points[0]->size();
+
+  LeastSquaresAccumulator<VectorType> all(size);
+  all.add(numPoints, points);
+
+  // the same points, streamed one by one, or by columns of a matrix, into two accumulators which are merged
+  // at least one point goes to the batch, since a matrix cannot have zero columns in Eigen 2
+  int split = ei_random<int>(0, numPoints-1);
+  LeastSquaresAccumulator<VectorType> first(size), second(size);
+  for(int i = 0; i < split; ++i)
+    first.add(*(points[i]));
+  Matrix<Scalar,VectorType::SizeAtCompileTime,Dynamic> batch(size, numPoints-split);
+  for(int i = split; i < numPoints; ++i)
+    batch.col(i-split) = *(points[i]);
+  second.add(batch);
+  first.merge(second);
+
+  VERIFY(first.count() == numPoints);
+  VERIFY_IS_APPROX(first.mean(), all.mean());
+  VERIFY_IS_APPROX(first.scatter(), all.scatter());
+
+  Hyperplane<Scalar,VectorType::SizeAtCompileTime> h1(size), h2(size);
+  RealScalar s1, s2;
+  first.fitHyperplane(&h1, &s1);
+  fitHyperplane(numPoints, points, &h2, &s2);
+  h1.coeffs() *= h2.coeffs().coeff(size)/h1.coeffs().coeff(size);
+  VERIFY_IS_APPROX(h1.coeffs(), h2.coeffs());
+  // the soundness is a ratio of eigenvalues in [0,1], the smallest one being at the noise level
+  VERIFY(ei_abs(s1 - s2) < test_precision<RealScalar>());
+
+  first.reset();
+  VERIFY(first.count() == 0);
+  first.merge(all);
+  VERIFY_IS_APPROX(first.scatter(), all.scatter());
+}
+
+template<typename VectorType>
+void check_linearRegression_scale(typename NumTraits<typename VectorType::Scalar>::Real scale)
+{
+  typedef typename VectorType::Scalar Scalar;
+  // an exact plane z = 2x - 3y + c, at the scale of the data
+  LeastSquaresAccumulator<VectorType> acc;
+  for(int i = 0; i < 20; ++i)
+  {
+    VectorType p = VectorType::Random();
+    p.coeffRef(2) = Scalar(2)*p.coeff(0) - Scalar(3)*p.coeff(1) + Scalar(1);
+    acc.add(p * scale);
+  }
+  VectorType result;
+  VERIFY(acc.linearRegression(&result, 2));
+  VERIFY_IS_APPROX(result, VectorType(Scalar(2), Scalar(-3), Scalar(scale)));
+
+  // a constant coordinate makes the system singular at any scale
+  LeastSquaresAccumulator<VectorType> degenerate;
+  for(int i = 0; i < 20; ++i)
+  {
+    VectorType p = VectorType::Random();
+    p.coeffRef(0) = Scalar(1);
+    degenerate.add(p * scale);
+  }
+  VERIFY(!degenerate.linearRegression(&result, 2));
+}
+
 void test_regression()
 {
   for(int i = 0; i < g_repeat; i++)
   {
+    CALL_SUBTEST(check_linearRegression_scale<Vector3d>(1e-4));
+    CALL_SUBTEST(check_linearRegression_scale<Vector3d>(1e4));
+    CALL_SUBTEST(check_linearRegression_scale<Vector3f>(1e-3f));
+
     {
       Vector2f points2f [1000];
       Vector2f *points2f_ptrs [1000];
@@ -90,6 +185,8 @@ void test_regression()
       CALL_SUBTEST(check_fitHyperplane(10, points2f_ptrs, coeffs3f, 0.05f));
       CALL_SUBTEST(check_fitHyperplane(100, points2f_ptrs, coeffs3f, 0.01f));
       CALL_SUBTEST(check_fitHyperplane(1000, points2f_ptrs, coeffs3f, 0.002f));
+      CALL_SUBTEST(check_linearRegression(1000, points2f_ptrs, coeffs3f, 0.002f));
+      CALL_SUBTEST(check_accumulator(1000, points2f_ptrs));
     }
 
     {
@@ -101,6 +198,8 @@ void test_regression()
       CALL_SUBTEST(check_fitHyperplane(10, points4d_ptrs, coeffs5d, 0.05));
       CALL_SUBTEST(check_fitHyperplane(100, points4d_ptrs, coeffs5d, 0.01));
       CALL_SUBTEST(check_fitHyperplane(1000, points4d_ptrs, coeffs5d, 0.002));
+      CALL_SUBTEST(check_linearRegression(1000, points4d_ptrs, coeffs5d, 0.002));
+      CALL_SUBTEST(check_accumulator(100, points4d_ptrs));
     }
 
     {
@@ -110,6 +209,8 @@ void test_regression()
       makeNoisyCohyperplanarPoints(1000, points11cd_ptrs, coeffs12cd, 0.01);
       CALL_SUBTEST(check_fitHyperplane(100, points11cd_ptrs, *coeffs12cd, 0.025));
       CALL_SUBTEST(check_fitHyperplane(1000, points11cd_ptrs, *coeffs12cd, 0.006));
+      CALL_SUBTEST(check_linearRegression(1000, points11cd_ptrs, *coeffs12cd, 0.006));
+      CALL_SUBTEST(check_accumulator(1000, points11cd_ptrs));
       delete coeffs12cd;
       for(int i = 0; i < 1000; i++) delete points11cd_ptrs[i];
     }
@@ -68,6 +68,43 @@ template<typename VectorType> void vectorSum(const VectorType& w)
   }
 }
 
+template<typename VectorType> void largeVectorRedux(const VectorType& w)
+{
+  typedef typename VectorType::Scalar Scalar;
+  int size = w.size();
+
+  // large enough to use several accumulators (and several threads if enabled)
+  VectorType v = VectorType::Random(size);
+  Scalar s = Scalar(0), m = v[0];
+  for(int i = 0; i < size; i++)
+  {
+    s += v[i];
+    m = std::max(m, v[i]);
+  }
+  VERIFY_IS_APPROX(s, v.sum());
+  VERIFY_IS_APPROX(s, v.redux(ei_scalar_sum_op<Scalar>()));
+  VERIFY_IS_APPROX(m, v.maxCoeff());
+  VERIFY_IS_APPROX(v.dot(v), v.squaredNorm());
+  VERIFY_IS_APPROX(v.dot(v), v.cwise().abs2().sum());
+  VERIFY_IS_APPROX(s - v[0], v.end(size-1).sum());
+}
+
+void randomRedux()
+{
+  // Random() draws from std::rand(), so its large reductions are not split across threads
+  const int size = 8*EIGEN_PARALLEL_REDUX_THRESHOLD;
+  const unsigned int seed = ei_random<int>(0,1000);
+  std::srand(seed);
+  const double s1 = VectorXd::Random(size).sum(), d1 = VectorXd::Random(size).dot(VectorXd::Random(size));
+  std::srand(seed);
+  const double s2 = VectorXd::Random(size).sum(), d2 = VectorXd::Random(size).dot(VectorXd::Random(size));
+  VERIFY(s1 == s2);
+  VERIFY(d1 == d2);
+  std::srand(seed);
+  VectorXd v = VectorXd::Random(size);
+  VERIFY_IS_APPROX(s1, v.sum());
+}
+
 void test_sum()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -83,4 +120,7 @@ void test_sum()
     CALL_SUBTEST( vectorSum(VectorXd(10)) );
     CALL_SUBTEST( vectorSum(VectorXf(33)) );
   }
+  CALL_SUBTEST( largeVectorRedux(VectorXd(300000)) );
+  CALL_SUBTEST( largeVectorRedux(VectorXf(ei_random<int>(1000,2000))) );
+  CALL_SUBTEST( randomRedux() );
 }
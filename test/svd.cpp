@@ -51,6 +51,13 @@ template<typename MatrixType> void svd(const MatrixType& m)
     sigma.block(0,0,cols,cols) = svd.singularValues().asDiagonal();
     matU.block(0,0,rows,cols) = svd.matrixU();
     VERIFY_IS_APPROX(a, matU * sigma * svd.matrixV().transpose());
+
+    // each matrix of singular vectors is computed independently of the other one
+    SVD<MatrixType> svdU(a, ComputeU), svdV(a, ComputeV);
+    VERIFY_IS_APPROX(svdU.matrixU(), svd.matrixU());
+    VERIFY_IS_APPROX(svdV.matrixV(), svd.matrixV());
+    VERIFY_IS_APPROX(svdU.sort().singularValues(), svdV.sort().singularValues());
+    VERIFY_RAISES_ASSERT(svdU.matrixV());
   }
 
 
@@ -62,8 +69,21 @@ template<typename MatrixType> void svd(const MatrixType& m)
       a += a * a.adjoint() + a1 * a1.adjoint();
     }
     SVD<MatrixType> svd(a);
-    svd.solve(b, &x);
+    VERIFY(svd.solve(b, &x));
     VERIFY_IS_APPROX(a * x,b);
+
+    // a rank deficient system is reported, and only the least squares solution is computed
+    MatrixType a2 = a;
+    a2.col(0).setZero();
+    VERIFY(!SVD<MatrixType>(a2).solve(b, &x));
+    VERIFY_IS_APPROX(a2.transpose() * (a2 * x), a2.transpose() * b);
+
+    // the methods which need the singular vectors cannot be used in values only mode
+    SVD<MatrixType> svdValues(a, 0);
+    MatrixType unitary, positive;
+    VERIFY_RAISES_ASSERT(svdValues.solve(b, &x));
+    VERIFY_RAISES_ASSERT(svdValues.computeUnitaryPositive(&unitary, &positive));
+    VERIFY_RAISES_ASSERT(svdValues.computePositiveUnitary(&positive, &unitary));
   }
 
 
@@ -85,6 +105,73 @@ template<typename MatrixType> void svd(const MatrixType& m)
   }
 }
 
+template<typename MatrixType> void jacobisvd(const MatrixType& m)
+{
+  /* this test covers the following files:
+     JacobiSVD.h
+  */
+  int rows = m.rows();
+  int cols = m.cols();
+  int diagSize = std::min(rows, cols);
+
+  typedef typename MatrixType::Scalar Scalar;
+  typedef typename NumTraits<Scalar>::Real RealScalar;
+  typedef Matrix<Scalar, Dynamic, Dynamic> DenseMatrixType;
+  MatrixType a = MatrixType::Random(rows,cols);
+
+  JacobiSVD<MatrixType> svd(a);
+  DenseMatrixType identity = DenseMatrixType::Identity(diagSize, diagSize);
+  VERIFY_IS_APPROX(svd.matrixU().adjoint() * svd.matrixU(), identity);
+  VERIFY_IS_APPROX(svd.matrixV().adjoint() * svd.matrixV(), identity);
+  DenseMatrixType sigma = svd.singularValues().template cast<Scalar>().asDiagonal();
+  VERIFY_IS_APPROX(DenseMatrixType(a), svd.matrixU() * sigma * svd.matrixV().adjoint());
+  for (int i = 1; i < diagSize; ++i)
+    VERIFY(svd.singularValues().coeff(i-1) >= svd.singularValues().coeff(i));
+
+  // the singular values only
+  JacobiSVD<MatrixType> svdValues(a, 0);
+  VERIFY_IS_APPROX(svdValues.singularValues(), svd.singularValues());
+  JacobiSVD<MatrixType> svdU(a, ComputeU);
+  VERIFY_IS_APPROX(svdU.matrixU() * sigma * svd.matrixV().adjoint(), DenseMatrixType(a));
+
+  // least squares
+  DenseMatrixType b = DenseMatrixType::Random(rows, 2), x;
+  if (rows >= cols)
+  {
+    VERIFY(svd.solve(b, &x));
+    VERIFY_IS_APPROX(a.adjoint() * (a * x), a.adjoint() * b);
+  }
+
+  // with zero singular values, the singular vectors are completed to orthonormal bases
+  if (diagSize > 1)
+  {
+    MatrixType a2 = a;
+    a2.row(0).setZero();
+    a2.col(0).setZero();
+    JacobiSVD<MatrixType> svd2(a2);
+    VERIFY(svd2.singularValues().coeff(diagSize-1) == RealScalar(0));
+    VERIFY_IS_APPROX(svd2.matrixU().adjoint() * svd2.matrixU(), identity);
+    VERIFY_IS_APPROX(svd2.matrixV().adjoint() * svd2.matrixV(), identity);
+    DenseMatrixType sigma2 = svd2.singularValues().template cast<Scalar>().asDiagonal();
+    VERIFY_IS_APPROX(DenseMatrixType(a2), svd2.matrixU() * sigma2 * svd2.matrixV().adjoint());
+    VERIFY(!svd2.solve(b, &x));
+    VERIFY_IS_APPROX(a2.adjoint() * (a2 * x), a2.adjoint() * b);
+  }
+  JacobiSVD<MatrixType> svd0(MatrixType::Zero(rows, cols));
+  VERIFY_IS_APPROX(svd0.matrixU().adjoint() * svd0.matrixU(), identity);
+  VERIFY_IS_APPROX(svd0.matrixV().adjoint() * svd0.matrixV(), identity);
+  VERIFY(!svd0.solve(b, &x));
+  VERIFY(x.isZero());
+}
+
+template<typename MatrixType> void jacobisvd_vs_svd(const MatrixType& m)
+{
+  int rows = m.rows();
+  int cols = m.cols();
+  MatrixType a = MatrixType::Random(rows,cols);
+  VERIFY_IS_APPROX(JacobiSVD<MatrixType>(a, 0).singularValues(), SVD<MatrixType>(a, 0).singularValues());
+}
+
 void test_svd()
 {
   for(int i = 0; i < g_repeat; i++) {
@@ -92,6 +179,14 @@ void test_svd()
     CALL_SUBTEST( svd(Matrix4d()) );
     CALL_SUBTEST( svd(MatrixXf(7,7)) );
     CALL_SUBTEST( svd(MatrixXd(14,7)) );
+
+    CALL_SUBTEST( jacobisvd(Matrix3f()) );
+    CALL_SUBTEST( jacobisvd(Matrix<double,3,5>()) );
+    CALL_SUBTEST( jacobisvd(MatrixXf(ei_random<int>(1,40), ei_random<int>(1,40))) );
+    CALL_SUBTEST( jacobisvd(MatrixXd(ei_random<int>(50,150), ei_random<int>(1,50))) );
+    CALL_SUBTEST( jacobisvd(MatrixXcf(ei_random<int>(1,20), ei_random<int>(1,20))) );
+    CALL_SUBTEST( jacobisvd(MatrixXcd(ei_random<int>(1,40), ei_random<int>(1,40))) );
+    CALL_SUBTEST( jacobisvd_vs_svd(MatrixXd(33,21)) );
     // complex are not implemented yet
 //     CALL_SUBTEST( svd(MatrixXcd(6,6)) );
 //     CALL_SUBTEST( svd(MatrixXcf(3,3)) );
@@ -116,6 +116,88 @@ template<typename MatrixType> void triangular(const MatrixType& m)
 
 }
 
+template<typename MatrixType> void triangular_product(const MatrixType& m)
+{
+  /* this test covers the triangular * dense products, which do not read the opposite half
+     of the triangular matrix
+  */
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar, Dynamic, Dynamic> DenseMatrixType;
+
+  int rows = m.rows();
+  int cols = ei_random<int>(1,rows);
+
+  MatrixType m1 = MatrixType::Random(rows, rows),
+             m3(rows, rows);
+  DenseMatrixType m2 = DenseMatrixType::Random(rows, cols),
+                  res(rows, cols);
+  Scalar s1 = ei_random<Scalar>();
+
+  m3 = m1.template part<Eigen::UpperTriangular>();
+  VERIFY_IS_APPROX(m1.template part<Eigen::UpperTriangular>() * m2, m3 * m2);
+  VERIFY_IS_APPROX(m3.template marked<Eigen::UpperTriangular>() * m2, m3 * m2);
+  m3 = m1.template part<Eigen::StrictlyLowerTriangular>();
+  VERIFY_IS_APPROX(m2.adjoint() * m1.template part<Eigen::StrictlyLowerTriangular>(), m2.adjoint() * m3);
+  m3 = m1.template part<Eigen::UnitLowerTriangular>();
+  VERIFY_IS_APPROX(m3.adjoint().template marked<Eigen::UnitUpperTriangular>() * m2, m3.adjoint() * m2);
+
+  // the scalar factor of the triangular operand does not apply to its unit diagonal
+  m3 = (s1*m1).adjoint().template part<Eigen::UnitUpperTriangular>();
+  res = m2;
+  res.noalias() -= (s1*m1).adjoint().template part<Eigen::UnitUpperTriangular>() * m2;
+  VERIFY_IS_APPROX(res, m2 - m3 * m2);
+  m3 = (-m1).template part<Eigen::LowerTriangular>();
+  VERIFY_IS_APPROX(m2.transpose() * (-m1).template part<Eigen::LowerTriangular>(), m2.transpose() * m3);
+}
+
+template<typename MatrixType> void triangular_solve(const MatrixType& m)
+{
+  /* this test covers the blocked solve of triangular systems with several right hand sides
+  */
+  typedef typename MatrixType::Scalar Scalar;
+  typedef Matrix<Scalar, Dynamic, Dynamic> DenseMatrixType;
+
+  int size = m.rows();
+  int cols = ei_random<int>(2,size);
+
+  // a dominant diagonal keeps the triangular systems well conditioned
+  MatrixType m1 = MatrixType::Random(size, size), m3(size, size);
+  m1.diagonal().cwise() += Scalar(size);
+  DenseMatrixType m2 = DenseMatrixType::Random(size, cols), x(size, cols);
+
+  m3 = m1.template part<Eigen::LowerTriangular>();
+  x = m2;
+  m1.template part<Eigen::LowerTriangular>().solveTriangularInPlace(x);
+  VERIFY_IS_APPROX(m3 * x, m2);
+  VERIFY_IS_APPROX(m3 * m3.template marked<Eigen::LowerTriangular>().solveTriangular(m2), m2);
+
+  m3 = m1.template part<Eigen::UpperTriangular>();
+  VERIFY_IS_APPROX(m3 * m1.template part<Eigen::UpperTriangular>().solveTriangular(m2), m2);
+  VERIFY_IS_APPROX(m3.adjoint() * m3.adjoint().template marked<Eigen::LowerTriangular>().solveTriangular(m2), m2);
+
+  // triangular expressions without direct access, as used by LLT::solveInPlace() and the generalized eigenproblem
+  x = m2;
+  m3.adjoint().template part<Eigen::LowerTriangular>().solveTriangularInPlace(x);
+  VERIFY_IS_APPROX(m3.adjoint() * x, m2);
+  x = m2;
+  m1.template part<Eigen::UpperTriangular>().template marked<Eigen::UpperTriangular>().solveTriangularInPlace(x);
+  VERIFY_IS_APPROX(m3 * x, m2);
+
+  // so does a small strictly triangular part for the unit triangular systems
+  m1 /= Scalar(size);
+  m3 = m1.template part<Eigen::UnitLowerTriangular>();
+  VERIFY_IS_APPROX(m3 * m1.template part<Eigen::UnitLowerTriangular>().solveTriangular(m2), m2);
+  m3 = m1.template part<Eigen::UnitUpperTriangular>();
+  x = m2;
+  m1.template marked<Eigen::UnitUpperTriangular>().solveTriangularInPlace(x);
+  VERIFY_IS_APPROX(m3 * x, m2);
+
+  // row major right hand side
+  Matrix<Scalar, Dynamic, Dynamic, RowMajor> xr = m2;
+  m1.template part<Eigen::UnitUpperTriangular>().solveTriangularInPlace(xr);
+  VERIFY_IS_APPROX(m3 * xr, m2);
+}
+
 void test_triangular()
 {
   for(int i = 0; i < g_repeat ; i++) {
@@ -126,5 +208,13 @@ void test_triangular()
     CALL_SUBTEST( triangular(Matrix<std::complex<float>,8, 8>()) );
     CALL_SUBTEST( triangular(MatrixXd(17,17)) );
     CALL_SUBTEST( triangular(Matrix<float,Dynamic,Dynamic,RowMajor>(5, 5)) );
+
+    CALL_SUBTEST( triangular_product(MatrixXf(ei_random<int>(1,320), 1)) );
+    CALL_SUBTEST( triangular_product(MatrixXcd(ei_random<int>(1,100), 1)) );
+    CALL_SUBTEST( triangular_product(Matrix<double,Dynamic,Dynamic,RowMajor>(ei_random<int>(1,200), 1)) );
+
+    CALL_SUBTEST( triangular_solve(MatrixXd(ei_random<int>(2,4*EIGEN_DECOMPOSITION_BLOCK_SIZE), 1)) );
+    CALL_SUBTEST( triangular_solve(MatrixXcf(ei_random<int>(2*EIGEN_DECOMPOSITION_BLOCK_SIZE,3*EIGEN_DECOMPOSITION_BLOCK_SIZE), 1)) );
+    CALL_SUBTEST( triangular_solve(Matrix<float,Dynamic,Dynamic,RowMajor>(2*EIGEN_DECOMPOSITION_BLOCK_SIZE+3, 1)) );
   }
 }